@@ -0,0 +1,118 @@
+/**
+ * @file BatchRunner.h
+ *
+ * @author Dan Keenan
+ * @date 10/17/2026
+ * @copyright GNU GPLv3
+ */
+
+#ifndef BATCHRUNNER_H
+#define BATCHRUNNER_H
+
+#include <QString>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <span>
+#include <vector>
+#include "Config.h"
+
+namespace echoconfig
+{
+    /**
+     * Runs many sheet exports and imports at once, such as re-exporting every rack in a building.
+     *
+     * Jobs are shared out between worker threads up front.  A worker that runs out of jobs takes the last waiting job
+     * from another worker, so a few large configs don't leave the other workers idle.
+     *
+     * Each job has its own config; a job that fails is reported and doesn't affect the others.
+     */
+    class BatchRunner
+    {
+    public:
+        enum class Operation
+        {
+            /** Parse the config and save its values to the sheet. */
+            ExportSheet,
+            /** Parse the config and the sheet, and save the config with the sheet's values to the output path. */
+            ImportSheet,
+        };
+
+        struct Job
+        {
+            Operation operation = Operation::ExportSheet;
+            QString cfgPath;
+            QString sheetPath;
+            /** Only used by Operation::ImportSheet. */
+            QString outPath;
+        };
+
+        /**
+         * Time spent in each step of a job.  Steps a job doesn't have are zero.
+         */
+        struct JobTimings
+        {
+            std::chrono::nanoseconds parseCfg{0};
+            std::chrono::nanoseconds parseSheet{0};
+            std::chrono::nanoseconds saveSheet{0};
+            std::chrono::nanoseconds saveCfg{0};
+            std::chrono::nanoseconds total{0};
+        };
+
+        struct JobResult
+        {
+            bool ok = false;
+            /** Why the job failed. */
+            QString error;
+            JobTimings timings;
+            /** Index of the worker that ran the job. */
+            unsigned int worker = 0;
+        };
+
+        struct Options
+        {
+            /** Number of worker threads.  0 uses one per core. */
+            unsigned int threadCount = 0;
+            ParseOptions parseOptions;
+            SheetOptions sheetOptions;
+            /**
+             * Called from the worker thread as each job finishes, with the job's index.  Must be thread-safe.
+             */
+            std::function<void(std::size_t, const JobResult&)> onJobFinished;
+        };
+
+        struct Report
+        {
+            /** In the same order as the jobs. */
+            std::vector<JobResult> results;
+            unsigned int threadCount = 0;
+            /** Number of jobs a worker took from another worker. */
+            std::size_t steals = 0;
+            std::chrono::nanoseconds wallTime{0};
+
+            [[nodiscard]] std::size_t failedCount() const;
+        };
+
+        BatchRunner();
+        explicit BatchRunner(Options options);
+
+        [[nodiscard]] const Options& options() const { return options_; }
+
+        /**
+         * Run @p jobs and wait for them to finish.
+         *
+         * Never throws because of a job; failures are in the report.
+         */
+        [[nodiscard]] Report run(std::span<const Job> jobs) const;
+
+        /**
+         * Run a single job on this thread.
+         */
+        [[nodiscard]] JobResult runJob(const Job& job) const;
+
+    private:
+        Options options_;
+    };
+} // namespace echoconfig
+
+#endif // BATCHRUNNER_H
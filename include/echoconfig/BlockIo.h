@@ -0,0 +1,179 @@
+/**
+ * @file BlockIo.h
+ *
+ * @author Dan Keenan
+ * @date 10/17/2026
+ * @copyright GNU GPLv3
+ */
+
+#ifndef BLOCKIO_H
+#define BLOCKIO_H
+
+#include <QByteArray>
+#include <QIODevice>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace echoconfig
+{
+    /**
+     * How much of the time spent reading or writing a file was spent waiting for it.
+     */
+    struct IoStats
+    {
+        qint64 bytes = 0;
+        /** Time spent waiting for the device. */
+        std::chrono::nanoseconds waited{0};
+        /** Time from starting to finishing. */
+        std::chrono::nanoseconds elapsed{0};
+
+        /** Fraction of elapsed time spent waiting, from 0 to 1. */
+        [[nodiscard]] double waitFraction() const
+        {
+            return elapsed.count() > 0 ? static_cast<double>(waited.count()) / static_cast<double>(elapsed.count())
+                                       : 0.0;
+        }
+    };
+
+    /**
+     * Reads a device in large blocks on another thread, ahead of when they are needed.
+     *
+     * Whatever is done with one block overlaps with reading the next ones, which helps most on slow or distant
+     * storage.  The device must not be used by anything else until the reader is destroyed.
+     */
+    class ReadAhead
+    {
+    public:
+        struct Options
+        {
+            /** Bytes read at a time. */
+            qint64 blockSize = 1024 * 1024;
+            /** Blocks read before they are needed.  Reading pauses once this many are waiting. */
+            std::size_t maxBlocks = 4;
+        };
+
+        /**
+         * Start reading @p in from its current position.
+         * @param in Must be open for reading and outlive the reader.
+         */
+        explicit ReadAhead(QIODevice& in);
+        ReadAhead(QIODevice& in, const Options& options);
+        ~ReadAhead();
+        ReadAhead(const ReadAhead&) = delete;
+        ReadAhead& operator=(const ReadAhead&) = delete;
+
+        /**
+         * Get the next block, waiting for it if it hasn't been read yet.
+         * @return An empty block once the end of the device is reached.
+         * @throws std::runtime_error if the device can't be read.
+         */
+        [[nodiscard]] QByteArray next();
+
+        /**
+         * Time spent waiting in next().  Elapsed time runs until next() reaches the end.
+         */
+        [[nodiscard]] IoStats stats() const;
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        QIODevice& in_;
+        Options options_;
+        Clock::time_point start_;
+        mutable std::mutex mutex_;
+        std::condition_variable changed_;
+        std::deque<QByteArray> blocks_;
+        /** Set by the reading thread once it has reached the end or failed. */
+        bool done_ = false;
+        bool failed_ = false;
+        bool stopping_ = false;
+        bool finished_ = false;
+        IoStats stats_;
+        std::thread thread_;
+
+        void readBlocks();
+    };
+
+    /**
+     * Writes to a device on another thread through a pair of buffers.
+     *
+     * One buffer is filled while the other is written.  Only a full buffer is handed off, so writing waits only when
+     * the device is slower than filling the buffer.  The device must not be used by anything else until finish() is
+     * called or the writer is destroyed.
+     */
+    class WriteBehind
+    {
+    public:
+        struct Options
+        {
+            /** Bytes gathered before they are handed off to be written. */
+            qint64 blockSize = 1024 * 1024;
+        };
+
+        /**
+         * @param out Must be open for writing and outlive the writer.
+         */
+        explicit WriteBehind(QIODevice& out);
+        WriteBehind(QIODevice& out, const Options& options);
+        /**
+         * Output that wasn't finished is discarded: a block already handed off may still be written, with errors
+         * ignored, but anything not yet handed off is dropped.  Use finish() to write everything.
+         */
+        ~WriteBehind();
+        WriteBehind(const WriteBehind&) = delete;
+        WriteBehind& operator=(const WriteBehind&) = delete;
+
+        /**
+         * Queue @p size bytes at @p data to be written.
+         * @throws std::runtime_error if something written before couldn't be.
+         */
+        void write(const char* data, qsizetype size);
+
+        /**
+         * Queue @p block to be written.  Large blocks are handed off without copying.
+         * @throws std::runtime_error if something written before couldn't be.
+         */
+        void write(const QByteArray& block);
+
+        /**
+         * Write everything queued and wait for it to be written.
+         * @throws std::runtime_error if anything couldn't be written.
+         */
+        void finish();
+
+        /**
+         * Time spent waiting for the device.  Elapsed time runs until finish() returns.
+         */
+        [[nodiscard]] IoStats stats() const;
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        QIODevice& out_;
+        Options options_;
+        Clock::time_point start_;
+        /** Filled by write(); only used on the calling thread. */
+        QByteArray filling_;
+        mutable std::mutex mutex_;
+        std::condition_variable changed_;
+        /** Written by the writing thread while flushPending_ is set. */
+        QByteArray flushing_;
+        bool flushPending_ = false;
+        bool failed_ = false;
+        bool stopping_ = false;
+        bool finished_ = false;
+        IoStats stats_;
+        std::thread thread_;
+
+        /** Hand filling_ off to be written, once the block before it has been. */
+        void handOff();
+        void writeBlocks();
+        void stop();
+    };
+} // namespace echoconfig
+
+#endif // BLOCKIO_H
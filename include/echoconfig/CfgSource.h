@@ -0,0 +1,83 @@
+/**
+ * @file CfgSource.h
+ *
+ * @author Dan Keenan
+ * @date 10/17/2026
+ * @copyright GNU GPLv3
+ */
+
+#ifndef CFGSOURCE_H
+#define CFGSOURCE_H
+
+#include <QByteArrayView>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QHash>
+#include <QString>
+#include <cstddef>
+#include <optional>
+
+namespace echoconfig
+{
+    /**
+     * Identifies the file a config was parsed from, so saving can tell if it is given the same file again.
+     */
+    struct CfgSource
+    {
+        /** Absolute path. */
+        QString path;
+        qint64 size = 0;
+        QDateTime lastModified;
+        /** Hash of the contents, if they were kept. */
+        std::optional<std::size_t> hash;
+
+        /**
+         * @param sourcePath Path the file was read from.
+         * @param data Contents of the file, if they should be hashed.
+         */
+        [[nodiscard]] static CfgSource of(const QString& sourcePath, std::optional<QByteArrayView> data = std::nullopt)
+        {
+            const QFileInfo info(sourcePath);
+            CfgSource source{
+                .path = info.absoluteFilePath(),
+                .size = info.size(),
+                .lastModified = info.lastModified(),
+            };
+            if (data.has_value())
+            {
+                source.hash = hashOf(data.value());
+            }
+            return source;
+        }
+
+        /**
+         * Hash file contents.  Only comparable within a single run of the program.
+         */
+        [[nodiscard]] static std::size_t hashOf(QByteArrayView data) { return qHash(data, 0); }
+
+        /**
+         * Check that the file at @p sourcePath is this file and has not been modified, without reading it.
+         */
+        [[nodiscard]] bool isUnchanged(const QString& sourcePath) const { return isUnchanged(of(sourcePath)); }
+
+        /**
+         * Check that @p current, taken later, shows the file is this file and has not been modified.
+         */
+        [[nodiscard]] bool isUnchanged(const CfgSource& current) const
+        {
+            return current.path == path && current.size == size && current.lastModified == lastModified;
+        }
+
+        /**
+         * Check that @p data is the same as the contents of this file.
+         *
+         * Always false if the contents were not hashed.
+         */
+        [[nodiscard]] bool hasContents(QByteArrayView data) const
+        {
+            return hash.has_value() && data.size() == size && hashOf(data) == hash.value();
+        }
+    };
+} // namespace echoconfig
+
+#endif // CFGSOURCE_H
@@ -9,20 +9,133 @@
 #ifndef CONFIG_H
 #define CONFIG_H
 
+#include <QByteArray>
+#include <QByteArrayView>
 #include <QObject>
 #include <QString>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <utility>
+#include <vector>
 #include "Circuit.h"
 #include "Preset.h"
 #include "Space.h"
-
-// Forward-declare Xlsx document so we don't force a downstream dependency.
-namespace QXlsx
-{
-    class Document;
-}
+#include "ZipWriter.h"
 
 namespace echoconfig
 {
+    class ConfigCache;
+    class ConfigSnapshot;
+    struct IoStats;
+    class XlsxReader;
+    class XlsxWriter;
+
+    /**
+     * Identifying information read from the start of a config file.
+     */
+    struct CfgHeader
+    {
+        /** Name of the document (root) element. */
+        QString rootTag;
+        /** Name of the first element inside the root element. */
+        QString rackTag;
+        /** VERSION attribute of the first element inside the root element. */
+        QString version;
+    };
+
+    /**
+     * How Config::parseCfg() reads config files.
+     */
+    enum class ParseEngine
+    {
+        /** Read the file into QXmlStreamReader. */
+        Stream,
+        /** Memory-map the file and scan the UTF-8 bytes directly (see XmlScanner).  Much faster on large files. */
+        Mapped,
+    };
+
+    /**
+     * Options for Config::parseCfg().
+     */
+    struct ParseOptions
+    {
+        ParseEngine engine = ParseEngine::Stream;
+        /**
+         * Keep the contents of the parsed file in memory, so Config::saveCfg() doesn't need to read it again when
+         * given the same, unmodified file.
+         */
+        bool retainBase = false;
+        /**
+         * Check this cache before parsing, and add parsed configs to it.  Configs from the cache have no splice index,
+         * so saving them indexes the base again, but they do retain it if retainBase is set.
+         */
+        ConfigCache* cache = nullptr;
+        /**
+         * Number of threads to parse presets on.  0 uses one per core.  Only ParseEngine::Mapped parses in parallel,
+         * and only for configs large enough to be worth it.
+         */
+        unsigned int threadCount = 1;
+        /**
+         * Set to how long parsing waited for the file, if not null.  Only ParseEngine::Stream reads on another thread
+         * while parsing, so only it reports this.
+         */
+        IoStats* ioStats = nullptr;
+    };
+
+    /**
+     * Options for Config::saveCfg().
+     */
+    struct SaveOptions
+    {
+        /** Number of threads to write presets on.  0 uses one per core.  Only large configs are split up. */
+        unsigned int threadCount = 1;
+        /**
+         * Set to how long saving waited for the output file, if not null.  Configs saved from several threads at once
+         * need their own.
+         */
+        IoStats* ioStats = nullptr;
+    };
+
+    /**
+     * How Config::saveSheet() arranges preset columns.
+     */
+    enum class PresetLayout
+    {
+        /** Preset n is always in the nth preset column, leaving empty columns for unused numbers. */
+        ByNumber,
+        /** Presets are in consecutive columns, in number order. */
+        Compact,
+    };
+
+    /**
+     * File formats for Config::saveSheet() and Config::parseSheet().
+     */
+    enum class SheetFormat
+    {
+        /** An xlsx workbook with a Levels and a Times sheet. */
+        Xlsx,
+        /** A comma-separated file for each table (see Config::tablePaths()). */
+        Csv,
+        /** A tab-separated file for each table (see Config::tablePaths()). */
+        Tsv,
+    };
+
+    /**
+     * Options for Config::saveSheet().
+     */
+    struct SheetOptions
+    {
+        /** Picked from the extension of the path if not set (see Config::sheetFormatOf()). */
+        std::optional<SheetFormat> format;
+        PresetLayout layout = PresetLayout::ByNumber;
+        /**
+         * CompressionLevel::Store is much faster for sheets that are edited once and thrown away.  Only applies to
+         * SheetFormat::Xlsx.
+         */
+        CompressionLevel compression = CompressionLevel::Default;
+    };
 
     /**
      * Base class for panel configurations.
@@ -36,16 +149,62 @@ namespace echoconfig
         /**
          * Load a config file of unknown type.
          *
+         * The dialect is picked by sniffing the file header (see sniffCfg()), so the file is only parsed once.
          * If the file could not be loaded, returns nullptr.
          *
+         * @param path Path to config file.
+         * @param options How to read the file.
          * @return
          */
-        [[nodiscard]] static std::unique_ptr<Config> loadCfg(const QString& path);
+        [[nodiscard]] static std::unique_ptr<Config> loadCfg(const QString& path, const ParseOptions& options = {});
+
+        /**
+         * Load a config file of unknown type, like loadCfg(), but say why it couldn't be loaded.
+         *
+         * @param path Path to config file.
+         * @param options How to read the file.
+         * @return
+         * @throws std::runtime_error if the file is not a known type of config or cannot be parsed.
+         */
+        [[nodiscard]] static std::unique_ptr<Config> loadCfgOrThrow(const QString& path,
+                                                                    const ParseOptions& options = {});
+
+        /**
+         * Make a config from a snapshot made by saveSnapshot().
+         *
+         * The config type is picked from the header of the file the snapshot was made from.  If no config type
+         * accepts it, returns nullptr.
+         *
+         * @param snapshot
+         * @return
+         */
+        [[nodiscard]] static std::unique_ptr<Config> fromSnapshot(const ConfigSnapshot& snapshot);
+
+        /**
+         * Read the prolog and the first two start elements of a config file without parsing the rest.
+         * @param path Path to config file.
+         * @return The header, or std::nullopt if the file could not be opened or is not XML.
+         */
+        [[nodiscard]] static std::optional<CfgHeader> sniffCfg(const QString& path);
+
+        /**
+         * Check if a config file starting with @p header can be parsed by this config type.
+         * @param header
+         * @return
+         */
+        [[nodiscard]] virtual bool acceptsHeader(const CfgHeader& header) const = 0;
 
         [[nodiscard]] virtual QString panelType() const = 0;
 
         [[nodiscard]] virtual QString panelName() const = 0;
 
+        [[nodiscard]] const ParseOptions& parseOptions() const { return parseOptions_; }
+        void setParseOptions(const ParseOptions& options) { parseOptions_ = options; }
+        [[nodiscard]] ParseEngine parseEngine() const { return parseOptions_.engine; }
+        void setParseEngine(ParseEngine engine) { parseOptions_.engine = engine; }
+        [[nodiscard]] const SaveOptions& saveOptions() const { return saveOptions_; }
+        void setSaveOptions(const SaveOptions& options) { saveOptions_ = options; }
+
         /**
          * Parse a panel configuration file.
          * @param path Path to config file.
@@ -54,11 +213,62 @@ namespace echoconfig
         virtual void parseCfg(const QString& path);
 
         /**
-         * Parse a spreadsheet file.
-         * @param path Path to spreadsheet file.
+         * Parse a spreadsheet file, or a pair of delimited table files.
+         *
+         * The Levels and Times sheets are read at the same time on the global thread pool.  Both formats have the same
+         * columns, found by their headers.
+         *
+         * @param path Path to spreadsheet file, or to either table file.
+         * @param format Picked from the extension of @p path if not given (see sheetFormatOf()).
          * @throws std::runtime_error if the sheet cannot be parsed.
          */
-        virtual void parseSheet(const QString& path);
+        virtual void parseSheet(const QString& path, std::optional<SheetFormat> format = std::nullopt);
+
+        /**
+         * Update config from a pair of sheets in an open workbook, which may hold sheets for other racks too.
+         *
+         * @param workbook May be read from other threads at the same time.
+         * @param levelsName Name of the sheet laid out like the Levels sheet.
+         * @param timesName Name of the sheet laid out like the Times sheet.
+         * @throws std::runtime_error if the sheets cannot be parsed.
+         */
+        void parseWorkbookSheets(const XlsxReader& workbook, const QString& levelsName, const QString& timesName);
+
+        /**
+         * Save a snapshot of the parsed values, which can be reopened much faster than parsing the config file.
+         * @param sourcePath Path to the config file the values were parsed from.  It is hashed so the snapshot can be
+         * checked against it later (see ConfigSnapshot::isSnapshotOf()).
+         * @param path Path to snapshot file.
+         * @throws std::runtime_error if the snapshot cannot be saved.
+         */
+        virtual void saveSnapshot(const QString& sourcePath, const QString& path) const = 0;
+
+        /**
+         * Save a snapshot of the parsed values from a config file that has already been read.
+         * @param header Header of the config file.
+         * @param source Contents of the config file the values were parsed from.
+         * @param sourceHash ConfigSnapshot::hashOf() @p source if it is already known, or empty to hash it here.
+         * @param path Path to snapshot file.
+         * @throws std::runtime_error if the snapshot cannot be saved.
+         */
+        virtual void saveSnapshot(const CfgHeader& header, QByteArrayView source, const QByteArray& sourceHash,
+                                  const QString& path) const = 0;
+
+        /**
+         * Replace everything with the values in @p snapshot.
+         * @throws std::runtime_error if @p snapshot is from a different type of config.
+         */
+        virtual void loadSnapshot(const ConfigSnapshot& snapshot);
+
+        /**
+         * Keep @p data, the contents of the file at @p path, as if it had been parsed with ParseOptions::retainBase.
+         *
+         * For configs whose values came from somewhere else, like a snapshot of the same file.
+         *
+         * @param path
+         * @param data Must not be a mapping of a file that may be closed.
+         */
+        virtual void retainBase(const QString& path, const QByteArray& data) = 0;
 
         /**
          * Save to a new configuration file.
@@ -69,9 +279,73 @@ namespace echoconfig
 
         /**
          * Save to spreadsheet file.
+         *
+         * The Levels and Times sheets are written at the same time on the global thread pool, and large sheets are
+         * compressed in blocks across the pool.  The file is the same as if they had been written one after the other.
+         *
+         * Preset columns are found by their headers when the sheet is read back, so either layout can be parsed.
+         *
+         * Delimited formats write each table to its own file (see tablePaths()).  They are much faster to write and
+         * read than xlsx, and simpler for other programs to generate.
+         *
          * @param path Path to spreadsheet file.
+         * @param options
+         */
+        virtual void saveSheet(const QString& path, const SheetOptions& options = {}) const;
+
+        /**
+         * Add the Levels and Times sheets to a workbook under other names, so one workbook can hold many racks.
+         *
+         * @param writer
+         * @param levelsName
+         * @param timesName
+         * @param layout
+         */
+        void saveWorkbookSheets(XlsxWriter& writer, const QString& levelsName, const QString& timesName,
+                                PresetLayout layout = PresetLayout::ByNumber) const;
+
+        /**
+         * Guess the format of a sheet file from its extension.
+         *
+         * ".csv" is SheetFormat::Csv, ".tsv" and ".tab" are SheetFormat::Tsv, and anything else is SheetFormat::Xlsx.
+         */
+        [[nodiscard]] static SheetFormat sheetFormatOf(const QString& path);
+
+        /**
+         * Get the paths of the Levels and Times table files for delimited sheet files named by @p path.
+         *
+         * "dir/rack.csv", "dir/rack.levels.csv", and "dir/rack.times.csv" all give "dir/rack.levels.csv" and
+         * "dir/rack.times.csv".
+         *
+         * @return The Levels path and the Times path.
+         */
+        [[nodiscard]] static std::pair<QString, QString> tablePaths(const QString& path);
+
+        /**
+         * All circuits, sorted by number.
          */
-        virtual void saveSheet(const QString& path) const;
+        [[nodiscard]] virtual std::span<const Circuit> circuits() const = 0;
+
+        /**
+         * All spaces, sorted by number.
+         */
+        [[nodiscard]] virtual std::span<const Space> spaces() const = 0;
+
+        /**
+         * All presets, sorted by number.
+         */
+        [[nodiscard]] virtual std::span<const Preset> presets() const = 0;
+
+        /**
+         * The level of each circuit in @p preset, in the same order as circuits().
+         *
+         * Dereferencing throws std::out_of_range if @p preset has no level for that circuit.
+         */
+        [[nodiscard]] auto levelsOf(const Preset& preset) const
+        {
+            return circuits() | std::views::transform([&preset](const Circuit& circuit) -> unsigned int
+                                                      { return preset.levels.at(circuit.num); });
+        }
 
         [[nodiscard]] virtual unsigned int circuitCount() const = 0;
         [[nodiscard]] virtual const Circuit& getCircuitAt(unsigned int ix) const = 0;
@@ -93,16 +367,74 @@ namespace echoconfig
 
         [[nodiscard]] bool isSheetParsed() const { return sheetParsed_; }
 
-    private:
-        static constexpr auto kSheetIxLevels = 0;
-        static constexpr auto kSheetIxTimes = 1;
+        /**
+         * Copy this config, including anything kept from the file it was parsed from.
+         *
+         * The parsed file is shared with the copy rather than copied, so many configs made from one base can be saved
+         * without each reading it again.
+         */
+        [[nodiscard]] virtual std::unique_ptr<Config> clone() const = 0;
+
+    protected:
+        /**
+         * Called after values from a sheet have been added, before the sheet counts as parsed.
+         */
+        virtual void sheetApplied() {}
 
+        /**
+         * Copy the state kept by this class to @p other, for clone().
+         */
+        void copyStateTo(Config& other) const
+        {
+            other.sheetParsed_ = sheetParsed_;
+            other.parseOptions_ = parseOptions_;
+            other.saveOptions_ = saveOptions_;
+        }
+
+    private:
         bool sheetParsed_ = false;
+        ParseOptions parseOptions_;
+        SaveOptions saveOptions_;
+
+        /** Values read from the Levels sheet, before they are added to the config. */
+        struct LevelsSheet;
+        /** Values read from the Times sheet, before they are added to the config. */
+        struct TimesSheet;
+
+        static void readWorkbook(const XlsxReader& workbook, const QString& levelsName, const QString& timesName,
+                                 LevelsSheet& levels, TimesSheet& times);
+        static void readTables(const QString& path, char delimiter, LevelsSheet& levels, TimesSheet& times);
+        void saveWorkbook(const QString& path, const SheetOptions& options) const;
+        void saveTables(const QString& path, char delimiter, PresetLayout layout) const;
+        void applySheets(const LevelsSheet& levels, const TimesSheet& times);
+
+        // Readers and writers are XlsxSheetReader/CsvReader and XlsxSheetWriter/CsvWriter.
+        template <typename SheetReader>
+        [[nodiscard]] static LevelsSheet readSheetLevels(SheetReader& sheet);
+        void applySheetLevels(const LevelsSheet& sheet);
+        template <typename SheetWriter>
+        void saveSheetLevelsHeader(SheetWriter& sheet, std::span<const int> presetCols) const;
+        template <typename SheetWriter>
+        void saveSheetLevels(SheetWriter& sheet, std::span<const int> presetCols) const;
+        template <typename SheetReader>
+        [[nodiscard]] static TimesSheet readSheetTimes(SheetReader& sheet);
+        void applySheetTimes(const TimesSheet& sheet);
+        template <typename SheetWriter>
+        void saveSheetTimesHeader(SheetWriter& sheet, std::span<const int> presetCols) const;
+        template <typename SheetWriter>
+        void saveSheetTimes(SheetWriter& sheet, std::span<const int> presetCols) const;
 
-        void openSheetLevels(const QXlsx::Document* doc);
-        void saveSheetLevels(QXlsx::Document* doc) const;
-        void openSheetTimes(const QXlsx::Document* doc);
-        void saveSheetTimes(QXlsx::Document* doc) const;
+        /**
+         * Get the column of each preset, in the same order as presets().
+         * @param firstCol Column of the first preset.
+         * @param layout
+         */
+        [[nodiscard]] std::vector<int> presetColumns(int firstCol, PresetLayout layout) const;
+
+        /**
+         * Get the preset for each of @p presetNums, adding presets as needed.
+         */
+        std::vector<Preset*> resolvePresets(std::span<const unsigned int> presetNums);
     };
 
     template <class C>
@@ -113,7 +445,9 @@ namespace echoconfig
         struct ConfigLoaderFactory
         {
             virtual ~ConfigLoaderFactory() = default;
-            virtual std::unique_ptr<Config> operator()(const QString& path) const = 0;
+            [[nodiscard]] virtual bool accepts(const CfgHeader& header) const = 0;
+            virtual std::unique_ptr<Config> operator()(const QString& path, const ParseOptions& options) const = 0;
+            [[nodiscard]] virtual std::unique_ptr<Config> create() const = 0;
         };
     } // namespace detail
 
@@ -124,12 +458,21 @@ namespace echoconfig
     template <ConfigClass C>
     struct ConfigLoader : detail::ConfigLoaderFactory
     {
-        std::unique_ptr<Config> operator()(const QString& path) const override
+        [[nodiscard]] bool accepts(const CfgHeader& header) const override { return prototype_.acceptsHeader(header); }
+
+        std::unique_ptr<Config> operator()(const QString& path, const ParseOptions& options) const override
         {
             auto cfg = std::make_unique<C>();
+            cfg->setParseOptions(options);
             cfg->parseCfg(path);
             return cfg;
         }
+
+        [[nodiscard]] std::unique_ptr<Config> create() const override { return std::make_unique<C>(); }
+
+    private:
+        /** Only asked about headers, so that checking one doesn't build a config each time. */
+        C prototype_;
     };
 } // namespace echoconfig
 
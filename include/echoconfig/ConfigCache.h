@@ -0,0 +1,109 @@
+/**
+ * @file ConfigCache.h
+ *
+ * @author Dan Keenan
+ * @date 10/17/2026
+ * @copyright GNU GPLv3
+ */
+
+#ifndef CONFIGCACHE_H
+#define CONFIGCACHE_H
+
+#include <QByteArray>
+#include <QString>
+#include <QtGlobal>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+namespace echoconfig
+{
+    class Config;
+    struct CfgHeader;
+
+    /**
+     * An on-disk cache of parsed configs, stored as ConfigSnapshot files.
+     *
+     * Entries are keyed by the SHA-256 hash of the config file's contents and its dialect, so a file is found again
+     * wherever it is copied to, and an edited file is never confused with the original.  Opening a cached file costs
+     * a hash of the file and copying the values out of its mapped snapshot, which takes time in proportion to the
+     * number of levels but skips parsing.
+     *
+     * The cache is bounded by the total size of its snapshots.  Each hit marks its entry as recently used, and the
+     * least recently used entries are removed when the cache grows past its size.
+     *
+     * The cache may be shared by several threads and several processes.  Problems with the cache directory are never
+     * errors; they only cause misses.
+     */
+    class ConfigCache
+    {
+    public:
+        static constexpr qint64 kDefaultMaxSize = 256 * 1024 * 1024;
+
+        struct Stats
+        {
+            quint64 hits = 0;
+            quint64 misses = 0;
+            /** Entries removed to keep the cache within its size. */
+            quint64 evictions = 0;
+        };
+
+        /**
+         * @param dir Directory to keep snapshots in.  Created when needed.
+         * @param maxSize Bytes.
+         */
+        explicit ConfigCache(const QString& dir = defaultDir(), qint64 maxSize = kDefaultMaxSize);
+
+        /**
+         * The "configs" directory of application @p appName of this organization, in
+         * QStandardPaths::GenericCacheLocation.  Programs that pass the same name share a cache.
+         * @param appName Defaults to QCoreApplication::applicationName().
+         */
+        [[nodiscard]] static QString defaultDir(const QString& appName = {});
+
+        [[nodiscard]] const QString& dir() const { return dir_; }
+        [[nodiscard]] qint64 maxSize() const { return maxSize_; }
+        void setMaxSize(qint64 maxSize) { maxSize_ = maxSize; }
+
+        /**
+         * Get the config in the file at @p path from the cache, or parse it and add it to the cache.
+         *
+         * @param path Path to config file.
+         * @param header Header of the file (see Config::sniffCfg()).
+         * @param retainBase Keep the file's contents in a config from the cache, as ParseOptions::retainBase does.
+         * @param parse Parses the file on a miss.
+         * @return The config, or whatever @p parse returns on a miss.
+         * @throws Whatever @p parse throws.
+         */
+        [[nodiscard]] std::unique_ptr<Config> load(const QString& path, const CfgHeader& header, bool retainBase,
+                                                   const std::function<std::unique_ptr<Config>()>& parse);
+
+        [[nodiscard]] Stats stats() const;
+
+        /**
+         * Total size of the snapshots in the cache, in bytes.
+         */
+        [[nodiscard]] qint64 size() const;
+
+        /**
+         * Remove every entry.
+         */
+        void clear();
+
+    private:
+        QString dir_;
+        std::atomic<qint64> maxSize_;
+        std::atomic<quint64> hits_ = 0;
+        std::atomic<quint64> misses_ = 0;
+        std::atomic<quint64> evictions_ = 0;
+        /** Eviction is done by one thread at a time. */
+        std::mutex evictMutex_;
+
+        [[nodiscard]] QString entryPath(const QByteArray& hash, const CfgHeader& header) const;
+        [[nodiscard]] std::unique_ptr<Config> find(const QString& entry, const QByteArray& hash);
+        void evict();
+    };
+} // namespace echoconfig
+
+#endif // CONFIGCACHE_H
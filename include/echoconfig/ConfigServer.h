@@ -0,0 +1,141 @@
+/**
+ * @file ConfigServer.h
+ *
+ * @author Dan Keenan
+ * @date 10/17/2026
+ * @copyright GNU GPLv3
+ */
+
+#ifndef CONFIGSERVER_H
+#define CONFIGSERVER_H
+
+#include <QJsonObject>
+#include <QLocalServer>
+#include <QObject>
+#include <QString>
+#include <QThreadPool>
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include "CfgSource.h"
+#include "Config.h"
+
+class QLocalSocket;
+
+namespace echoconfig
+{
+    /**
+     * Serves conversions over a local socket, keeping recently used configs parsed in memory.
+     *
+     * Callers send one JSON object per line and get one back per line.  Requests are run on a thread pool as soon as
+     * they arrive, so responses can come back in a different order; each response has the "id" of its request.
+     *
+     * Requests have an "op" and the paths it needs:
+     *
+     * | op           | Paths                 | Does                                                          |
+     * |--------------|-----------------------|---------------------------------------------------------------|
+     * | info         | cfg                   | Result has "type", "name", "circuits", "spaces", "presets".   |
+     * | export-sheet | cfg, sheet            | Saves the config's values to the sheet.                       |
+     * | import-sheet | cfg, sheet, out       | Saves the config with the sheet's values to out.              |
+     * | save-cfg     | cfg, out, sheet (opt) | Saves the config to out, with the sheet's values if given.    |
+     *
+     * "compact" and "store" (booleans) pick the sheet layout and compression, as in SheetOptions.
+     *
+     * Responses have "ok", "error" if it failed, "result" for info, "cached" if the config was already in memory, and
+     * "latencyMs", the time spent handling the request.
+     *
+     * Configs are kept by path and parsed again when their file changes.  Requests never change a kept config; imports
+     * work on a copy (see Config::clone()).
+     */
+    class ConfigServer : public QObject
+    {
+        Q_OBJECT
+    public:
+        struct Options
+        {
+            /** Number of requests handled at once.  0 uses one per core. */
+            unsigned int threadCount = 0;
+            /** Number of parsed configs kept in memory.  The least recently used are dropped. */
+            std::size_t maxConfigs = 16;
+        };
+
+        struct Stats
+        {
+            quint64 requests = 0;
+            quint64 failures = 0;
+            /** Requests for a config that was already in memory. */
+            quint64 configHits = 0;
+            quint64 configMisses = 0;
+        };
+
+        explicit ConfigServer(QObject* parent = nullptr);
+        explicit ConfigServer(const Options& options, QObject* parent = nullptr);
+        ~ConfigServer() override;
+
+        /**
+         * Start listening on the local socket @p name.
+         *
+         * Only this user can connect.  A socket left behind by a server that is no longer running is replaced.
+         *
+         * @return false if another server is using @p name or the socket can't be created; see errorString().
+         */
+        bool listen(const QString& name);
+        void close();
+        [[nodiscard]] bool isListening() const { return server_.isListening(); }
+        [[nodiscard]] QString fullServerName() const { return server_.fullServerName(); }
+        [[nodiscard]] QString errorString() const
+        {
+            return listenError_.isEmpty() ? server_.errorString() : listenError_;
+        }
+
+        /**
+         * Handle one request on this thread.  Thread-safe.
+         */
+        [[nodiscard]] QJsonObject handle(const QJsonObject& request);
+
+        [[nodiscard]] Stats stats() const;
+
+    Q_SIGNALS:
+        /**
+         * Emitted on this object's thread after each response from a socket is sent.
+         */
+        void requestFinished(const QJsonObject& request, const QJsonObject& response);
+
+    private:
+        /** A parsed config and the file it was parsed from. */
+        struct HotConfig
+        {
+            QString path;
+            CfgSource source;
+            std::shared_ptr<const Config> config;
+        };
+
+        Options options_;
+        QLocalServer server_;
+        /** Why listen() failed, when it wasn't the socket's fault. */
+        QString listenError_;
+        std::mutex configsMutex_;
+        /** Most recently used first. */
+        std::list<HotConfig> configs_;
+        std::atomic<quint64> requests_ = 0;
+        std::atomic<quint64> failures_ = 0;
+        std::atomic<quint64> configHits_ = 0;
+        std::atomic<quint64> configMisses_ = 0;
+        QThreadPool pool_;
+
+        void acceptConnections();
+        void readRequests(QLocalSocket* socket);
+        static void send(QLocalSocket* socket, const QJsonObject& response);
+
+        /**
+         * Get the config at @p path, parsing it if it isn't in memory or has changed.
+         * @param cached Set to whether the config was in memory.
+         * @throws std::runtime_error if the config can't be loaded.
+         */
+        [[nodiscard]] std::shared_ptr<const Config> hotConfig(const QString& path, bool& cached);
+    };
+} // namespace echoconfig
+
+#endif // CONFIGSERVER_H
@@ -0,0 +1,167 @@
+/**
+ * @file ConfigSnapshot.h
+ *
+ * @author Dan Keenan
+ * @date 10/17/2026
+ * @copyright GNU GPLv3
+ */
+
+#ifndef CONFIGSNAPSHOT_H
+#define CONFIGSNAPSHOT_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QFile>
+#include <QString>
+#include <QtGlobal>
+#include <span>
+#include "Circuit.h"
+#include "Config.h"
+#include "Preset.h"
+#include "RackSpaceMap.h"
+#include "Space.h"
+
+namespace echoconfig
+{
+    /**
+     * A binary snapshot of a parsed config, so a rack can be reopened without parsing its config file again.
+     *
+     * The file is a header followed by arrays of fixed-size records, each aligned to its record size.  Opening a
+     * snapshot maps the file and checks its version, checksum, and bounds; after that the arrays are used where they
+     * lie, without being copied or decoded.  Use Config::fromSnapshot() to get a config that can be edited.
+     *
+     * Snapshots store the size and SHA-256 hash of the config file they were made from, so isSnapshotOf() can tell if
+     * that file has changed since.  They are a cache, not an interchange format: the version is bumped whenever the
+     * layout changes, and they can only be read on a machine with the same byte order as the one that wrote them.
+     *
+     * All errors cause std::runtime_error.
+     */
+    class ConfigSnapshot
+    {
+    public:
+        /** Bumped whenever the layout changes.  Older snapshots are rejected. */
+        static constexpr quint32 kVersion = 1;
+
+        struct RackSpace
+        {
+            quint32 rackSpaceNum;
+            quint32 echoSpaceNum;
+        };
+
+        /**
+         * A preset's values are ranges of the level and fade time arrays; see levels() and fadeTimes().
+         */
+        struct PresetRecord
+        {
+            quint32 num;
+            quint32 firstLevel;
+            quint32 levelCount;
+            quint32 firstFadeTime;
+            quint32 fadeTimeCount;
+        };
+
+        /**
+         * What to save with save().
+         */
+        struct Contents
+        {
+            /** Header of the source file, so the right config type can be picked when restoring. */
+            CfgHeader header;
+            QString panelName;
+            std::span<const Circuit> circuits;
+            std::span<const Space> spaces;
+            std::span<const RackSpaceMap::Entry> rackSpaces;
+            std::span<const Preset> presets;
+            /** Contents of the config file the values were parsed from. */
+            QByteArrayView source;
+            /** hashOf(source), if it is already known.  Hashed when saving if empty. */
+            QByteArray sourceHash;
+        };
+
+        /**
+         * Write a snapshot to @p path.
+         */
+        static void save(const QString& path, const Contents& contents);
+
+        /**
+         * Open the snapshot at @p path.
+         * @throws std::runtime_error if the file can't be read, is from another version, or is corrupt.
+         */
+        explicit ConfigSnapshot(const QString& path);
+        ConfigSnapshot(const ConfigSnapshot&) = delete;
+        ConfigSnapshot& operator=(const ConfigSnapshot&) = delete;
+
+        [[nodiscard]] const CfgHeader& cfgHeader() const { return header_; }
+        [[nodiscard]] const QString& panelName() const { return panelName_; }
+
+        /** Sorted by number. */
+        [[nodiscard]] std::span<const Circuit> circuits() const { return circuits_; }
+        /** Sorted by number. */
+        [[nodiscard]] std::span<const Space> spaces() const { return spaces_; }
+        /** Sorted by rack space number. */
+        [[nodiscard]] std::span<const RackSpace> rackSpaces() const { return rackSpaces_; }
+        /** Sorted by number. */
+        [[nodiscard]] std::span<const PresetRecord> presets() const { return presets_; }
+
+        /** Circuit numbers with a level in @p preset, ascending. */
+        [[nodiscard]] std::span<const quint32> levelCircuits(const PresetRecord& preset) const
+        {
+            return levelCircuits_.subspan(preset.firstLevel, preset.levelCount);
+        }
+
+        /** Levels of @p preset, in the same order as levelCircuits(). */
+        [[nodiscard]] std::span<const quint8> levels(const PresetRecord& preset) const
+        {
+            return levels_.subspan(preset.firstLevel, preset.levelCount);
+        }
+
+        /** Space numbers with a fade time in @p preset, ascending. */
+        [[nodiscard]] std::span<const quint32> fadeTimeSpaces(const PresetRecord& preset) const
+        {
+            return fadeTimeSpaces_.subspan(preset.firstFadeTime, preset.fadeTimeCount);
+        }
+
+        /** Fade times of @p preset, in the same order as fadeTimeSpaces(). */
+        [[nodiscard]] std::span<const quint16> fadeTimes(const PresetRecord& preset) const
+        {
+            return fadeTimes_.subspan(preset.firstFadeTime, preset.fadeTimeCount);
+        }
+
+        /** SHA-256 hash of the config file this snapshot was made from. */
+        [[nodiscard]] const QByteArray& sourceHash() const { return sourceHash_; }
+
+        /**
+         * Hash config file contents the way snapshots do.
+         */
+        [[nodiscard]] static QByteArray hashOf(QByteArrayView source);
+
+        /**
+         * Check that the config file at @p sourcePath is the one this snapshot was made from, unchanged.
+         */
+        [[nodiscard]] bool isSnapshotOf(const QString& sourcePath) const;
+
+        /**
+         * Check that @p source is the contents of the config file this snapshot was made from.
+         */
+        [[nodiscard]] bool isSnapshotOf(QByteArrayView source) const;
+
+    private:
+        QFile file_;
+        /** The whole file, mapped if possible. */
+        QByteArray data_;
+        CfgHeader header_;
+        QString panelName_;
+        qint64 sourceSize_ = 0;
+        QByteArray sourceHash_;
+        std::span<const Circuit> circuits_;
+        std::span<const Space> spaces_;
+        std::span<const RackSpace> rackSpaces_;
+        std::span<const PresetRecord> presets_;
+        std::span<const quint32> levelCircuits_;
+        std::span<const quint8> levels_;
+        std::span<const quint32> fadeTimeSpaces_;
+        std::span<const quint16> fadeTimes_;
+    };
+} // namespace echoconfig
+
+#endif // CONFIGSNAPSHOT_H
@@ -0,0 +1,86 @@
+/**
+ * @file CsvReader.h
+ *
+ * @author Dan Keenan
+ * @date 10/17/2026
+ * @copyright GNU GPLv3
+ */
+
+#ifndef CSVREADER_H
+#define CSVREADER_H
+
+#include <QByteArray>
+#include <span>
+#include "SheetCell.h"
+
+class QIODevice;
+
+namespace echoconfig
+{
+    /**
+     * Read the rows of a delimited text table (CSV or TSV) in order, through a fixed-size buffer.
+     *
+     * Text is UTF-8, with or without a byte order mark.  Quoted fields as in RFC 4180 may contain the delimiter,
+     * quotes, and line breaks; rows may end with LF or CRLF.  Fields of plain digits are Number cells and other
+     * non-empty fields are String cells.
+     *
+     * Only the current row is held in memory.  Rows with no values are skipped.  The interface matches
+     * XlsxSheetReader, so the same code can read either.
+     *
+     * All errors cause std::runtime_error.
+     */
+    class CsvReader
+    {
+    public:
+        using Cell = SheetCell;
+        using CellType = SheetCell::Type;
+
+        /**
+         * @param device Open for reading.  Must outlive the reader.
+         * @param delimiter ',' for CSV, '\t' for TSV.
+         */
+        explicit CsvReader(QIODevice* device, char delimiter = ',');
+
+        /**
+         * Advance to the next row with values.
+         * @return false once there are no more rows.
+         */
+        bool readRow();
+
+        /** 1-based number of the current row in the file, counting rows without values. */
+        [[nodiscard]] int rowNum() const { return rowNum_; }
+
+        /** Cells with values in the current row, in column order. */
+        [[nodiscard]] std::span<const Cell> cells() const { return row_.cells(); }
+
+        /**
+         * Get the cell at @p col (1-based) in the current row.
+         * @return The cell, or nullptr if it has no value.
+         */
+        [[nodiscard]] const Cell* cell(int col) const { return row_.cell(col); }
+
+    private:
+        QIODevice* device_;
+        char delimiter_;
+        QByteArray buffer_;
+        qsizetype pos_ = 0;
+        bool atEnd_ = false;
+        int rowNum_ = 0;
+        SheetRow row_;
+        /** Reused for each field's text. */
+        QByteArray field_;
+
+        /**
+         * Read one record into row_.
+         * @return false if there are no more records.
+         */
+        bool readRecord();
+        void addCell(int col);
+        /** @return The next byte without consuming it, or -1 at the end of the file. */
+        int peek();
+        /** Refill buffer_ once it is used up. @return false at the end of the file. */
+        bool fill();
+    };
+} // namespace echoconfig
+
+#endif // CSVREADER_H
@@ -0,0 +1,70 @@
+/**
+ * @file CsvWriter.h
+ *
+ * @author Dan Keenan
+ * @date 10/17/2026
+ * @copyright GNU GPLv3
+ */
+
+#ifndef CSVWRITER_H
+#define CSVWRITER_H
+
+#include <QByteArray>
+#include <QString>
+
+class QIODevice;
+
+namespace echoconfig
+{
+    /**
+     * Write a delimited text table (CSV or TSV) row by row through a fixed-size buffer.
+     *
+     * Text is UTF-8 and rows end with CRLF.  Fields containing the delimiter, a quote, or a line break are quoted as
+     * in RFC 4180.
+     *
+     * Usage: for each row beginRow(), write cells in column order, endRow(); then end().  The interface matches
+     * XlsxSheetWriter, so the same code can write either.
+     *
+     * All errors cause std::runtime_error.
+     */
+    class CsvWriter
+    {
+    public:
+        /**
+         * @param device Open for writing.  Must outlive the writer.
+         * @param delimiter ',' for CSV, '\t' for TSV.
+         */
+        explicit CsvWriter(QIODevice* device, char delimiter = ',');
+
+        void beginRow();
+        void endRow();
+
+        /**
+         * Write a string to column @p col (1-based) of the current row.
+         */
+        void writeString(int col, const QString& value);
+
+        /**
+         * Write a number to column @p col (1-based) of the current row.
+         */
+        void writeNumber(int col, unsigned int value);
+
+        /**
+         * Write out anything buffered.  Nothing more may be written afterwards.
+         */
+        void end();
+
+    private:
+        QIODevice* device_;
+        char delimiter_;
+        QByteArray buffer_;
+        /** Last column written in the current row, or 0. */
+        int col_ = 0;
+        bool ended_ = false;
+
+        void moveTo(int col);
+        void flush(bool force);
+    };
+} // namespace echoconfig
+
+#endif // CSVWRITER_H
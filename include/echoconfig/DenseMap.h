@@ -0,0 +1,286 @@
+/**
+ * @file DenseMap.h
+ *
+ * @author Dan Keenan
+ * @date 10/17/2026
+ * @copyright GNU GPLv3
+ */
+
+#ifndef DENSEMAP_H
+#define DENSEMAP_H
+
+#include <algorithm>
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace echoconfig
+{
+    /**
+     * A map from small unsigned keys (circuit, space, and preset numbers) to small values.
+     *
+     * Values are stored contiguously, indexed by key, with a bitmap recording which keys are present.  Iteration
+     * visits present keys in ascending order, like std::map.  Keys above kMaxKey are rejected instead of allocating
+     * storage for every key below them.
+     *
+     * @tparam T Value type.
+     */
+    template <typename T>
+    class DenseMap
+    {
+        using Word = std::uint64_t;
+        static constexpr std::size_t kWordBits = 64;
+
+    public:
+        using key_type = unsigned int;
+        using mapped_type = T;
+        using size_type = std::size_t;
+
+        /** Largest key that can be stored.  Echo numbers are far smaller. */
+        static constexpr key_type kMaxKey = 65535;
+
+        template <bool Const>
+        class Iterator
+        {
+            friend class DenseMap;
+            friend class Iterator<!Const>;
+            using Map = std::conditional_t<Const, const DenseMap, DenseMap>;
+            using Mapped = std::conditional_t<Const, const T, T>;
+
+        public:
+            // Keys are not stored, so entries are proxies that refer to the stored value.  That makes this only an
+            // input iterator to code that expects references, but a forward iterator to ranges.
+            using iterator_category = std::input_iterator_tag;
+            using iterator_concept = std::forward_iterator_tag;
+            using difference_type = std::ptrdiff_t;
+            using value_type = std::pair<key_type, Mapped&>;
+            using reference = value_type;
+
+            /**
+             * Allows `it->second`, which is how most code consumes map iterators.
+             */
+            struct Arrow
+            {
+                reference ref;
+                const reference* operator->() const { return &ref; }
+            };
+
+            Iterator() = default;
+
+            template <bool OtherConst>
+                requires(Const && !OtherConst)
+            Iterator(const Iterator<OtherConst>& other) : map_(other.map_), key_(other.key_)
+            {}
+
+            reference operator*() const { return {key_, map_->values_[key_]}; }
+            Arrow operator->() const { return {**this}; }
+
+            Iterator& operator++()
+            {
+                key_ = map_->nextKey(key_ + 1);
+                return *this;
+            }
+
+            Iterator operator++(int)
+            {
+                auto old = *this;
+                ++*this;
+                return old;
+            }
+
+            bool operator==(const Iterator& other) const { return key_ == other.key_; }
+
+        private:
+            Map* map_ = nullptr;
+            std::size_t key_ = 0;
+
+            Iterator(Map* map, std::size_t key) : map_(map), key_(key) {}
+        };
+        using iterator = Iterator<false>;
+        using const_iterator = Iterator<true>;
+
+        DenseMap() = default;
+
+        DenseMap(std::initializer_list<std::pair<key_type, T>> init)
+        {
+            for (const auto& [key, value] : init)
+            {
+                (*this)[key] = value;
+            }
+        }
+
+        [[nodiscard]] iterator begin() { return {this, nextKey(0)}; }
+        [[nodiscard]] iterator end() { return {this, values_.size()}; }
+        [[nodiscard]] const_iterator begin() const { return {this, nextKey(0)}; }
+        [[nodiscard]] const_iterator end() const { return {this, values_.size()}; }
+        [[nodiscard]] const_iterator cbegin() const { return begin(); }
+        [[nodiscard]] const_iterator cend() const { return end(); }
+
+        [[nodiscard]] size_type size() const { return size_; }
+        [[nodiscard]] bool empty() const { return size_ == 0; }
+
+        /**
+         * Make room for keys up to and including @p maxKey without further allocation.
+         * @param maxKey
+         * @throws std::runtime_error if @p maxKey is above kMaxKey.
+         */
+        void reserve(key_type maxKey)
+        {
+            checkKey(maxKey);
+            values_.reserve(maxKey + 1);
+            present_.reserve(maxKey / kWordBits + 1);
+        }
+
+        void clear()
+        {
+            values_.clear();
+            present_.clear();
+            size_ = 0;
+        }
+
+        [[nodiscard]] bool contains(key_type key) const
+        {
+            return key < values_.size() && (present_[key / kWordBits] & bit(key)) != 0;
+        }
+
+        [[nodiscard]] iterator find(key_type key) { return contains(key) ? iterator{this, key} : end(); }
+        [[nodiscard]] const_iterator find(key_type key) const
+        {
+            return contains(key) ? const_iterator{this, key} : end();
+        }
+
+        /**
+         * @throws std::out_of_range if @p key is not present.
+         */
+        [[nodiscard]] T& at(key_type key)
+        {
+            if (!contains(key))
+            {
+                throw std::out_of_range("DenseMap::at");
+            }
+            return values_[key];
+        }
+
+        /**
+         * @throws std::out_of_range if @p key is not present.
+         */
+        [[nodiscard]] const T& at(key_type key) const
+        {
+            if (!contains(key))
+            {
+                throw std::out_of_range("DenseMap::at");
+            }
+            return values_[key];
+        }
+
+        /**
+         * Get the value for @p key, inserting a value-initialized one if it is not present.
+         * @throws std::runtime_error if @p key is above kMaxKey.
+         */
+        T& operator[](key_type key)
+        {
+            if (key >= values_.size())
+            {
+                checkKey(key);
+                values_.resize(key + 1);
+                present_.resize(key / kWordBits + 1);
+            }
+            auto& word = present_[key / kWordBits];
+            if ((word & bit(key)) == 0)
+            {
+                word |= bit(key);
+                ++size_;
+            }
+            return values_[key];
+        }
+
+        std::pair<iterator, bool> emplace(key_type key, T value)
+        {
+            if (contains(key))
+            {
+                return {iterator{this, key}, false};
+            }
+            (*this)[key] = value;
+            return {iterator{this, key}, true};
+        }
+
+        void insert_or_assign(key_type key, T value) { (*this)[key] = value; }
+
+        size_type erase(key_type key)
+        {
+            if (!contains(key))
+            {
+                return 0;
+            }
+            present_[key / kWordBits] &= ~bit(key);
+            values_[key] = T{};
+            --size_;
+            return 1;
+        }
+
+        bool operator==(const DenseMap& other) const
+        {
+            return size_ == other.size_ && std::ranges::equal(*this, other);
+        }
+
+        auto operator<=>(const DenseMap& other) const
+        {
+            return std::lexicographical_compare_three_way(begin(), end(), other.begin(), other.end(),
+                                                          [](const auto& lhs, const auto& rhs)
+                                                          {
+                                                              if (const auto cmp = lhs.first <=> rhs.first; cmp != 0)
+                                                              {
+                                                                  return cmp;
+                                                              }
+                                                              return lhs.second <=> rhs.second;
+                                                          });
+        }
+
+    private:
+        std::vector<T> values_;
+        /** One bit per key in values_. */
+        std::vector<Word> present_;
+        size_type size_ = 0;
+
+        static constexpr Word bit(std::size_t key) { return Word{1} << (key % kWordBits); }
+
+        static void checkKey(key_type key)
+        {
+            if (key > kMaxKey)
+            {
+                throw std::runtime_error("Number too large");
+            }
+        }
+
+        /**
+         * Find the first present key >= @p key, or values_.size() if there is none.
+         */
+        [[nodiscard]] std::size_t nextKey(std::size_t key) const
+        {
+            auto wordIx = key / kWordBits;
+            if (wordIx >= present_.size())
+            {
+                return values_.size();
+            }
+            // Mask off the keys before the requested one.
+            Word word = present_[wordIx] & (~Word{0} << (key % kWordBits));
+            while (word == 0)
+            {
+                if (++wordIx >= present_.size())
+                {
+                    return values_.size();
+                }
+                word = present_[wordIx];
+            }
+            return std::min(wordIx * kWordBits + std::countr_zero(word), values_.size());
+        }
+    };
+} // namespace echoconfig
+
+#endif // DENSEMAP_H
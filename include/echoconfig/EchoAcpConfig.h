@@ -24,6 +24,10 @@ namespace echoconfig
         }
 
     protected:
+        [[nodiscard]] std::unique_ptr<EchoPcpConfig> createEmpty() const override
+        {
+            return std::make_unique<EchoAcpConfig>();
+        }
         [[nodiscard]] QString rootTagName() const override { return QStringLiteral("EACP"); }
         [[nodiscard]] QString rackTagName() const override { return QStringLiteral("RACK"); }
         [[nodiscard]] QString outputTagName() const override { return QStringLiteral("OUTPUT"); }
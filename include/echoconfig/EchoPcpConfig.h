@@ -9,12 +9,23 @@
 #ifndef ECHOPCPCONFIG_H
 #define ECHOPCPCONFIG_H
 
-#include <unordered_map>
+#include <QIODevice>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+#include "echoconfig/CfgSource.h"
 #include "echoconfig/Config.h"
+#include "echoconfig/NumberedVector.h"
+#include "echoconfig/RackSpaceMap.h"
+#include "echoconfig/SpliceIndex.h"
 #include "echoconfig/Space.h"
 
 namespace echoconfig
 {
+    class StructuralIndex;
+
     class EchoPcpConfig : public Config
     {
         Q_OBJECT
@@ -23,34 +34,56 @@ namespace echoconfig
 
         [[nodiscard]] QString panelType() const override { return tr("Echo PCP v3.1.X"); }
         [[nodiscard]] QString panelName() const override { return name_; }
+        [[nodiscard]] bool acceptsHeader(const CfgHeader& header) const override;
 
         void parseCfg(const QString& path) override;
-        void parseSheet(const QString& path) override;
         void saveCfg(const QString& basePath, const QString& outPath) const override;
+        void saveSnapshot(const QString& sourcePath, const QString& path) const override;
+        void saveSnapshot(const CfgHeader& header, QByteArrayView source, const QByteArray& sourceHash,
+                          const QString& path) const override;
+        void loadSnapshot(const ConfigSnapshot& snapshot) override;
+        void retainBase(const QString& path, const QByteArray& data) override;
+
+        [[nodiscard]] std::span<const Circuit> circuits() const override { return circuits_.items(); }
+        [[nodiscard]] std::span<const Space> spaces() const override { return spaces_.items(); }
+        [[nodiscard]] std::span<const Preset> presets() const override { return presets_.items(); }
 
         [[nodiscard]] unsigned circuitCount() const override { return circuits_.size(); }
         [[nodiscard]] const Circuit& getCircuitAt(unsigned int ix) const override;
         [[nodiscard]] Circuit& getCircuitAt(unsigned int ix) override;
-        [[nodiscard]] const Circuit& getCircuit(unsigned int num) const override { return circuits_.at(num); }
-        [[nodiscard]] Circuit& getCircuit(unsigned int num) override { return circuits_[num]; }
+        [[nodiscard]] const Circuit& getCircuit(unsigned int num) const override { return circuits_.get(num); }
+        [[nodiscard]] Circuit& getCircuit(unsigned int num) override { return circuits_.getOrInsert(num); }
 
         [[nodiscard]] unsigned spaceCount() const override { return spaces_.size(); }
         [[nodiscard]] const Space& getSpaceAt(unsigned int ix) const override;
         [[nodiscard]] Space& getSpaceAt(unsigned int ix) override;
         [[nodiscard]] const Space& getSpaceAtRack(unsigned int ix) const;
         [[nodiscard]] Space& getSpaceAtRack(unsigned int ix);
-        [[nodiscard]] const Space& getSpace(unsigned int num) const override { return spaces_.at(num); }
-        [[nodiscard]] Space& getSpace(unsigned int num) override { return spaces_[num]; }
-        [[nodiscard]] const Space& getRackSpace(unsigned int num) const { return spaces_.at(rackSpaces_.at(num)); }
-        [[nodiscard]] Space& getRackSpace(unsigned int num) { return spaces_[rackSpaces_.at(num)]; }
+        [[nodiscard]] const Space& getSpace(unsigned int num) const override { return spaces_.get(num); }
+        [[nodiscard]] Space& getSpace(unsigned int num) override { return spaces_.getOrInsert(num); }
+        [[nodiscard]] const Space& getRackSpace(unsigned int num) const;
+        [[nodiscard]] Space& getRackSpace(unsigned int num);
+        [[nodiscard]] const RackSpaceMap& rackSpaces() const { return rackSpaces_; }
 
         [[nodiscard]] unsigned presetCount() const override { return presets_.size(); }
         [[nodiscard]] const Preset& getPresetAt(unsigned int ix) const override;
         [[nodiscard]] Preset& getPresetAt(unsigned int ix) override;
-        [[nodiscard]] const Preset& getPreset(unsigned int num) const override { return presets_.at(num); }
-        [[nodiscard]] Preset& getPreset(unsigned int num) override { return presets_[num]; }
+        [[nodiscard]] const Preset& getPreset(unsigned int num) const override { return presets_.get(num); }
+        [[nodiscard]] Preset& getPreset(unsigned int num) override { return presets_.getOrInsert(num); }
+
+        [[nodiscard]] std::unique_ptr<Config> clone() const override;
 
     protected:
+        void sheetApplied() override;
+
+        /**
+         * An empty config of the same type, for clone().
+         */
+        [[nodiscard]] virtual std::unique_ptr<EchoPcpConfig> createEmpty() const
+        {
+            return std::make_unique<EchoPcpConfig>();
+        }
+
         [[nodiscard]] virtual QString rootTagName() const { return QStringLiteral("SMARTSWITCH2"); }
         [[nodiscard]] virtual QString rackTagName() const { return QStringLiteral("CABINET"); }
         [[nodiscard]] virtual QString outputTagName() const { return QStringLiteral("RELAY"); }
@@ -59,17 +92,107 @@ namespace echoconfig
         [[nodiscard]] virtual bool isVersionCompatible(QStringView versionStr) const;
 
     private:
-        // using RackSpaceMap = boost::bimap<unsigned int, unsigned int>;
+        struct DialectNames;
+        struct ParseState;
+        class SpliceRecorder;
 
         QString name_;
-        /** Circuit num > Circuit */
-        std::unordered_map<unsigned int, Circuit> circuits_;
-        /** Rack space num > Echo space num */
-        std::unordered_map<unsigned int, unsigned int> rackSpaces_;
-        /** Echo space num > Space */
-        std::unordered_map<unsigned int, Space> spaces_;
-        /** Preset num > Preset */
-        std::unordered_map<unsigned int, Preset> presets_;
+        /** Sorted by circuit num */
+        NumberedVector<Circuit> circuits_;
+        /** Rack space num <> Echo space num */
+        RackSpaceMap rackSpaces_;
+        /** Sorted by Echo space num */
+        NumberedVector<Space> spaces_;
+        /** Sorted by preset num */
+        NumberedVector<Preset> presets_;
+        /** The file last parsed. */
+        std::optional<CfgSource> source_;
+        /** Contents of the file last parsed, if ParseOptions::retainBase was set.  Shared with clones. */
+        QByteArray baseCfg_;
+        /** Where values are in the file last parsed, if it was parsed with ParseEngine::Mapped.  Shared with clones. */
+        std::shared_ptr<const SpliceIndex> spliceIndex_;
+
+        [[nodiscard]] DialectNames dialectNames() const;
+
+        /**
+         * Estimate from the start of a file the elements that will be stored, so storage can be reserved early.
+         * @param head The first part of a config file.
+         * @param totalSize Size of the whole file.
+         */
+        void reserveFor(const QByteArray& head, qint64 totalSize);
+
+        /**
+         * Count the elements in @p data that will be stored, using an index of it that has already been built.
+         * @param data Contents of a config file.
+         * @param index Covers all of @p data.
+         * @param scale Counts are multiplied by this, for when @p data is only part of the file.
+         */
+        void reserveFor(std::string_view data, const StructuralIndex& index, double scale = 1.0);
+
+        /**
+         * Handle one start element from either parse engine.
+         * @tparam Element Adapts the engine's current element.
+         */
+        template <typename Element>
+        void parseElement(const Element& element, ParseState& state);
+
+        /**
+         * Handle one start element that belongs to a preset.  Only reads the config, so presets can be parsed on many
+         * threads at once.
+         * @return false if @p element isn't part of a preset.
+         */
+        template <typename Element>
+        bool parsePresetElement(const Element& element, ParseState& state) const;
+
+        /**
+         * Scan @p data, parsing the header first and then pieces of the presets at the same time.
+         *
+         * @param data Contents of a UTF-8 config file.
+         * @param points Where values are in @p data are added here.
+         * @param index Covers all of @p data; shared by every piece.
+         * @return The presets in the order they are in @p data, or std::nullopt if @p data is too small to split or
+         * has to be parsed in order.  Errors also give std::nullopt, so parsing in order can report them.
+         */
+        [[nodiscard]] std::optional<std::vector<Preset>> parseChunked(std::string_view data,
+                                                                      std::vector<SplicePoint>& points,
+                                                                      std::shared_ptr<const StructuralIndex> index);
+
+        /**
+         * Find the values to splice into @p data, checking it is the right type of config.
+         * @throws std::runtime_error if @p data cannot be parsed.
+         */
+        [[nodiscard]] SpliceIndex indexCfg(std::string_view data) const;
+
+        /**
+         * Write @p data to @p out, replacing the values at each point in @p index with the current values.
+         *
+         * Large files are split up at presets and the pieces are spliced at the same time (see SaveOptions).  They are
+         * written in order, so the file is the same either way.
+         */
+        void spliceCfg(std::string_view data, const SpliceIndex& index, QIODevice& out) const;
+
+        /**
+         * Write the part of @p data from @p begin up to @p end, replacing the values at @p points.
+         * @param points The points in the part, in order.
+         * @param write Called with each run of bytes to write, in order.
+         */
+        template <typename Write>
+        void spliceRange(std::string_view data, std::size_t begin, std::size_t end,
+                         std::span<const SplicePoint> points, Write&& write) const;
+
+        /**
+         * The current value for @p point, or std::nullopt if it should be left alone.
+         * @param point
+         * @param preset The preset @p point belongs to, if any.
+         */
+        [[nodiscard]] std::optional<unsigned int> splicedValue(const SplicePoint& point, const Preset* preset) const;
+
+        /**
+         * Write @p base to @p out with the current values, by parsing and re-serializing it.
+         *
+         * Used for files that aren't UTF-8, which can't be spliced byte-wise.
+         */
+        void rewriteCfg(const QByteArray& base, QIODevice& out) const;
     };
 } // namespace echoconfig
 
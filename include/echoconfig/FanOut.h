@@ -0,0 +1,111 @@
+/**
+ * @file FanOut.h
+ *
+ * @author Dan Keenan
+ * @date 10/17/2026
+ * @copyright GNU GPLv3
+ */
+
+#ifndef FANOUT_H
+#define FANOUT_H
+
+#include <QString>
+#include <QStringList>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+#include "Config.h"
+
+namespace echoconfig
+{
+    /**
+     * Makes configs for many racks that share one base config, from a workbook with a pair of sheets per rack.
+     *
+     * The rack named "North" has its values in the sheets "North Levels" and "North Times", laid out like the Levels
+     * and Times sheets from Config::saveSheet().  Racks are in the order their Levels sheets are in the workbook.
+     *
+     * The base is parsed once when the fan-out is made and kept in memory.  Each rack starts from a copy of it (see
+     * Config::clone()), so racks can be saved at the same time without reading the base again.
+     */
+    class FanOut
+    {
+    public:
+        struct Options
+        {
+            /** Number of worker threads.  0 uses one per core. */
+            unsigned int threadCount = 0;
+        };
+
+        struct RackResult
+        {
+            QString rack;
+            QString outPath;
+            bool ok = false;
+            /** Why the rack failed. */
+            QString error;
+            std::chrono::nanoseconds parseSheets{0};
+            std::chrono::nanoseconds saveCfg{0};
+        };
+
+        struct Report
+        {
+            /** In workbook order. */
+            std::vector<RackResult> results;
+            unsigned int threadCount = 0;
+            std::chrono::nanoseconds wallTime{0};
+
+            [[nodiscard]] std::size_t failedCount() const;
+        };
+
+        /**
+         * Parse the base config.
+         * @throws std::runtime_error if the base config can't be loaded.
+         */
+        explicit FanOut(const QString& basePath);
+
+        [[nodiscard]] const QString& basePath() const { return basePath_; }
+        [[nodiscard]] const Config& base() const { return *base_; }
+
+        [[nodiscard]] static QString levelsSheetName(const QString& rack);
+        [[nodiscard]] static QString timesSheetName(const QString& rack);
+
+        /**
+         * Names of the racks in a fan-out workbook.
+         * @throws std::runtime_error if a rack is missing its Times sheet.
+         */
+        [[nodiscard]] static QStringList rackNames(const XlsxReader& workbook);
+
+        /**
+         * Save the values of many racks to one workbook, in the layout run() reads.
+         *
+         * @param path
+         * @param racks Rack names and their configs.
+         * @param options The format is always xlsx.
+         * @throws std::runtime_error if the workbook can't be saved.
+         */
+        static void saveWorkbook(const QString& path, std::span<const std::pair<QString, const Config*>> racks,
+                                 const SheetOptions& options = {});
+
+        /**
+         * Save a config for each rack in the workbook at @p workbookPath.
+         *
+         * Each config is written to @p outDir, named after its rack with the base config's suffix.  A rack that fails
+         * is reported and doesn't affect the others.  Racks whose names aren't plain file names on every platform, or
+         * that would be saved to the same file as an earlier rack, fail without being saved.  Names may hold letters,
+         * digits, spaces and " -_.,()+&#".
+         *
+         * @throws std::runtime_error if the workbook itself can't be read.
+         */
+        [[nodiscard]] Report run(const QString& workbookPath, const QString& outDir, const Options& options) const;
+        [[nodiscard]] Report run(const QString& workbookPath, const QString& outDir) const;
+
+    private:
+        QString basePath_;
+        std::unique_ptr<Config> base_;
+    };
+} // namespace echoconfig
+
+#endif // FANOUT_H
@@ -0,0 +1,89 @@
+/**
+ * @file FixtureGenerator.h
+ *
+ * @author Dan Keenan
+ * @date 10/17/2026
+ * @copyright GNU GPLv3
+ */
+
+#ifndef FIXTUREGENERATOR_H
+#define FIXTUREGENERATOR_H
+
+#include <QByteArray>
+#include <QString>
+#include <cstdint>
+#include <memory>
+#include "Config.h"
+
+namespace echoconfig
+{
+    /**
+     * Generates synthetic, valid config files (and matching spreadsheets) of arbitrary size.
+     *
+     * Used for benchmarks and scaling tests, so large fixtures don't need to be checked in.  The same options and seed
+     * always produce the same output.
+     */
+    class FixtureGenerator
+    {
+    public:
+        enum class Dialect
+        {
+            /** Echo PCP (SMARTSWITCH2) */
+            Pcp,
+            /** Echo ACP (EACP) */
+            Acp,
+        };
+
+        struct Options
+        {
+            Dialect dialect = Dialect::Pcp;
+            unsigned int circuitCount = 48;
+            /** Number of Echo spaces in use.  There are always at least 16 rack spaces. */
+            unsigned int spaceCount = 2;
+            unsigned int presetCount = 64;
+            unsigned int sequenceCount = 1;
+            std::uint32_t seed = 0;
+        };
+
+        /**
+         * @throws std::runtime_error if @p options are out of range.
+         */
+        explicit FixtureGenerator(const Options& options);
+
+        [[nodiscard]] const Options& options() const { return options_; }
+
+        /**
+         * Create an empty config of the type matching the dialect.
+         */
+        [[nodiscard]] std::unique_ptr<Config> createConfig() const;
+
+        /**
+         * The usual file suffix for the dialect, without the leading dot.
+         */
+        [[nodiscard]] QString cfgSuffix() const;
+
+        /**
+         * Generate the contents of a config file.
+         */
+        [[nodiscard]] QByteArray generateCfg() const;
+
+        /**
+         * Generate a config file and save it to @p path.
+         * @throws std::runtime_error if the file cannot be written.
+         */
+        void saveCfg(const QString& path) const;
+
+        /**
+         * Save a spreadsheet matching the generated config to @p path.
+         * @throws std::runtime_error if the file cannot be written.
+         */
+        void saveSheet(const QString& path) const;
+
+    private:
+        Options options_;
+
+        [[nodiscard]] unsigned int rackSpaceCount() const;
+    };
+} // namespace echoconfig
+
+#endif // FIXTUREGENERATOR_H
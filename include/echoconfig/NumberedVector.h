@@ -0,0 +1,141 @@
+/**
+ * @file NumberedVector.h
+ *
+ * @author Dan Keenan
+ * @date 10/17/2026
+ * @copyright GNU GPLv3
+ */
+
+#ifndef NUMBEREDVECTOR_H
+#define NUMBEREDVECTOR_H
+
+#include <algorithm>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace echoconfig
+{
+    /**
+     * A vector of items kept sorted by their `num` member.
+     *
+     * Indexed access is O(1), lookup by number is O(log n), and iteration is always in number order.  Items are
+     * usually added in ascending order, which appends without moving anything.
+     *
+     * @tparam T A type with an `unsigned int num` member (e.g. Circuit, Space, Preset).
+     */
+    template <typename T>
+    class NumberedVector
+    {
+    public:
+        using value_type = T;
+        using size_type = std::size_t;
+        using iterator = typename std::vector<T>::iterator;
+        using const_iterator = typename std::vector<T>::const_iterator;
+
+        [[nodiscard]] iterator begin() { return items_.begin(); }
+        [[nodiscard]] iterator end() { return items_.end(); }
+        [[nodiscard]] const_iterator begin() const { return items_.begin(); }
+        [[nodiscard]] const_iterator end() const { return items_.end(); }
+
+        [[nodiscard]] size_type size() const { return items_.size(); }
+        [[nodiscard]] bool empty() const { return items_.empty(); }
+        void reserve(size_type count) { items_.reserve(count); }
+        void clear() { items_.clear(); }
+
+        [[nodiscard]] std::span<T> items() { return items_; }
+        [[nodiscard]] std::span<const T> items() const { return items_; }
+
+        [[nodiscard]] T& operator[](size_type ix) { return items_[ix]; }
+        [[nodiscard]] const T& operator[](size_type ix) const { return items_[ix]; }
+
+        /**
+         * Find the item numbered @p num.
+         * @param num
+         * @return The item, or nullptr if there is none.
+         */
+        [[nodiscard]] T* find(unsigned int num)
+        {
+            const auto it = lowerBound(num);
+            return it != items_.end() && it->num == num ? &*it : nullptr;
+        }
+
+        [[nodiscard]] const T* find(unsigned int num) const
+        {
+            const auto it = std::ranges::lower_bound(items_, num, {}, &T::num);
+            return it != items_.end() && it->num == num ? &*it : nullptr;
+        }
+
+        /**
+         * Get the item numbered @p num.
+         * @throws std::out_of_range if there is no such item.
+         */
+        [[nodiscard]] T& get(unsigned int num)
+        {
+            auto* item = find(num);
+            if (item == nullptr)
+            {
+                throw std::out_of_range("No item with that number");
+            }
+            return *item;
+        }
+
+        /**
+         * Get the item numbered @p num.
+         * @throws std::out_of_range if there is no such item.
+         */
+        [[nodiscard]] const T& get(unsigned int num) const
+        {
+            const auto* item = find(num);
+            if (item == nullptr)
+            {
+                throw std::out_of_range("No item with that number");
+            }
+            return *item;
+        }
+
+        /**
+         * Get the item numbered @p num, inserting a new one (with only `num` set) if there is none.
+         *
+         * Inserting invalidates references to other items.
+         */
+        T& getOrInsert(unsigned int num)
+        {
+            // Fast path for the common case of items arriving in order.
+            if (items_.empty() || items_.back().num < num)
+            {
+                auto& item = items_.emplace_back();
+                item.num = num;
+                return item;
+            }
+            const auto it = lowerBound(num);
+            if (it != items_.end() && it->num == num)
+            {
+                return *it;
+            }
+            auto inserted = items_.emplace(it);
+            inserted->num = num;
+            return *inserted;
+        }
+
+        /**
+         * Insert or replace the item with the same number as @p item.
+         */
+        T& insertOrAssign(T item)
+        {
+            auto& existing = getOrInsert(item.num);
+            existing = std::move(item);
+            return existing;
+        }
+
+    private:
+        std::vector<T> items_;
+
+        [[nodiscard]] iterator lowerBound(unsigned int num)
+        {
+            return std::ranges::lower_bound(items_, num, {}, &T::num);
+        }
+    };
+} // namespace echoconfig
+
+#endif // NUMBEREDVECTOR_H
@@ -9,7 +9,9 @@
 #ifndef PRESET_H
 #define PRESET_H
 
-#include <map>
+#include <cstdint>
+#include <ostream>
+#include "DenseMap.h"
 
 namespace echoconfig
 {
@@ -24,7 +26,7 @@ namespace echoconfig
             }
             for (const auto [circuitNum, level] : val.levels)
             {
-                os << circuitNum << "@" << level << ", ";
+                os << circuitNum << "@" << static_cast<unsigned int>(level) << ", ";
             }
             os << ">";
             return os;
@@ -34,10 +36,10 @@ namespace echoconfig
         auto operator<=>(const Preset&) const = default;
 
         unsigned int num;
-        std::map<unsigned int, unsigned int> levels;
-        /** Space num > fade time (seconds) */
-        std::map<unsigned int, unsigned int> fadeTimes;
         /** Rack ckt num > level (0-255) */
+        DenseMap<std::uint8_t> levels;
+        /** Space num > fade time (seconds) */
+        DenseMap<std::uint16_t> fadeTimes;
     };
 } // namespace echoconfig
 
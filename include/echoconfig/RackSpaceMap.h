@@ -0,0 +1,119 @@
+/**
+ * @file RackSpaceMap.h
+ *
+ * @author Dan Keenan
+ * @date 10/17/2026
+ * @copyright GNU GPLv3
+ */
+
+#ifndef RACKSPACEMAP_H
+#define RACKSPACEMAP_H
+
+#include <algorithm>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace echoconfig
+{
+    /**
+     * Bidirectional mapping between rack space numbers (the position of a SPACE element in the rack) and Echo space
+     * numbers.
+     *
+     * Both directions are kept as vectors sorted by their key.
+     */
+    class RackSpaceMap
+    {
+    public:
+        /** Rack space num, Echo space num */
+        using Entry = std::pair<unsigned int, unsigned int>;
+
+        [[nodiscard]] std::size_t size() const { return byRack_.size(); }
+        [[nodiscard]] bool empty() const { return byRack_.empty(); }
+
+        void reserve(std::size_t count)
+        {
+            byRack_.reserve(count);
+            byEcho_.reserve(count);
+        }
+
+        void clear()
+        {
+            byRack_.clear();
+            byEcho_.clear();
+        }
+
+        /**
+         * All entries, in rack space order.
+         */
+        [[nodiscard]] std::span<const Entry> entries() const { return byRack_; }
+
+        /**
+         * Get the @p ix-th entry in rack space order.
+         */
+        [[nodiscard]] const Entry& at(std::size_t ix) const { return byRack_.at(ix); }
+
+        /**
+         * Map @p rackSpaceNum to @p echoSpaceNum, replacing any existing mapping for @p rackSpaceNum.
+         */
+        void insert_or_assign(unsigned int rackSpaceNum, unsigned int echoSpaceNum)
+        {
+            auto rackIt = std::ranges::lower_bound(byRack_, rackSpaceNum, {}, &Entry::first);
+            if (rackIt != byRack_.end() && rackIt->first == rackSpaceNum)
+            {
+                eraseEcho(rackIt->second, rackSpaceNum);
+                rackIt->second = echoSpaceNum;
+            }
+            else
+            {
+                byRack_.emplace(rackIt, rackSpaceNum, echoSpaceNum);
+            }
+            const auto echoIt = std::ranges::upper_bound(byEcho_, Entry{echoSpaceNum, rackSpaceNum});
+            byEcho_.emplace(echoIt, echoSpaceNum, rackSpaceNum);
+        }
+
+        /**
+         * Get the Echo space mapped to @p rackSpaceNum.
+         */
+        [[nodiscard]] std::optional<unsigned int> echoSpace(unsigned int rackSpaceNum) const
+        {
+            const auto it = std::ranges::lower_bound(byRack_, rackSpaceNum, {}, &Entry::first);
+            if (it == byRack_.end() || it->first != rackSpaceNum)
+            {
+                return std::nullopt;
+            }
+            return it->second;
+        }
+
+        /**
+         * Get the (lowest numbered) rack space mapped to @p echoSpaceNum.
+         */
+        [[nodiscard]] std::optional<unsigned int> rackSpace(unsigned int echoSpaceNum) const
+        {
+            const auto it = std::ranges::lower_bound(byEcho_, echoSpaceNum, {}, &Entry::first);
+            if (it == byEcho_.end() || it->first != echoSpaceNum)
+            {
+                return std::nullopt;
+            }
+            return it->second;
+        }
+
+    private:
+        /** Sorted by rack space num. */
+        std::vector<Entry> byRack_;
+        /** (Echo space num, rack space num), sorted. */
+        std::vector<Entry> byEcho_;
+
+        void eraseEcho(unsigned int echoSpaceNum, unsigned int rackSpaceNum)
+        {
+            const auto it = std::ranges::lower_bound(byEcho_, Entry{echoSpaceNum, rackSpaceNum});
+            if (it != byEcho_.end() && *it == Entry{echoSpaceNum, rackSpaceNum})
+            {
+                byEcho_.erase(it);
+            }
+        }
+    };
+} // namespace echoconfig
+
+#endif // RACKSPACEMAP_H
@@ -0,0 +1,100 @@
+/**
+ * @file SheetCell.h
+ *
+ * @author Dan Keenan
+ * @date 10/17/2026
+ * @copyright GNU GPLv3
+ */
+
+#ifndef SHEETCELL_H
+#define SHEETCELL_H
+
+#include <QString>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace echoconfig
+{
+    /**
+     * A cell value read from a spreadsheet or table.
+     */
+    struct SheetCell
+    {
+        enum class Type
+        {
+            Number,
+            String,
+            Boolean,
+            Error,
+        };
+
+        /** 1-based column number. */
+        int col;
+        Type type;
+        /** Value of Number and Boolean cells. */
+        double number = 0;
+        /** Value of String and Error cells. */
+        QString text;
+    };
+
+    /**
+     * The cells with values in one row of a sheet, found by column.
+     */
+    class SheetRow
+    {
+    public:
+        /** Excel's limit, which tables in other formats keep to as well. */
+        static constexpr int kMaxColumns = 16384;
+
+        /** Cells with values, in the order they were added. */
+        [[nodiscard]] std::span<const SheetCell> cells() const { return cells_; }
+
+        [[nodiscard]] bool empty() const { return cells_.empty(); }
+
+        /**
+         * Get the cell at @p col (1-based).
+         * @return The cell, or nullptr if it has no value.
+         */
+        [[nodiscard]] const SheetCell* cell(int col) const
+        {
+            if (col < 0 || static_cast<std::size_t>(col) >= colIxs_.size() || colIxs_[col] < 0)
+            {
+                return nullptr;
+            }
+            return &cells_[colIxs_[col]];
+        }
+
+        /**
+         * Add @p cell, replacing any cell already in its column for lookups.
+         * @return The added cell.
+         */
+        SheetCell& add(SheetCell&& cell)
+        {
+            const auto col = cell.col;
+            if (static_cast<std::size_t>(col) >= colIxs_.size())
+            {
+                colIxs_.resize(col + 1, -1);
+            }
+            colIxs_[col] = static_cast<int>(cells_.size());
+            return cells_.emplace_back(std::move(cell));
+        }
+
+        /** Remove every cell, keeping the storage for the next row. */
+        void clear()
+        {
+            for (const auto& cell : cells_)
+            {
+                colIxs_[cell.col] = -1;
+            }
+            cells_.clear();
+        }
+
+    private:
+        std::vector<SheetCell> cells_;
+        /** Index into cells_ for each column, or -1. */
+        std::vector<int> colIxs_;
+    };
+} // namespace echoconfig
+
+#endif // SHEETCELL_H
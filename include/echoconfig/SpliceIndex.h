@@ -0,0 +1,63 @@
+/**
+ * @file SpliceIndex.h
+ *
+ * @author Dan Keenan
+ * @date 10/17/2026
+ * @copyright GNU GPLv3
+ */
+
+#ifndef SPLICEINDEX_H
+#define SPLICEINDEX_H
+
+#include <QtGlobal>
+#include <cstdint>
+#include <vector>
+
+namespace echoconfig
+{
+    /**
+     * The location of an attribute value in a config file that saving may replace.
+     */
+    struct SplicePoint
+    {
+        enum class Kind : std::uint8_t
+        {
+            /** SPACE of a circuit; key is the circuit num. */
+            CircuitSpace,
+            /** ZONE of a circuit; key is the circuit num. */
+            CircuitZone,
+            /** SPACEINRACK of a space; key is the rack space num. */
+            RackSpace,
+            /** SPACEINRACKEXT of a space; key is the rack space num. */
+            RackSpaceExt,
+            /** NUMBER of a space; key is the rack space num. */
+            EchoSpace,
+            /** NUMBEREXT of a space; key is the rack space num. */
+            EchoSpaceExt,
+            /** Preset fade time; key is the rack space num. */
+            FadeTime,
+            /** Preset level; key is the circuit num. */
+            Level,
+        };
+
+        Kind kind;
+        std::uint32_t key;
+        /** Preset the value belongs to, for fade times and levels. */
+        std::uint32_t presetNum;
+        /** Offset of the raw attribute value, in bytes from the start of the file. */
+        qsizetype offset;
+        /** Length of the raw attribute value, in bytes. */
+        std::uint32_t length;
+    };
+
+    /**
+     * Every value a config owns in a config file, in document order, so a save can copy the original bytes and
+     * splice in only the values that changed.
+     */
+    struct SpliceIndex
+    {
+        std::vector<SplicePoint> points;
+    };
+} // namespace echoconfig
+
+#endif // SPLICEINDEX_H
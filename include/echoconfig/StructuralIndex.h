@@ -0,0 +1,112 @@
+/**
+ * @file StructuralIndex.h
+ *
+ * @author Dan Keenan
+ * @date 10/17/2026
+ * @copyright GNU GPLv3
+ */
+
+#ifndef STRUCTURALINDEX_H
+#define STRUCTURALINDEX_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace echoconfig
+{
+    /**
+     * Bitmaps of where the characters that structure an XML document are: tag openings and attribute quotes.
+     *
+     * The bitmaps are built in one pass over the data, 16 or 32 bytes at a time on CPUs with SSE2 or AVX2.  Finding the
+     * next tag or quote is then a bit scan instead of a search through the bytes in between.  The instruction set is
+     * picked at runtime, so one build runs on any x86 CPU; others use a scalar loop.
+     */
+    class StructuralIndex
+    {
+    public:
+        /** Instruction sets the index can be built with. */
+        enum class Isa
+        {
+            Scalar,
+            Sse2,
+            Avx2,
+        };
+
+        /** Characters the index finds. */
+        enum class Mark
+        {
+            /** `<` */
+            Tag,
+            /** `"` and `'` */
+            Quote,
+        };
+
+        StructuralIndex() = default;
+
+        /**
+         * Index @p data from @p begin to @p end with bestIsa().
+         * @param data Only used while building the index.
+         */
+        StructuralIndex(std::string_view data, std::size_t begin, std::size_t end);
+
+        /**
+         * Index @p data from @p begin to @p end with @p isa.
+         * @param data Only used while building the index.
+         * @throws std::runtime_error if this CPU doesn't support @p isa.
+         */
+        StructuralIndex(std::string_view data, std::size_t begin, std::size_t end, Isa isa);
+
+        /**
+         * Find the first @p mark at or after @p pos.
+         * @return std::string_view::npos if there are none before the end of the indexed range.
+         */
+        [[nodiscard]] std::size_t find(Mark mark, std::size_t pos) const
+        {
+            if (pos >= end_)
+            {
+                return std::string_view::npos;
+            }
+            const auto& bits = bits_[static_cast<std::size_t>(mark)];
+            const auto offset = std::max(pos, begin_) - begin_;
+            auto wordIx = offset / 64;
+            // Ignore marks before pos.
+            auto word = bits[wordIx] & (~std::uint64_t{0} << (offset % 64));
+            while (word == 0)
+            {
+                if (++wordIx >= bits.size())
+                {
+                    return std::string_view::npos;
+                }
+                word = bits[wordIx];
+            }
+            return begin_ + wordIx * 64 + static_cast<std::size_t>(std::countr_zero(word));
+        }
+
+        /** Start of the indexed range. */
+        [[nodiscard]] std::size_t begin() const { return begin_; }
+        /** End of the indexed range. */
+        [[nodiscard]] std::size_t end() const { return end_; }
+
+        /** Count the @p mark characters in the indexed range. */
+        [[nodiscard]] std::size_t count(Mark mark) const;
+
+        /** Whether this CPU can run @p isa. */
+        [[nodiscard]] static bool isSupported(Isa isa);
+
+        /** The fastest instruction set this CPU supports, detected when first called. */
+        [[nodiscard]] static Isa bestIsa();
+
+    private:
+        std::size_t begin_ = 0;
+        std::size_t end_ = 0;
+        /** For each Mark, bit n of word w is set when data[begin_ + 64 * w + n] is that mark. */
+        std::array<std::vector<std::uint64_t>, 2> bits_;
+    };
+} // namespace echoconfig
+
+#endif // STRUCTURALINDEX_H
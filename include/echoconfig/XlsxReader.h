@@ -0,0 +1,104 @@
+/**
+ * @file XlsxReader.h
+ *
+ * @author Dan Keenan
+ * @date 10/17/2026
+ * @copyright GNU GPLv3
+ */
+
+#ifndef XLSXREADER_H
+#define XLSXREADER_H
+
+#include <QString>
+#include <QStringList>
+#include <QXmlStreamReader>
+#include <memory>
+#include <span>
+#include "SheetCell.h"
+#include "ZipReader.h"
+
+namespace echoconfig
+{
+    /**
+     * Read cell values from an xlsx workbook.
+     *
+     * Opening the workbook reads only the sheet list and the shared strings table.  Use XlsxSheetReader to read the
+     * rows of a sheet.
+     *
+     * All errors cause std::runtime_error.
+     */
+    class XlsxReader
+    {
+        friend class XlsxSheetReader;
+
+    public:
+        /**
+         * @param device Open for reading and seekable.  Must outlive the reader and any sheet readers.
+         */
+        explicit XlsxReader(QIODevice* device);
+
+        [[nodiscard]] const QStringList& sheetNames() const { return sheetNames_; }
+        [[nodiscard]] bool hasSheet(const QString& name) const { return sheetNames_.contains(name); }
+
+    private:
+        ZipReader zip_;
+        QStringList sheetNames_;
+        /** Archive path of each sheet, in the same order as sheetNames_. */
+        QStringList sheetPaths_;
+        QStringList sharedStrings_;
+
+        void readSharedStrings(const QString& path);
+    };
+
+    /**
+     * Read the rows of one worksheet in order, decompressing and parsing the sheet as it goes.
+     *
+     * Only the current row is held in memory.  Rows with no values are skipped.
+     */
+    class XlsxSheetReader
+    {
+    public:
+        using Cell = SheetCell;
+        using CellType = SheetCell::Type;
+
+        /**
+         * @throws std::runtime_error if the workbook has no sheet named @p name.
+         */
+        XlsxSheetReader(const XlsxReader& workbook, const QString& name);
+
+        /**
+         * Advance to the next row with values.
+         * @return false once there are no more rows.
+         */
+        bool readRow();
+
+        /** 1-based row number of the current row. */
+        [[nodiscard]] int rowNum() const { return rowNum_; }
+
+        /** Cells with values in the current row, in column order. */
+        [[nodiscard]] std::span<const Cell> cells() const { return row_.cells(); }
+
+        /**
+         * Get the cell at @p col (1-based) in the current row.
+         * @return The cell, or nullptr if it has no value.
+         */
+        [[nodiscard]] const Cell* cell(int col) const { return row_.cell(col); }
+
+    private:
+        const XlsxReader& workbook_;
+        std::unique_ptr<QIODevice> device_;
+        QXmlStreamReader xml_;
+        int rowNum_ = 0;
+        SheetRow row_;
+        /** Reused for each value's text. */
+        QString value_;
+
+        /** @return The cell's column. */
+        int readCell(int prevCol);
+        void readValue();
+        void readInlineString();
+        [[nodiscard]] double parseNumber() const;
+    };
+} // namespace echoconfig
+
+#endif // XLSXREADER_H
@@ -0,0 +1,141 @@
+/**
+ * @file XlsxWriter.h
+ *
+ * @author Dan Keenan
+ * @date 10/17/2026
+ * @copyright GNU GPLv3
+ */
+
+#ifndef XLSXWRITER_H
+#define XLSXWRITER_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+#include "ZipWriter.h"
+
+namespace echoconfig
+{
+    class XlsxWriter;
+
+    /**
+     * Write the rows of one worksheet.  Get one from XlsxWriter::addSheet().
+     *
+     * Usage: for each row beginRow(), write cells in column order, endRow(); then end().
+     *
+     * Different sheets of the same workbook may be written on different threads at the same time.
+     */
+    class XlsxSheetWriter
+    {
+        friend class XlsxWriter;
+
+    public:
+        XlsxSheetWriter(const XlsxSheetWriter&) = delete;
+        XlsxSheetWriter& operator=(const XlsxSheetWriter&) = delete;
+
+        void beginRow();
+        void endRow();
+
+        /**
+         * Write a string to column @p col (1-based) of the current row.
+         */
+        void writeString(int col, const QString& value);
+
+        /**
+         * Write a number to column @p col (1-based) of the current row.
+         */
+        void writeNumber(int col, unsigned int value);
+
+        /**
+         * End the sheet.  Nothing more may be written to it afterwards.
+         */
+        void end();
+
+    private:
+        XlsxWriter& workbook_;
+        /** Sheets are compressed straight into the archive when possible, otherwise into memory. */
+        std::optional<ZipWriter::Compressor> compressor_;
+        /** Sheet XML not yet compressed. */
+        QByteArray buffer_;
+        int row_ = 0;
+        bool ended_ = false;
+
+        XlsxSheetWriter(XlsxWriter& workbook, bool direct, int rowCount, int columnCount);
+        void writeCellRef(int col);
+        void flush(bool force);
+    };
+
+    /**
+     * Write a plain xlsx workbook row by row, without building the workbook in memory.
+     *
+     * Each worksheet's XML is compressed as its rows are written.  The first sheet open at a time goes straight into
+     * the file; sheets added while another is open are compressed in memory and added to the file by finish().  Only
+     * the text of string cells is kept until finish(), for the shared strings table.  Cells have no formatting.
+     *
+     * Usage: addSheet() for each sheet and write its rows, then finish().
+     *
+     * All errors cause std::runtime_error.
+     */
+    class XlsxWriter
+    {
+        friend class XlsxSheetWriter;
+
+    public:
+        /**
+         * @param device Open for writing.  Must outlive the writer.
+         * @param options How to compress the parts of the workbook.
+         */
+        explicit XlsxWriter(QIODevice* device, const ZipOptions& options = {});
+
+        /**
+         * Start a new worksheet.
+         *
+         * Don't call this while sheets are being written on other threads.
+         *
+         * Strings are numbered in the order they are first written.  For the file to be the same each time, write
+         * strings on one thread at a time in a fixed order (e.g. all headers before any sheet's values).
+         *
+         * @param name Sheet name, as shown on its tab.
+         * @param rowCount Number of rows that will be written.
+         * @param columnCount Number of columns, including empty ones.
+         * @return The sheet, which is owned by this writer.
+         */
+        XlsxSheetWriter& addSheet(const QString& name, int rowCount, int columnCount);
+
+        /**
+         * End any open sheets and write the workbook parts that refer to them.  Nothing more may be written
+         * afterwards, and the sheets are destroyed.
+         *
+         * Don't call this while sheets are being written on other threads.
+         */
+        void finish();
+
+        /**
+         * Get the column letters for @p col (1-based), e.g. 1 is "A" and 27 is "AA".
+         */
+        [[nodiscard]] static QByteArray columnName(int col);
+
+    private:
+        ZipWriter zip_;
+        QStringList sheetNames_;
+        std::vector<std::unique_ptr<XlsxSheetWriter>> sheets_;
+        /** The sheet being compressed straight into zip_. */
+        XlsxSheetWriter* directSheet_ = nullptr;
+        /** Guards the shared strings. */
+        std::mutex stringsMutex_;
+        QStringList strings_;
+        QHash<QString, int> stringIxs_;
+        int stringRefs_ = 0;
+        bool finished_ = false;
+
+        [[nodiscard]] int stringIndex(const QString& value);
+        [[nodiscard]] static QString sheetPath(int sheetNum);
+    };
+} // namespace echoconfig
+
+#endif // XLSXWRITER_H
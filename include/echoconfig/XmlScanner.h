@@ -0,0 +1,139 @@
+/**
+ * @file XmlScanner.h
+ *
+ * @author Dan Keenan
+ * @date 10/17/2026
+ * @copyright GNU GPLv3
+ */
+
+#ifndef XMLSCANNER_H
+#define XMLSCANNER_H
+
+#include <QString>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "echoconfig/StructuralIndex.h"
+
+namespace echoconfig
+{
+    /**
+     * A minimal XML scanner that works directly on UTF-8 bytes.
+     *
+     * Only start elements and their attributes are reported; text, comments, and processing instructions are skipped.
+     * Names and raw attribute values are views into the scanned data, so nothing is allocated per element.  Tags and
+     * attribute values are found through a StructuralIndex built up front, instead of searching the bytes between.  The
+     * document structure (nesting, a single root element, quoting) is checked, but it is not a validating parser.
+     *
+     * Malformed documents cause std::runtime_error("Failed to read file"), matching what the config parsers report
+     * when QXmlStreamReader fails.
+     */
+    class XmlScanner
+    {
+    public:
+        struct Attribute
+        {
+            std::string_view name;
+            /** As written in the document, without entity decoding or whitespace normalization. */
+            std::string_view rawValue;
+        };
+
+        /**
+         * @param data UTF-8 encoded document.  Must outlive the scanner.
+         * @param index Where the tags and quotes in @p data are, if already known.  Built by the scanner otherwise.
+         */
+        explicit XmlScanner(std::string_view data, std::shared_ptr<const StructuralIndex> index = nullptr);
+
+        /**
+         * Scan part of a document, so pieces of one document can be scanned at the same time.
+         *
+         * Scanning stops at @p end as if it were the end of the document, without checking that every element has been
+         * closed; compare openElements() with what the next piece starts with instead.  A piece that ends at the end of
+         * @p data is checked like a whole document.
+         *
+         * @param data UTF-8 encoded document.  Must outlive the scanner.
+         * @param begin Where the piece starts, outside of any markup.
+         * @param end Where the piece ends, outside of any markup.
+         * @param openElements The elements open at @p begin, outermost first.
+         * @param index Where the tags and quotes in @p data are, from at most @p begin to at least @p end.  Pieces of
+         *     one document can share an index of all of it.  Built by the scanner if not given.
+         */
+        XmlScanner(std::string_view data, std::size_t begin, std::size_t end,
+                   std::vector<std::string_view> openElements, std::shared_ptr<const StructuralIndex> index = nullptr);
+
+        /**
+         * Advance to the next start element.
+         * @return false once the end of the document has been reached.
+         * @throws std::runtime_error if the document is malformed.
+         */
+        bool readNextStartElement();
+
+        [[nodiscard]] std::string_view name() const { return name_; }
+        [[nodiscard]] const std::vector<Attribute>& attributes() const { return attributes_; }
+        [[nodiscard]] bool hasAttribute(std::string_view name) const { return rawAttribute(name).has_value(); }
+        [[nodiscard]] std::optional<std::string_view> rawAttribute(std::string_view name) const;
+
+        /** Elements open at the current position, outermost first. */
+        [[nodiscard]] const std::vector<std::string_view>& openElements() const { return openElements_; }
+
+        /**
+         * Get the decoded value of an attribute, or an empty string if it is not set (like QXmlStreamAttributes).
+         * @throws std::runtime_error if the value contains a bad entity reference.
+         */
+        [[nodiscard]] QString attribute(std::string_view name) const;
+
+        /**
+         * Get an unsigned int from the attribute @p name.  Accepts the same input as QString::toUInt().
+         * @throws std::runtime_error if the attribute is missing or is not a UInt.
+         */
+        [[nodiscard]] unsigned int requiredAttrUInt(std::string_view name) const;
+
+        /**
+         * Decode entity and character references and normalize whitespace, as an XML parser does.
+         * @throws std::runtime_error if @p rawValue contains a bad entity reference.
+         */
+        [[nodiscard]] static QString decodeAttrValue(std::string_view rawValue);
+
+        /**
+         * Check that @p data can be scanned: it has no UTF-16 byte order mark and its XML declaration (if any) does
+         * not declare an encoding other than UTF-8 or ASCII.
+         */
+        [[nodiscard]] static bool isUtf8Document(std::string_view data);
+
+        /**
+         * Find the value of the encoding declared in the XML declaration of @p data.
+         * @return The offset and length of the value, or std::nullopt if no encoding is declared.
+         */
+        [[nodiscard]] static std::optional<std::pair<std::size_t, std::size_t>> declaredEncoding(std::string_view data);
+
+    private:
+        std::string_view data_;
+        std::size_t pos_ = 0;
+        /** Where the tags and quotes between the start of the scan and the end of data_ are.  May extend past data_. */
+        std::shared_ptr<const StructuralIndex> index_;
+        std::string_view name_;
+        /** Reused between elements to avoid allocation. */
+        std::vector<Attribute> attributes_;
+        std::vector<std::string_view> openElements_;
+        bool seenRoot_ = false;
+        /** Whether the end of data_ is the end of the document. */
+        bool endsDocument_ = true;
+
+        /** Find the next @p mark in data_ at or after @p pos. */
+        [[nodiscard]] std::size_t find(StructuralIndex::Mark mark, std::size_t pos) const
+        {
+            const auto found = index_->find(mark, pos);
+            return found < data_.size() ? found : std::string_view::npos;
+        }
+
+        void skipPast(std::string_view terminator);
+        void skipDoctype();
+        void skipSpace();
+        void readEndTag();
+        void readStartTag();
+    };
+} // namespace echoconfig
+
+#endif // XMLSCANNER_H
@@ -0,0 +1,73 @@
+/**
+ * @file ZipReader.h
+ *
+ * @author Dan Keenan
+ * @date 10/17/2026
+ * @copyright GNU GPLv3
+ */
+
+#ifndef ZIPREADER_H
+#define ZIPREADER_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QtGlobal>
+#include <memory>
+#include <mutex>
+
+class QIODevice;
+
+namespace echoconfig
+{
+    /**
+     * Read files from a zip archive, decompressing them as they are read.
+     *
+     * Only the archive directory is read up front.  Stored and deflated files are supported; ZIP64 and encryption are
+     * not.
+     *
+     * Devices opened from the same reader may be read on different threads at the same time.
+     *
+     * All errors cause std::runtime_error.
+     */
+    class ZipReader
+    {
+    public:
+        /**
+         * @param device Open for reading and seekable.  Must outlive the reader and any devices it opens.
+         */
+        explicit ZipReader(QIODevice* device);
+
+        [[nodiscard]] bool contains(const QString& name) const { return entries_.contains(name); }
+
+        /**
+         * Open the file @p name for reading.
+         *
+         * The returned device is sequential and decompresses on demand, so the file is never held in memory.  Reading
+         * fails if the data does not match its checksum.
+         */
+        [[nodiscard]] std::unique_ptr<QIODevice> open(const QString& name) const;
+
+        /**
+         * Read all of the file @p name.
+         */
+        [[nodiscard]] QByteArray read(const QString& name) const;
+
+    private:
+        struct Entry
+        {
+            quint16 method;
+            quint32 crc;
+            qint64 compressedSize;
+            qint64 size;
+            qint64 headerOffset;
+        };
+
+        QIODevice* device_;
+        /** Guards device_, which every opened file reads from. */
+        mutable std::mutex deviceMutex_;
+        QHash<QString, Entry> entries_;
+    };
+} // namespace echoconfig
+
+#endif // ZIPREADER_H
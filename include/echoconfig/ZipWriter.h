@@ -0,0 +1,170 @@
+/**
+ * @file ZipWriter.h
+ *
+ * @author Dan Keenan
+ * @date 10/17/2026
+ * @copyright GNU GPLv3
+ */
+
+#ifndef ZIPWRITER_H
+#define ZIPWRITER_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QString>
+#include <QtGlobal>
+#include <memory>
+#include <optional>
+#include <vector>
+
+class QIODevice;
+
+namespace echoconfig
+{
+    /**
+     * How hard to compress files in a zip archive.
+     */
+    enum class CompressionLevel
+    {
+        /** Don't compress at all.  Fastest, for files that are thrown away soon after. */
+        Store,
+        /** Compress quickly, at some cost in size. */
+        Fast,
+        /** zlib's default balance of speed and size. */
+        Default,
+    };
+
+    /**
+     * Options for ZipWriter.
+     */
+    struct ZipOptions
+    {
+        CompressionLevel level = CompressionLevel::Default;
+        /**
+         * Compress each file in independent blocks on the global thread pool, like pigz.  The result is an ordinary
+         * deflate stream that any reader can open; it is slightly larger than compressing on one thread.
+         */
+        bool parallel = false;
+    };
+
+    /**
+     * Write a zip archive one file at a time, compressing data as it is written.
+     *
+     * Sizes and checksums are written after each file's data, so the device does not need to be seekable and file
+     * contents never need to be held in memory.  ZIP64 is not supported, so the archive must be smaller than 4 GiB.
+     *
+     * All errors cause std::runtime_error.
+     */
+    class ZipWriter
+    {
+        class Deflater;
+
+        struct Entry
+        {
+            QByteArray name;
+            quint16 method = 0;
+            quint32 crc = 0;
+            qint64 compressedSize = 0;
+            qint64 size = 0;
+            qint64 offset = 0;
+        };
+
+    public:
+        /**
+         * Compress one file's data in memory, to be added to an archive later with addCompressed().
+         *
+         * Compressors are independent of each other and of the archive, so several files can be compressed on
+         * different threads while the archive is being written.
+         */
+        class Compressor
+        {
+        public:
+            explicit Compressor(const ZipOptions& options = {});
+            ~Compressor();
+            Compressor(const Compressor&) = delete;
+            Compressor& operator=(const Compressor&) = delete;
+
+            /**
+             * Append @p data to the file.
+             */
+            void write(QByteArrayView data);
+
+            /**
+             * End the file.  Nothing more may be written afterwards.
+             */
+            void finish();
+
+            [[nodiscard]] bool isFinished() const { return finished_; }
+
+        private:
+            friend class ZipWriter;
+
+            std::unique_ptr<Deflater> deflater_;
+            QByteArray compressed_;
+            /** Method, CRC, and size of the data. */
+            Entry entry_;
+            bool finished_ = false;
+        };
+
+        /**
+         * @param device Open for writing.  Must outlive the writer.
+         * @param options
+         */
+        explicit ZipWriter(QIODevice* device, const ZipOptions& options = {});
+        ~ZipWriter();
+        ZipWriter(const ZipWriter&) = delete;
+        ZipWriter& operator=(const ZipWriter&) = delete;
+
+        [[nodiscard]] const ZipOptions& options() const { return options_; }
+
+        /**
+         * Start a new file in the archive, ending the current one.
+         * @param name Path of the file inside the archive.
+         */
+        void beginFile(const QString& name);
+
+        /**
+         * Append @p data to the current file.
+         */
+        void write(QByteArrayView data);
+
+        /**
+         * End the current file, if there is one.
+         */
+        void endFile();
+
+        /**
+         * Convenience to write a whole file at once.
+         */
+        void addFile(const QString& name, QByteArrayView data);
+
+        /**
+         * Add a file compressed by @p compressor, ending the current one.
+         * @param name Path of the file inside the archive.
+         * @param compressor Must be finished.
+         */
+        void addCompressed(const QString& name, const Compressor& compressor);
+
+        /**
+         * End the current file and write the archive directory.  Nothing more may be written afterwards.
+         */
+        void finish();
+
+    private:
+        QIODevice* device_;
+        ZipOptions options_;
+        std::unique_ptr<Deflater> deflater_;
+        std::vector<Entry> entries_;
+        std::optional<Entry> current_;
+        qint64 offset_ = 0;
+        quint16 dosTime_;
+        quint16 dosDate_;
+        bool finished_ = false;
+
+        void writeLocalHeader(const Entry& entry);
+        void writeDescriptor(const Entry& entry);
+        void writeRaw(QByteArrayView data);
+    };
+} // namespace echoconfig
+
+#endif // ZIPWRITER_H
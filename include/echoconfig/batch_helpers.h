@@ -0,0 +1,47 @@
+/**
+ * @file batch_helpers.h
+ *
+ * @author Dan Keenan
+ * @date 10/17/2026
+ * @copyright GNU GPLv3
+ */
+
+#ifndef BATCH_HELPERS_H
+#define BATCH_HELPERS_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <utility>
+
+namespace echoconfig::batch_helpers
+{
+    /**
+     * Run @p fn and store how long it took in @p elapsed.
+     *
+     * @p elapsed is left alone if @p fn throws.
+     *
+     * @param elapsed
+     * @param fn
+     */
+    template <typename Fn>
+    void timed(std::chrono::nanoseconds& elapsed, Fn&& fn)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        std::forward<Fn>(fn)();
+        elapsed = std::chrono::steady_clock::now() - start;
+    }
+
+    /**
+     * Count the @p results that are not ok.
+     *
+     * @param results Items with an `ok` member.
+     */
+    template <typename Results>
+    [[nodiscard]] std::size_t failedCount(const Results& results)
+    {
+        return std::ranges::count_if(results, [](const auto& result) { return !result.ok; });
+    }
+} // namespace echoconfig::batch_helpers
+
+#endif // BATCH_HELPERS_H
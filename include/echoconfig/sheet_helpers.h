@@ -9,19 +9,39 @@
 #ifndef SHEET_HELPERS_H
 #define SHEET_HELPERS_H
 
-#include <xlsxdocument.h>
+#include <QByteArrayView>
+#include <QString>
+#include <QStringView>
+#include <optional>
+#include "SheetCell.h"
 
 namespace echoconfig::sheet_helpers
 {
     /**
-     * Get an unsigned int from @p doc at @p row @p col
-     * @param doc
-     * @param row
-     * @param col
+     * Get the text of @p cell, as a spreadsheet program would show it.
+     * @param cell
+     * @return The text, or an empty string if @p cell is nullptr.
+     */
+    QString cellText(const SheetCell* cell);
+
+    /**
+     * Get an unsigned int from @p cell
+     * @param cell
      * @return
      * @throws std::runtime_error if the value does not exist or cannot be converted to unsigned int.
      */
-    unsigned int requiredCellUInt(const QXlsx::Document* doc, int row, int col);
+    unsigned int requiredCellUInt(const SheetCell* cell);
+
+    /**
+     * Parse @p text if it is a short run of digits, without a general-purpose parser.
+     *
+     * Most values in a sheet are small integers, so readers try this first.
+     *
+     * @param text
+     * @return The value, or std::nullopt if @p text is empty, too long, or not only digits.
+     */
+    [[nodiscard]] std::optional<double> parseDigits(QStringView text);
+    [[nodiscard]] std::optional<double> parseDigits(QByteArrayView text);
 } // namespace echoconfig::sheet_helpers
 
 #endif // SHEET_HELPERS_H
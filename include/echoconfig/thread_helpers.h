@@ -0,0 +1,73 @@
+/**
+ * @file thread_helpers.h
+ *
+ * @author Dan Keenan
+ * @date 10/17/2026
+ * @copyright GNU GPLv3
+ */
+
+#ifndef THREAD_HELPERS_H
+#define THREAD_HELPERS_H
+
+#include <QThreadPool>
+#include <concepts>
+#include <exception>
+#include <future>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace echoconfig::thread_helpers
+{
+    /**
+     * Run @p fn on the global thread pool.
+     *
+     * If the pool has no free thread, @p fn is run on this thread before returning, so waiting on the result can
+     * never deadlock, even from a pool thread.
+     *
+     * @param fn
+     * @return The result of @p fn, including any exception it throws.
+     */
+    template <std::invocable Fn>
+    [[nodiscard]] std::future<std::invoke_result_t<Fn>> runAsync(Fn&& fn)
+    {
+        auto task = std::make_shared<std::packaged_task<std::invoke_result_t<Fn>()>>(std::forward<Fn>(fn));
+        auto result = task->get_future();
+        if (!QThreadPool::globalInstance()->tryStart([task]() { (*task)(); }))
+        {
+            (*task)();
+        }
+        return result;
+    }
+
+    /**
+     * Run @p first on the global thread pool and @p second on this thread, and wait for both.
+     *
+     * Exceptions are rethrown once both have finished, so neither outlives anything the other uses.  If both throw,
+     * the exception from @p first is rethrown.
+     *
+     * @param first
+     * @param second
+     */
+    template <std::invocable First, std::invocable Second>
+    void parallelInvoke(First&& first, Second&& second)
+    {
+        auto firstResult = runAsync(std::forward<First>(first));
+        std::exception_ptr secondError;
+        try
+        {
+            std::forward<Second>(second)();
+        }
+        catch (...)
+        {
+            secondError = std::current_exception();
+        }
+        firstResult.get();
+        if (secondError)
+        {
+            std::rethrow_exception(secondError);
+        }
+    }
+} // namespace echoconfig::thread_helpers
+
+#endif // THREAD_HELPERS_H
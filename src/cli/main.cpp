@@ -0,0 +1,585 @@
+/**
+ * @file main.cpp
+ *
+ * @author Dan Keenan
+ * @date 10/17/2026
+ * @copyright GNU GPLv3
+ */
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+#include <array>
+#include <chrono>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+#include "echoblind_config.h"
+#include "echoconfig/BatchRunner.h"
+#include "echoconfig/BlockIo.h"
+#include "echoconfig/Config.h"
+#include "echoconfig/ConfigCache.h"
+#include "echoconfig/ConfigServer.h"
+#include "echoconfig/FanOut.h"
+
+using echoconfig::Config;
+
+namespace
+{
+    /**
+     * Times the steps of a command, for --json.
+     */
+    class StepTimer
+    {
+    public:
+        StepTimer()
+        {
+            total_.start();
+            step_.start();
+        }
+
+        /**
+         * Record the time since the last step finished as @p step.
+         */
+        void finish(const QString& step)
+        {
+            steps_.insert(step, msOf(step_.nsecsElapsed()));
+            step_.restart();
+        }
+
+        [[nodiscard]] QJsonObject toJson() const
+        {
+            auto timings = steps_;
+            timings.insert(QStringLiteral("total"), msOf(total_.nsecsElapsed()));
+            return timings;
+        }
+
+    private:
+        QElapsedTimer total_;
+        QElapsedTimer step_;
+        QJsonObject steps_;
+
+        static double msOf(qint64 ns) { return static_cast<double>(ns) / 1e6; }
+    };
+
+    /**
+     * Everything a command needs.
+     */
+    struct Context
+    {
+        const QCommandLineParser& parser;
+        /** Positional arguments after the command name. */
+        QStringList args;
+        echoconfig::ParseOptions parseOptions;
+        echoconfig::SheetOptions sheetOptions;
+        StepTimer timer;
+        /** How long loading and saving waited for their files, reported with --json. */
+        echoconfig::IoStats readStats;
+        echoconfig::IoStats writeStats;
+        /** Reported with --json. */
+        QJsonObject result;
+        /** Printed without --json. */
+        QString text;
+        /** Set by commands that report their own errors but should still exit with an error. */
+        bool failed = false;
+    };
+
+    struct Command
+    {
+        QString name;
+        QString synopsis;
+        QString description;
+        qsizetype argCount;
+        /** Throws on error. */
+        void (*run)(Context& ctx);
+    };
+
+    bool isCfgPath(const QString& path)
+    {
+        const auto suffix = QFileInfo(path).suffix().toLower();
+        return suffix == QStringLiteral("cfg") || suffix == QStringLiteral("eacp");
+    }
+
+    std::unique_ptr<Config> loadCfg(Context& ctx, const QString& path)
+    {
+        auto parseOptions = ctx.parseOptions;
+        parseOptions.ioStats = &ctx.readStats;
+        std::unique_ptr<Config> config;
+        try
+        {
+            config = Config::loadCfgOrThrow(path, parseOptions);
+        }
+        catch (const std::exception& e)
+        {
+            const auto message =
+                QStringLiteral("Could not load config file %1: %2").arg(path, QString::fromUtf8(e.what()));
+            throw std::runtime_error(message.toStdString());
+        }
+        // Saving splits up the same way parsing does.
+        config->setSaveOptions({.threadCount = ctx.parseOptions.threadCount, .ioStats = &ctx.writeStats});
+        ctx.timer.finish(QStringLiteral("loadCfg"));
+        return config;
+    }
+
+    void parseSheet(Context& ctx, Config& config, const QString& path)
+    {
+        config.parseSheet(path);
+        ctx.timer.finish(QStringLiteral("parseSheet"));
+    }
+
+    void saveSheet(Context& ctx, const Config& config, const QString& path)
+    {
+        config.saveSheet(path, ctx.sheetOptions);
+        ctx.timer.finish(QStringLiteral("saveSheet"));
+    }
+
+    void saveCfg(Context& ctx, const Config& config, const QString& basePath, const QString& outPath)
+    {
+        config.saveCfg(basePath, outPath);
+        ctx.timer.finish(QStringLiteral("saveCfg"));
+    }
+
+    void runInfo(Context& ctx)
+    {
+        const auto config = loadCfg(ctx, ctx.args[0]);
+        ctx.result.insert(QStringLiteral("type"), config->panelType());
+        ctx.result.insert(QStringLiteral("name"), config->panelName());
+        ctx.result.insert(QStringLiteral("circuits"), static_cast<qint64>(config->circuitCount()));
+        ctx.result.insert(QStringLiteral("spaces"), static_cast<qint64>(config->spaceCount()));
+        ctx.result.insert(QStringLiteral("presets"), static_cast<qint64>(config->presetCount()));
+        QTextStream(&ctx.text) << "Type: " << config->panelType() << "\n"
+                               << "Name: " << config->panelName() << "\n"
+                               << "Circuits: " << config->circuitCount() << "\n"
+                               << "Spaces: " << config->spaceCount() << "\n"
+                               << "Presets: " << config->presetCount() << "\n";
+    }
+
+    void runExportSheet(Context& ctx)
+    {
+        const auto config = loadCfg(ctx, ctx.args[0]);
+        saveSheet(ctx, *config, ctx.args[1]);
+    }
+
+    void runImportSheet(Context& ctx)
+    {
+        const auto& basePath = ctx.args[0];
+        const auto config = loadCfg(ctx, basePath);
+        parseSheet(ctx, *config, ctx.args[1]);
+        saveCfg(ctx, *config, basePath, ctx.args[2]);
+    }
+
+    void runConvert(Context& ctx)
+    {
+        const auto& inPath = ctx.args[0];
+        const auto& outPath = ctx.args[1];
+        const auto basePath = ctx.parser.value(QStringLiteral("base"));
+        std::unique_ptr<Config> config;
+        QString configPath;
+        if (Config::sniffCfg(inPath).has_value())
+        {
+            configPath = inPath;
+            config = loadCfg(ctx, configPath);
+        }
+        else
+        {
+            // Sheets only hold values; the rest comes from the base config.
+            if (basePath.isEmpty())
+            {
+                throw std::runtime_error("Converting a sheet needs --base");
+            }
+            configPath = basePath;
+            config = loadCfg(ctx, configPath);
+            parseSheet(ctx, *config, inPath);
+        }
+
+        if (isCfgPath(outPath))
+        {
+            saveCfg(ctx, *config, configPath, outPath);
+        }
+        else
+        {
+            saveSheet(ctx, *config, outPath);
+        }
+    }
+
+    /**
+     * Read a job list: one job per line, with tab-separated fields.
+     *
+     *     export  <cfg>  <sheet>
+     *     import  <base-cfg>  <sheet>  <out-cfg>
+     *
+     * Blank lines and lines starting with # are skipped.  Relative paths are relative to the list.
+     */
+    std::vector<echoconfig::BatchRunner::Job> readJobList(const QString& path)
+    {
+        using Operation = echoconfig::BatchRunner::Operation;
+
+        QFile f(path);
+        if (!f.open(QIODevice::ReadOnly | QIODevice::Text))
+        {
+            throw std::runtime_error(QStringLiteral("Could not read job list %1").arg(path).toStdString());
+        }
+        const auto listDir = QFileInfo(path).absoluteDir();
+        std::vector<echoconfig::BatchRunner::Job> jobs;
+        QTextStream in(&f);
+        for (unsigned int lineNum = 1; !in.atEnd(); ++lineNum)
+        {
+            const auto line = in.readLine();
+            if (line.trimmed().isEmpty() || line.startsWith(u'#'))
+            {
+                continue;
+            }
+            const auto fields = line.split(u'\t');
+            if (fields[0] == QStringLiteral("export") && fields.size() == 3)
+            {
+                jobs.push_back({
+                    .operation = Operation::ExportSheet,
+                    .cfgPath = listDir.filePath(fields[1]),
+                    .sheetPath = listDir.filePath(fields[2]),
+                });
+            }
+            else if (fields[0] == QStringLiteral("import") && fields.size() == 4)
+            {
+                jobs.push_back({
+                    .operation = Operation::ImportSheet,
+                    .cfgPath = listDir.filePath(fields[1]),
+                    .sheetPath = listDir.filePath(fields[2]),
+                    .outPath = listDir.filePath(fields[3]),
+                });
+            }
+            else
+            {
+                const auto message = QStringLiteral("Bad job on line %1 of %2").arg(QString::number(lineNum), path);
+                throw std::runtime_error(message.toStdString());
+            }
+        }
+        return jobs;
+    }
+
+    double msOf(std::chrono::nanoseconds ns) { return static_cast<double>(ns.count()) / 1e6; }
+
+    void runBatch(Context& ctx)
+    {
+        const auto jobs = readJobList(ctx.args[0]);
+        ctx.timer.finish(QStringLiteral("readJobList"));
+
+        bool ok = false;
+        const auto threadCount = ctx.parser.value(QStringLiteral("threads")).toUInt(&ok);
+        if (!ok)
+        {
+            throw std::runtime_error("Invalid value for --threads");
+        }
+        // Jobs already run in parallel, so each one parses on its own thread.
+        auto parseOptions = ctx.parseOptions;
+        parseOptions.threadCount = 1;
+        const echoconfig::BatchRunner runner({
+            .threadCount = threadCount,
+            .parseOptions = parseOptions,
+            .sheetOptions = ctx.sheetOptions,
+        });
+        const auto report = runner.run(jobs);
+        ctx.timer.finish(QStringLiteral("run"));
+
+        QJsonArray results;
+        QTextStream text(&ctx.text);
+        for (std::size_t ix = 0; ix < jobs.size(); ++ix)
+        {
+            const auto& job = jobs[ix];
+            const auto& result = report.results[ix];
+            const auto& timings = result.timings;
+            QJsonObject jsonResult{
+                {QStringLiteral("cfg"), job.cfgPath},
+                {QStringLiteral("sheet"), job.sheetPath},
+                {QStringLiteral("ok"), result.ok},
+                {QStringLiteral("worker"), static_cast<qint64>(result.worker)},
+                {QStringLiteral("timings"),
+                 QJsonObject{
+                     {QStringLiteral("parseCfg"), msOf(timings.parseCfg)},
+                     {QStringLiteral("parseSheet"), msOf(timings.parseSheet)},
+                     {QStringLiteral("saveSheet"), msOf(timings.saveSheet)},
+                     {QStringLiteral("saveCfg"), msOf(timings.saveCfg)},
+                     {QStringLiteral("total"), msOf(timings.total)},
+                 }},
+            };
+            if (!job.outPath.isEmpty())
+            {
+                jsonResult.insert(QStringLiteral("out"), job.outPath);
+            }
+            if (!result.ok)
+            {
+                jsonResult.insert(QStringLiteral("error"), result.error);
+                text << job.cfgPath << ": " << result.error << "\n";
+            }
+            results.append(jsonResult);
+        }
+        text << jobs.size() - report.failedCount() << " of " << jobs.size() << " jobs succeeded on "
+             << report.threadCount << " threads in " << msOf(report.wallTime) << " ms\n";
+        ctx.result.insert(QStringLiteral("jobs"), results);
+        ctx.result.insert(QStringLiteral("threads"), static_cast<qint64>(report.threadCount));
+        ctx.result.insert(QStringLiteral("steals"), static_cast<qint64>(report.steals));
+        ctx.result.insert(QStringLiteral("failed"), static_cast<qint64>(report.failedCount()));
+        if (report.failedCount() > 0)
+        {
+            // Reported per job above.
+            ctx.failed = true;
+        }
+    }
+
+    void runFanOut(Context& ctx)
+    {
+        bool ok = false;
+        const auto threadCount = ctx.parser.value(QStringLiteral("threads")).toUInt(&ok);
+        if (!ok)
+        {
+            throw std::runtime_error("Invalid value for --threads");
+        }
+        const echoconfig::FanOut fanOut(ctx.args[0]);
+        ctx.timer.finish(QStringLiteral("loadCfg"));
+        const auto report = fanOut.run(ctx.args[1], ctx.args[2], {.threadCount = threadCount});
+        ctx.timer.finish(QStringLiteral("run"));
+
+        QJsonArray results;
+        QTextStream text(&ctx.text);
+        for (const auto& result : report.results)
+        {
+            QJsonObject jsonResult{
+                {QStringLiteral("rack"), result.rack},
+                {QStringLiteral("out"), result.outPath},
+                {QStringLiteral("ok"), result.ok},
+                {QStringLiteral("timings"),
+                 QJsonObject{
+                     {QStringLiteral("parseSheets"), msOf(result.parseSheets)},
+                     {QStringLiteral("saveCfg"), msOf(result.saveCfg)},
+                 }},
+            };
+            if (!result.ok)
+            {
+                jsonResult.insert(QStringLiteral("error"), result.error);
+                text << result.rack << ": " << result.error << "\n";
+            }
+            results.append(jsonResult);
+        }
+        text << report.results.size() - report.failedCount() << " of " << report.results.size()
+             << " racks saved on " << report.threadCount << " threads in " << msOf(report.wallTime) << " ms\n";
+        ctx.result.insert(QStringLiteral("racks"), results);
+        ctx.result.insert(QStringLiteral("threads"), static_cast<qint64>(report.threadCount));
+        ctx.result.insert(QStringLiteral("failed"), static_cast<qint64>(report.failedCount()));
+        ctx.failed = report.failedCount() > 0;
+    }
+
+    void runServe(Context& ctx)
+    {
+        bool ok = false;
+        const auto threadCount = ctx.parser.value(QStringLiteral("threads")).toUInt(&ok);
+        if (!ok)
+        {
+            throw std::runtime_error("Invalid value for --threads");
+        }
+        echoconfig::ConfigServer server({.threadCount = threadCount});
+        if (!server.listen(ctx.args[0]))
+        {
+            throw std::runtime_error(server.errorString().toStdString());
+        }
+        QTextStream(stderr) << "Listening on " << server.fullServerName() << "\n";
+        // Runs until killed.
+        QCoreApplication::exec();
+    }
+
+    const std::array kCommands{
+        Command{
+            .name = QStringLiteral("info"),
+            .synopsis = QStringLiteral("info <cfg>"),
+            .description = QStringLiteral("Describe a config file."),
+            .argCount = 1,
+            .run = runInfo,
+        },
+        Command{
+            .name = QStringLiteral("export-sheet"),
+            .synopsis = QStringLiteral("export-sheet <cfg> <sheet>"),
+            .description = QStringLiteral("Write the values in a config file to a sheet."),
+            .argCount = 2,
+            .run = runExportSheet,
+        },
+        Command{
+            .name = QStringLiteral("import-sheet"),
+            .synopsis = QStringLiteral("import-sheet <base-cfg> <sheet> <out-cfg>"),
+            .description = QStringLiteral("Write a copy of a config file with the values from a sheet."),
+            .argCount = 3,
+            .run = runImportSheet,
+        },
+        Command{
+            .name = QStringLiteral("convert"),
+            .synopsis = QStringLiteral("convert <in> <out>"),
+            .description = QStringLiteral("Convert between configs and sheets, picking formats from the file "
+                                          "names.  Reading a sheet needs --base."),
+            .argCount = 2,
+            .run = runConvert,
+        },
+        Command{
+            .name = QStringLiteral("batch"),
+            .synopsis = QStringLiteral("batch <job-list>"),
+            .description = QStringLiteral("Run the exports and imports in a job list in parallel.  Each line of the "
+                                          "list is \"export<TAB><cfg><TAB><sheet>\" or "
+                                          "\"import<TAB><base-cfg><TAB><sheet><TAB><out-cfg>\"."),
+            .argCount = 1,
+            .run = runBatch,
+        },
+        Command{
+            .name = QStringLiteral("fan-out"),
+            .synopsis = QStringLiteral("fan-out <base-cfg> <workbook> <out-dir>"),
+            .description = QStringLiteral("Save a config for each rack in a workbook with \"<rack> Levels\" and "
+                                          "\"<rack> Times\" sheets, all from one base config."),
+            .argCount = 3,
+            .run = runFanOut,
+        },
+        Command{
+            .name = QStringLiteral("serve"),
+            .synopsis = QStringLiteral("serve <socket-name>"),
+            .description = QStringLiteral("Handle requests on a local socket, keeping configs in memory between "
+                                          "them.  See echoconfig::ConfigServer for the protocol."),
+            .argCount = 1,
+            .run = runServe,
+        },
+    };
+
+    const Command* findCommand(const QString& name)
+    {
+        for (const auto& command : kCommands)
+        {
+            if (command.name == name)
+            {
+                return &command;
+            }
+        }
+        return nullptr;
+    }
+
+    QString commandHelp()
+    {
+        QString help;
+        QTextStream out(&help);
+        out << "Commands:\n";
+        for (const auto& command : kCommands)
+        {
+            out << "  " << command.synopsis << "\n      " << command.description << "\n";
+        }
+        return help;
+    }
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setOrganizationName(echoblind::config::kProjectOrganizationName);
+    app.setOrganizationDomain(echoblind::config::kProjectOrganizationDomain);
+    app.setApplicationName(QStringLiteral("echoblind-cli"));
+    app.setApplicationVersion(echoblind::config::kProjectVersion);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Convert Echo config files and sheets.\n\n") + commandHelp());
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addOptions({
+        {QStringLiteral("json"), QStringLiteral("Print results, step timings, and waiting on files as JSON.")},
+        {QStringLiteral("base"), QStringLiteral("Base config file for convert."), QStringLiteral("cfg")},
+        {QStringLiteral("compact"), QStringLiteral("Write preset columns in compact layout.")},
+        {QStringLiteral("store"), QStringLiteral("Don't compress xlsx sheets.  Faster, for sheets used once.")},
+        {QStringLiteral("stream"), QStringLiteral("Parse configs with the stream parser instead of mapping them.")},
+        {QStringLiteral("cache"), QStringLiteral("Use the parsed config cache shared with the GUI.")},
+        {QStringLiteral("threads"),
+         QStringLiteral("Worker threads for batch, fan-out, and serve.  0 uses one per core."), QStringLiteral("count"),
+         QStringLiteral("0")},
+    });
+    parser.addPositionalArgument(QStringLiteral("command"), QStringLiteral("Command to run (see above)."));
+    parser.addPositionalArgument(QStringLiteral("args"), QStringLiteral("Command arguments."),
+                                 QStringLiteral("[args...]"));
+    parser.process(app);
+
+    auto positional = parser.positionalArguments();
+    const auto* command = positional.isEmpty() ? nullptr : findCommand(positional.front());
+    if (command == nullptr || positional.size() - 1 != command->argCount)
+    {
+        parser.showHelp(1);
+    }
+    positional.removeFirst();
+
+    // Only touch the cache directory when asked; it costs startup time otherwise.
+    std::optional<echoconfig::ConfigCache> cache;
+    if (parser.isSet(QStringLiteral("cache")))
+    {
+        // The GUI's cache, which is under its application name rather than this one.
+        cache.emplace(echoconfig::ConfigCache::defaultDir(echoblind::config::kProjectName));
+    }
+    Context ctx{
+        .parser = parser,
+        .args = positional,
+        .parseOptions =
+            {
+                .engine = parser.isSet(QStringLiteral("stream")) ? echoconfig::ParseEngine::Stream
+                                                                 : echoconfig::ParseEngine::Mapped,
+                .cache = cache.has_value() ? &cache.value() : nullptr,
+                .threadCount = 0,
+            },
+        .sheetOptions =
+            {
+                .layout = parser.isSet(QStringLiteral("compact")) ? echoconfig::PresetLayout::Compact
+                                                                  : echoconfig::PresetLayout::ByNumber,
+                .compression = parser.isSet(QStringLiteral("store")) ? echoconfig::CompressionLevel::Store
+                                                                     : echoconfig::CompressionLevel::Default,
+            },
+    };
+
+    const bool json = parser.isSet(QStringLiteral("json"));
+    int status = 0;
+    try
+    {
+        command->run(ctx);
+        status = ctx.failed ? 1 : 0;
+    }
+    catch (const std::exception& e)
+    {
+        status = 1;
+        ctx.result.insert(QStringLiteral("error"), QString::fromUtf8(e.what()));
+        if (!json)
+        {
+            QTextStream(stderr) << e.what() << "\n";
+        }
+    }
+
+    if (json)
+    {
+        ctx.result.insert(QStringLiteral("command"), command->name);
+        ctx.result.insert(QStringLiteral("ok"), status == 0);
+        ctx.result.insert(QStringLiteral("timings"), ctx.timer.toJson());
+        // Only files that were actually read or written a block at a time report waiting.
+        QJsonObject ioWait;
+        if (ctx.readStats.bytes > 0)
+        {
+            ioWait.insert(QStringLiteral("loadCfg"), ctx.readStats.waitFraction());
+        }
+        if (ctx.writeStats.bytes > 0)
+        {
+            ioWait.insert(QStringLiteral("saveCfg"), ctx.writeStats.waitFraction());
+        }
+        if (!ioWait.isEmpty())
+        {
+            ctx.result.insert(QStringLiteral("ioWait"), ioWait);
+        }
+        QTextStream(stdout) << QJsonDocument(ctx.result).toJson(QJsonDocument::Compact) << "\n";
+    }
+    else
+    {
+        QTextStream(stdout) << ctx.text;
+    }
+
+    return status;
+}
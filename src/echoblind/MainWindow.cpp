@@ -67,11 +67,17 @@ namespace echoblind
         widgets_.outSheetPath = new FileSelectorWidget(saveSheetTab);
         widgets_.outSheetPath->setAcceptMode(QFileDialog::AcceptSave);
         widgets_.outSheetPath->setFileMode(QFileDialog::FileMode::AnyFile);
-        widgets_.outSheetPath->setMimeTypeFilters(
-            {"application/vnd.openxmlformats-officedocument.spreadsheetml.sheet"});
+        widgets_.outSheetPath->setMimeTypeFilters(kSheetMimeTypes);
         connect(widgets_.outSheetPath, &FileSelectorWidget::pathChanged, this, &MainWindow::outSheetChanged);
         saveSheetLayout->addWidget(widgets_.outSheetPath);
 
+        // Preset layout.
+        widgets_.compactPresetColumns = new QCheckBox(tr("Skip columns for unused preset numbers"), saveSheetTab);
+        widgets_.compactPresetColumns->setChecked(settings::getCompactPresetColumns());
+        connect(widgets_.compactPresetColumns, &QCheckBox::toggled, this,
+                [](bool checked) { settings::setCompactPresetColumns(checked); });
+        saveSheetLayout->addWidget(widgets_.compactPresetColumns);
+
         // -----
         saveSheetLayout->addStretch();
 
@@ -91,7 +97,7 @@ namespace echoblind
         widgets_.inSheetPath = new FileSelectorWidget(saveCfgTab);
         widgets_.inSheetPath->setAcceptMode(QFileDialog::AcceptOpen);
         widgets_.inSheetPath->setFileMode(QFileDialog::FileMode::ExistingFile);
-        widgets_.inSheetPath->setMimeTypeFilters({"application/vnd.openxmlformats-officedocument.spreadsheetml.sheet"});
+        widgets_.inSheetPath->setMimeTypeFilters(kSheetMimeTypes);
         connect(widgets_.inSheetPath, &FileSelectorWidget::pathChanged, this, &MainWindow::inSheetChanged);
         saveCfgLayout->addWidget(widgets_.inSheetPath);
 
@@ -136,7 +142,13 @@ namespace echoblind
         {
             try
             {
-                newConfig = echoconfig::Config::loadCfg(path);
+                // Keep the file in memory; saving the updated config needs it again.  Files that have been opened
+                // before come from the cache instead of being parsed.
+                newConfig = echoconfig::Config::loadCfg(path, {.retainBase = true, .cache = &configCache_});
+                if (newConfig != nullptr)
+                {
+                    newConfig->setSaveOptions({.threadCount = 0});
+                }
             }
             catch (const std::exception&)
             {
@@ -206,14 +218,22 @@ namespace echoblind
 
         try
         {
-            config_->saveSheet(widgets_.outSheetPath->path());
+            const auto layout = widgets_.compactPresetColumns->isChecked() ? echoconfig::PresetLayout::Compact
+                                                                           : echoconfig::PresetLayout::ByNumber;
+            config_->saveSheet(widgets_.outSheetPath->path(), {.layout = layout});
             QMessageBox msgBox(QMessageBox::Information, tr("Sheet saved"),
                                tr("The sheet has been saved. Do you want to open it?"),
                                QMessageBox::Yes | QMessageBox::No, this);
             const auto ret = msgBox.exec();
             if (ret == QMessageBox::Yes)
             {
-                QDesktopServices::openUrl(QUrl::fromLocalFile(widgets_.outSheetPath->path()));
+                auto openPath = widgets_.outSheetPath->path();
+                if (echoconfig::Config::sheetFormatOf(openPath) != echoconfig::SheetFormat::Xlsx)
+                {
+                    // Delimited sheets are saved as two tables.
+                    openPath = echoconfig::Config::tablePaths(openPath).first;
+                }
+                QDesktopServices::openUrl(QUrl::fromLocalFile(openPath));
             }
         }
         catch (const std::exception&)
@@ -9,11 +9,13 @@
 #ifndef MAINWINDOW_H
 #define MAINWINDOW_H
 
+#include <QCheckBox>
 #include <QLabel>
 #include <QMainWindow>
 #include <QPushButton>
 #include "FileSelectorWidget.h"
 #include "echoconfig/Config.h"
+#include "echoconfig/ConfigCache.h"
 
 namespace echoblind
 {
@@ -29,6 +31,12 @@ namespace echoblind
 
     private:
         inline static QStringList kDefaultConfigFilters{tr("Echo config files (*.cfg *.eacp)")};
+        /** Sheets are saved and read in the format matching the file's extension. */
+        inline static QStringList kSheetMimeTypes{
+            "application/vnd.openxmlformats-officedocument.spreadsheetml.sheet",
+            "text/csv",
+            "text/tab-separated-values",
+        };
         struct Widgets
         {
             FileSelectorWidget* baseCfgPath = nullptr;
@@ -36,12 +44,14 @@ namespace echoblind
             QLabel* rackNameLabel = nullptr;
             FileSelectorWidget* inSheetPath = nullptr;
             FileSelectorWidget* outSheetPath = nullptr;
+            QCheckBox* compactPresetColumns = nullptr;
             FileSelectorWidget* outCfgPath = nullptr;
             QPushButton* saveSheetButton = nullptr;
             QPushButton* saveCfgButton = nullptr;
         };
         Widgets widgets_;
         std::unique_ptr<echoconfig::Config> config_;
+        echoconfig::ConfigCache configCache_;
 
         void initUi();
         void updateAllowedActions();
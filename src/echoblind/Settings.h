@@ -38,6 +38,7 @@ namespace echoblind::settings
 
     DO_SETTING(QByteArray, MainWindowGeometry, {});
     DO_SETTING(QString, LastFileDialogPath, QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation));
+    DO_SETTING(bool, CompactPresetColumns, false);
 
 } // namespace echoblind::settings
 
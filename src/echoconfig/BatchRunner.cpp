@@ -0,0 +1,184 @@
+/**
+ * @file BatchRunner.cpp
+ *
+ * @author Dan Keenan
+ * @date 10/17/2026
+ * @copyright GNU GPLv3
+ */
+
+#include "echoconfig/BatchRunner.h"
+#include <QThread>
+#include <QThreadPool>
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include "echoconfig/batch_helpers.h"
+
+namespace echoconfig
+{
+    namespace
+    {
+        using Clock = std::chrono::steady_clock;
+
+        /**
+         * The jobs waiting for one worker.
+         *
+         * The owner takes jobs from the front and other workers steal from the back, so they only want the same job
+         * when one is left.  Jobs are whole files, so a lock per queue costs nothing next to running them.
+         */
+        class WorkQueue
+        {
+        public:
+            void push(std::size_t job)
+            {
+                std::scoped_lock lock(mutex_);
+                jobs_.push_back(job);
+            }
+
+            std::optional<std::size_t> take()
+            {
+                std::scoped_lock lock(mutex_);
+                if (jobs_.empty())
+                {
+                    return std::nullopt;
+                }
+                const auto job = jobs_.front();
+                jobs_.pop_front();
+                return job;
+            }
+
+            std::optional<std::size_t> steal()
+            {
+                std::scoped_lock lock(mutex_);
+                if (jobs_.empty())
+                {
+                    return std::nullopt;
+                }
+                const auto job = jobs_.back();
+                jobs_.pop_back();
+                return job;
+            }
+
+        private:
+            std::mutex mutex_;
+            std::deque<std::size_t> jobs_;
+        };
+    } // namespace
+
+    std::size_t BatchRunner::Report::failedCount() const
+    {
+        return batch_helpers::failedCount(results);
+    }
+
+    BatchRunner::BatchRunner() : BatchRunner(Options()) {}
+
+    BatchRunner::BatchRunner(Options options) : options_(std::move(options)) {}
+
+    BatchRunner::Report BatchRunner::run(std::span<const Job> jobs) const
+    {
+        const auto start = Clock::now();
+        Report report;
+        report.results.resize(jobs.size());
+        const auto threadCount = options_.threadCount > 0 ? options_.threadCount
+                                                          : static_cast<unsigned int>(QThread::idealThreadCount());
+        report.threadCount = std::max(1u, std::min(threadCount, static_cast<unsigned int>(jobs.size())));
+
+        // Give each worker a contiguous share; stealing evens out whatever imbalance that leaves.
+        std::vector<WorkQueue> queues(report.threadCount);
+        for (std::size_t ix = 0; ix < jobs.size(); ++ix)
+        {
+            queues[ix * report.threadCount / jobs.size()].push(ix);
+        }
+
+        std::atomic<std::size_t> steals = 0;
+        const auto work = [&](unsigned int worker)
+        {
+            while (true)
+            {
+                auto ix = queues[worker].take();
+                for (unsigned int offset = 1; !ix.has_value() && offset < queues.size(); ++offset)
+                {
+                    ix = queues[(worker + offset) % queues.size()].steal();
+                    if (ix.has_value())
+                    {
+                        ++steals;
+                    }
+                }
+                if (!ix.has_value())
+                {
+                    // Jobs are never added once started, so every queue stays empty.
+                    return;
+                }
+                auto& result = report.results[*ix];
+                result = runJob(jobs[*ix]);
+                result.worker = worker;
+                if (options_.onJobFinished)
+                {
+                    options_.onJobFinished(*ix, result);
+                }
+            }
+        };
+
+        // A pool of our own, so the global pool stays free for the work each job splits off.
+        QThreadPool pool;
+        pool.setMaxThreadCount(static_cast<int>(report.threadCount));
+        for (unsigned int worker = 1; worker < report.threadCount; ++worker)
+        {
+            pool.start([&work, worker]() { work(worker); });
+        }
+        work(0);
+        pool.waitForDone();
+
+        report.steals = steals;
+        report.wallTime = Clock::now() - start;
+        return report;
+    }
+
+    BatchRunner::JobResult BatchRunner::runJob(const Job& job) const
+    {
+        JobResult result;
+        const auto start = Clock::now();
+        try
+        {
+            auto parseOptions = options_.parseOptions;
+            // Saving reads the base again otherwise.
+            parseOptions.retainBase = parseOptions.retainBase || job.operation == Operation::ImportSheet;
+            std::unique_ptr<Config> config;
+            batch_helpers::timed(result.timings.parseCfg,
+                                 [&]() { config = Config::loadCfgOrThrow(job.cfgPath, parseOptions); });
+
+            switch (job.operation)
+            {
+            case Operation::ExportSheet:
+                batch_helpers::timed(result.timings.saveSheet,
+                                     [&]() { config->saveSheet(job.sheetPath, options_.sheetOptions); });
+                break;
+            case Operation::ImportSheet:
+                if (job.outPath.isEmpty())
+                {
+                    throw std::runtime_error("No output path");
+                }
+                batch_helpers::timed(result.timings.parseSheet, [&]() { config->parseSheet(job.sheetPath); });
+                batch_helpers::timed(result.timings.saveCfg, [&]() { config->saveCfg(job.cfgPath, job.outPath); });
+                break;
+            }
+            result.ok = true;
+        }
+        catch (const std::exception& e)
+        {
+            result.error = QString::fromUtf8(e.what());
+        }
+        catch (...)
+        {
+            result.error = QStringLiteral("Unknown error");
+        }
+        result.timings.total = Clock::now() - start;
+        return result;
+    }
+} // namespace echoconfig
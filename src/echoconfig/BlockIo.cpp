@@ -0,0 +1,233 @@
+/**
+ * @file BlockIo.cpp
+ *
+ * @author Dan Keenan
+ * @date 10/17/2026
+ * @copyright GNU GPLv3
+ */
+
+#include "echoconfig/BlockIo.h"
+#include <stdexcept>
+#include <utility>
+
+namespace echoconfig
+{
+    ReadAhead::ReadAhead(QIODevice& in) : ReadAhead(in, Options()) {}
+
+    ReadAhead::ReadAhead(QIODevice& in, const Options& options) :
+        in_(in), options_(options), start_(Clock::now()), thread_([this]() { readBlocks(); })
+    {}
+
+    ReadAhead::~ReadAhead()
+    {
+        {
+            std::scoped_lock lock(mutex_);
+            stopping_ = true;
+        }
+        changed_.notify_all();
+        thread_.join();
+    }
+
+    QByteArray ReadAhead::next()
+    {
+        std::unique_lock lock(mutex_);
+        if (blocks_.empty() && !done_)
+        {
+            const auto waitStart = Clock::now();
+            changed_.wait(lock, [this]() { return !blocks_.empty() || done_; });
+            stats_.waited += Clock::now() - waitStart;
+        }
+
+        if (!blocks_.empty())
+        {
+            auto block = std::move(blocks_.front());
+            blocks_.pop_front();
+            stats_.bytes += block.size();
+            // There's room for another block.
+            changed_.notify_all();
+            return block;
+        }
+        if (!finished_)
+        {
+            finished_ = true;
+            stats_.elapsed = Clock::now() - start_;
+        }
+        if (failed_)
+        {
+            throw std::runtime_error("Failed to read file");
+        }
+        return {};
+    }
+
+    IoStats ReadAhead::stats() const
+    {
+        std::scoped_lock lock(mutex_);
+        auto stats = stats_;
+        if (!finished_)
+        {
+            stats.elapsed = Clock::now() - start_;
+        }
+        return stats;
+    }
+
+    void ReadAhead::readBlocks()
+    {
+        while (true)
+        {
+            {
+                std::unique_lock lock(mutex_);
+                changed_.wait(lock, [this]() { return stopping_ || blocks_.size() < options_.maxBlocks; });
+                if (stopping_)
+                {
+                    return;
+                }
+            }
+
+            QByteArray block(options_.blockSize, Qt::Uninitialized);
+            const auto size = in_.read(block.data(), block.size());
+
+            {
+                std::scoped_lock lock(mutex_);
+                if (size > 0)
+                {
+                    block.truncate(size);
+                    blocks_.push_back(std::move(block));
+                }
+                else
+                {
+                    failed_ = size < 0;
+                    done_ = true;
+                }
+            }
+            changed_.notify_all();
+            if (size <= 0)
+            {
+                return;
+            }
+        }
+    }
+
+    WriteBehind::WriteBehind(QIODevice& out) : WriteBehind(out, Options()) {}
+
+    WriteBehind::WriteBehind(QIODevice& out, const Options& options) :
+        out_(out), options_(options), start_(Clock::now()), thread_([this]() { writeBlocks(); })
+    {
+        filling_.reserve(options_.blockSize);
+    }
+
+    WriteBehind::~WriteBehind() { stop(); }
+
+    void WriteBehind::write(const char* data, qsizetype size)
+    {
+        filling_.append(data, size);
+        if (filling_.size() >= options_.blockSize)
+        {
+            handOff();
+        }
+    }
+
+    void WriteBehind::write(const QByteArray& block)
+    {
+        if (filling_.isEmpty() && block.size() >= options_.blockSize)
+        {
+            // Shares the data instead of copying it.
+            filling_ = block;
+            handOff();
+        }
+        else
+        {
+            write(block.constData(), block.size());
+        }
+    }
+
+    void WriteBehind::finish()
+    {
+        if (!filling_.isEmpty())
+        {
+            handOff();
+        }
+        {
+            std::unique_lock lock(mutex_);
+            const auto waitStart = Clock::now();
+            changed_.wait(lock, [this]() { return !flushPending_; });
+            stats_.waited += Clock::now() - waitStart;
+            stats_.elapsed = Clock::now() - start_;
+            finished_ = true;
+        }
+        stop();
+        if (failed_)
+        {
+            throw std::runtime_error("Failed to save file");
+        }
+    }
+
+    IoStats WriteBehind::stats() const
+    {
+        std::scoped_lock lock(mutex_);
+        auto stats = stats_;
+        if (!finished_)
+        {
+            stats.elapsed = Clock::now() - start_;
+        }
+        return stats;
+    }
+
+    void WriteBehind::handOff()
+    {
+        {
+            std::unique_lock lock(mutex_);
+            if (flushPending_)
+            {
+                const auto waitStart = Clock::now();
+                changed_.wait(lock, [this]() { return !flushPending_; });
+                stats_.waited += Clock::now() - waitStart;
+            }
+            if (failed_)
+            {
+                throw std::runtime_error("Failed to save file");
+            }
+            // The writing thread is done with its buffer, so it can be refilled.
+            std::swap(filling_, flushing_);
+            flushPending_ = true;
+            stats_.bytes += flushing_.size();
+        }
+        changed_.notify_all();
+        filling_.resize(0);
+    }
+
+    void WriteBehind::writeBlocks()
+    {
+        std::unique_lock lock(mutex_);
+        while (true)
+        {
+            changed_.wait(lock, [this]() { return flushPending_ || stopping_; });
+            if (!flushPending_)
+            {
+                return;
+            }
+
+            lock.unlock();
+            const bool written = out_.write(flushing_) == flushing_.size();
+            flushing_.resize(0);
+            lock.lock();
+
+            failed_ = failed_ || !written;
+            flushPending_ = false;
+            changed_.notify_all();
+        }
+    }
+
+    void WriteBehind::stop()
+    {
+        if (!thread_.joinable())
+        {
+            return;
+        }
+        {
+            std::scoped_lock lock(mutex_);
+            stopping_ = true;
+        }
+        changed_.notify_all();
+        thread_.join();
+    }
+} // namespace echoconfig
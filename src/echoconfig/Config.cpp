@@ -7,110 +7,395 @@
  */
 
 #include "echoconfig/Config.h"
+#include <QDir>
 #include <QFile>
+#include <QFileInfo>
 #include <QRegularExpression>
 #include <QSaveFile>
-#include <QTemporaryDir>
+#include <QXmlStreamReader>
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <map>
 #include <optional>
+#include <ranges>
 #include <regex>
-#include <xlsxdocument.h>
-#include <xlsxworkbook.h>
 
+#include "echoconfig/ConfigCache.h"
+#include "echoconfig/ConfigSnapshot.h"
+#include "echoconfig/CsvReader.h"
+#include "echoconfig/CsvWriter.h"
 #include "echoconfig/EchoAcpConfig.h"
 #include "echoconfig/EchoPcpConfig.h"
+#include "echoconfig/XlsxReader.h"
+#include "echoconfig/XlsxWriter.h"
 #include "echoconfig/sheet_helpers.h"
+#include "echoconfig/thread_helpers.h"
 
 namespace echoconfig
 {
     static const auto kRePreset = QRegularExpression(R"(^Preset (\d+)$)");
 
-    std::unique_ptr<Config> Config::loadCfg(const QString& path)
+    // Columns of saved sheets.  Preset columns start at k*ColPreset and are placed according to the PresetLayout.
+    static constexpr auto kLevelsColCircuit = 1;
+    static constexpr auto kLevelsColSpace = 2;
+    static constexpr auto kLevelsColZone = 3;
+    static constexpr auto kLevelsColPreset = 4;
+    static constexpr auto kTimesColSpace = 1;
+    static constexpr auto kTimesColPreset = 2;
+
+    static char delimiterOf(SheetFormat format) { return format == SheetFormat::Tsv ? '\t' : ','; }
+
+    /**
+     * All known config types.
+     */
+    static const std::vector<std::unique_ptr<detail::ConfigLoaderFactory>>& configLoaders()
+    {
+        static const auto loaders = []()
+        {
+            // ADD CONFIG TYPES HERE!
+            std::vector<std::unique_ptr<detail::ConfigLoaderFactory>> loaders;
+            loaders.emplace_back(std::make_unique<ConfigLoader<EchoPcpConfig>>());
+            loaders.emplace_back(std::make_unique<ConfigLoader<EchoAcpConfig>>());
+            return loaders;
+        }();
+        return loaders;
+    }
+
+    std::unique_ptr<Config> Config::loadCfg(const QString& path, const ParseOptions& options)
     {
-        // ADD CONFIG TYPES HERE!
-        std::vector<std::unique_ptr<detail::ConfigLoaderFactory>> loaders;
-        loaders.emplace_back(std::make_unique<ConfigLoader<EchoPcpConfig>>());
-        loaders.emplace_back(std::make_unique<ConfigLoader<EchoAcpConfig>>());
+        try
+        {
+            return loadCfgOrThrow(path, options);
+        }
+        catch (const std::exception&)
+        {
+            return nullptr;
+        }
+    }
 
-        std::unique_ptr<Config> obj;
-        for (const auto& loader : loaders)
+    std::unique_ptr<Config> Config::loadCfgOrThrow(const QString& path, const ParseOptions& options)
+    {
+        const auto header = sniffCfg(path);
+        if (!header.has_value())
         {
-            try
+            throw std::runtime_error("Failed to read config file");
+        }
+
+        // The first type that accepts the header is used; if it can't parse the file, no other type will do better.
+        for (const auto& loader : configLoaders())
+        {
+            if (!loader->accepts(header.value()))
+            {
+                continue;
+            }
+            if (options.cache == nullptr)
             {
-                obj = (*loader)(path);
+                return (*loader)(path, options);
             }
-            catch (const std::exception&)
+            auto cfg = options.cache->load(path, header.value(), options.retainBase,
+                                           [&]() { return (*loader)(path, options); });
+            if (cfg != nullptr)
+            {
+                cfg->setParseOptions(options);
+            }
+            return cfg;
+        }
+
+        throw std::runtime_error("Unknown config type");
+    }
+
+    std::unique_ptr<Config> Config::fromSnapshot(const ConfigSnapshot& snapshot)
+    {
+        for (const auto& loader : configLoaders())
+        {
+            if (loader->accepts(snapshot.cfgHeader()))
+            {
+                auto cfg = loader->create();
+                cfg->loadSnapshot(snapshot);
+                return cfg;
+            }
+        }
+
+        return nullptr;
+    }
+
+    std::optional<CfgHeader> Config::sniffCfg(const QString& path)
+    {
+        QFile f(path);
+        if (!f.open(QIODevice::ReadOnly))
+        {
+            return std::nullopt;
+        }
+
+        // The reader pulls from the device on demand, so only the start of the file is read.
+        QXmlStreamReader xml(&f);
+        CfgHeader header;
+        while (!xml.atEnd())
+        {
+            if (xml.readNext() != QXmlStreamReader::StartElement)
             {
-                // Try the next one.
                 continue;
             }
+            if (header.rootTag.isEmpty())
+            {
+                header.rootTag = xml.name().toString();
+            }
+            else
+            {
+                header.rackTag = xml.name().toString();
+                header.version = xml.attributes().value(QStringLiteral("VERSION")).toString();
+                return header;
+            }
+        }
+        if (xml.hasError() || header.rootTag.isEmpty())
+        {
+            return std::nullopt;
         }
 
-        return obj;
+        return header;
     }
 
     void Config::parseCfg(const QString& path) { sheetParsed_ = false; }
 
-    void Config::parseSheet(const QString& path)
+    void Config::loadSnapshot(const ConfigSnapshot& snapshot) { sheetParsed_ = false; }
+
+    struct Config::LevelsSheet
+    {
+        struct Row
+        {
+            unsigned int circuitNum;
+            unsigned int spaceNum;
+            unsigned int zoneNum;
+        };
+
+        /** In ascending order. */
+        std::vector<unsigned int> presetNums;
+        std::vector<Row> rows;
+        /** Level of each preset in presetNums for each row, row by row. */
+        std::vector<decltype(Preset::levels)::mapped_type> levels;
+    };
+
+    struct Config::TimesSheet
+    {
+        /** In ascending order. */
+        std::vector<unsigned int> presetNums;
+        std::vector<unsigned int> spaceNums;
+        /** Fade time of each preset in presetNums for each space, space by space. */
+        std::vector<decltype(Preset::fadeTimes)::mapped_type> fadeTimes;
+    };
+
+    void Config::parseSheet(const QString& path, std::optional<SheetFormat> format)
     {
         sheetParsed_ = false;
 
-        QFile f(path);
-        if (!f.open(QIODevice::ReadOnly))
+        // The sheets are independent, so they are read at the same time.  Adding the values to the config can't be
+        // shared, so it happens afterwards.
+        LevelsSheet levels;
+        TimesSheet times;
+        const auto sheetFormat = format.value_or(sheetFormatOf(path));
+        if (sheetFormat == SheetFormat::Xlsx)
+        {
+            QFile f(path);
+            if (!f.open(QIODevice::ReadOnly))
+            {
+                throw std::runtime_error("Failed to open file");
+            }
+            const XlsxReader workbook(&f);
+            readWorkbook(workbook, tr("Levels"), tr("Times"), levels, times);
+        }
+        else
+        {
+            readTables(path, delimiterOf(sheetFormat), levels, times);
+        }
+        applySheets(levels, times);
+    }
+
+    void Config::parseWorkbookSheets(const XlsxReader& workbook, const QString& levelsName, const QString& timesName)
+    {
+        sheetParsed_ = false;
+        LevelsSheet levels;
+        TimesSheet times;
+        readWorkbook(workbook, levelsName, timesName, levels, times);
+        applySheets(levels, times);
+    }
+
+    void Config::applySheets(const LevelsSheet& levels, const TimesSheet& times)
+    {
+        applySheetLevels(levels);
+        applySheetTimes(times);
+        sheetApplied();
+        sheetParsed_ = true;
+    }
+
+    void Config::saveSheet(const QString& path, const SheetOptions& options) const
+    {
+        const auto sheetFormat = options.format.value_or(sheetFormatOf(path));
+        if (sheetFormat == SheetFormat::Xlsx)
         {
-            throw std::runtime_error("Failed to open file");
+            saveWorkbook(path, options);
         }
-        QXlsx::Document doc(&f);
+        else
+        {
+            saveTables(path, delimiterOf(sheetFormat), options.layout);
+        }
+    }
 
-        // Levels sheet
-        if (!doc.selectSheet(tr("Levels")))
+    SheetFormat Config::sheetFormatOf(const QString& path)
+    {
+        const auto suffix = QFileInfo(path).suffix();
+        if (suffix.compare(u"csv", Qt::CaseInsensitive) == 0)
         {
-            throw std::runtime_error("Missing \"Levels\" sheet.");
+            return SheetFormat::Csv;
         }
-        openSheetLevels(&doc);
-        if (!doc.selectSheet(tr("Times")))
+        else if (suffix.compare(u"tsv", Qt::CaseInsensitive) == 0 || suffix.compare(u"tab", Qt::CaseInsensitive) == 0)
         {
-            throw std::runtime_error("Missing \"Times\" sheet.");
+            return SheetFormat::Tsv;
         }
-        openSheetTimes(&doc);
+        return SheetFormat::Xlsx;
+    }
 
-        sheetParsed_ = true;
+    std::pair<QString, QString> Config::tablePaths(const QString& path)
+    {
+        const QFileInfo info(path);
+        auto base = info.completeBaseName();
+        for (const auto tableSuffix : {u".levels", u".times"})
+        {
+            if (base.endsWith(tableSuffix, Qt::CaseInsensitive))
+            {
+                base.chop(QStringView(tableSuffix).size());
+                break;
+            }
+        }
+        const auto ext = info.suffix().isEmpty() ? QString() : QStringLiteral(".") + info.suffix();
+        const QDir dir = info.dir();
+        return {
+            dir.filePath(base + QStringLiteral(".levels") + ext),
+            dir.filePath(base + QStringLiteral(".times") + ext),
+        };
+    }
+
+    void Config::readWorkbook(const XlsxReader& workbook, const QString& levelsName, const QString& timesName,
+                              LevelsSheet& levels, TimesSheet& times)
+    {
+        if (!workbook.hasSheet(levelsName))
+        {
+            throw std::runtime_error(QStringLiteral("Missing \"%1\" sheet.").arg(levelsName).toStdString());
+        }
+        // Problems with the Levels sheet are reported first.
+        thread_helpers::parallelInvoke(
+            [&levels, &workbook, &levelsName]()
+            {
+                XlsxSheetReader sheet(workbook, levelsName);
+                levels = readSheetLevels(sheet);
+            },
+            [&times, &workbook, &timesName]()
+            {
+                if (!workbook.hasSheet(timesName))
+                {
+                    throw std::runtime_error(QStringLiteral("Missing \"%1\" sheet.").arg(timesName).toStdString());
+                }
+                XlsxSheetReader sheet(workbook, timesName);
+                times = readSheetTimes(sheet);
+            });
     }
 
-    void Config::saveSheet(const QString& path) const
+    void Config::readTables(const QString& path, char delimiter, LevelsSheet& levels, TimesSheet& times)
     {
-        QXlsx::Document doc;
-        auto book = doc.workbook();
-        bool success;
-
-        // Levels sheet.
-        book->addSheet(tr("Levels"));
-        book->setActiveSheet(kSheetIxLevels);
-        saveSheetLevels(&doc);
-
-        // Times sheet.
-        book->addSheet(tr("Times"));
-        book->setActiveSheet(kSheetIxTimes);
-        saveSheetTimes(&doc);
-
-        // Save.
-        book->setActiveSheet(kSheetIxLevels);
-        // Can't use QSaveFile because the library calls close() on the file.
-        QTemporaryDir saveDir;
-        QFile f(saveDir.filePath("save.tmp"));
-        f.open(QIODevice::WriteOnly);
-        success = doc.saveAs(&f);
-        if (success)
-        {
-            QFile::remove(path);
-            success = f.copy(path);
-        }
-        if (!success)
+        const auto [levelsPath, timesPath] = tablePaths(path);
+        QFile levelsFile(levelsPath);
+        if (!levelsFile.open(QIODevice::ReadOnly))
+        {
+            throw std::runtime_error("Missing \"Levels\" table.");
+        }
+        QFile timesFile(timesPath);
+        if (!timesFile.open(QIODevice::ReadOnly))
+        {
+            throw std::runtime_error("Missing \"Times\" table.");
+        }
+
+        // Problems with the Levels table are reported first.
+        thread_helpers::parallelInvoke(
+            [&levels, &levelsFile, delimiter]()
+            {
+                CsvReader table(&levelsFile, delimiter);
+                levels = readSheetLevels(table);
+            },
+            [&times, &timesFile, delimiter]()
+            {
+                CsvReader table(&timesFile, delimiter);
+                times = readSheetTimes(table);
+            });
+    }
+
+    void Config::saveWorkbook(const QString& path, const SheetOptions& options) const
+    {
+        QSaveFile f(path);
+        if (!f.open(QIODevice::WriteOnly))
+        {
+            throw std::runtime_error("Error saving config");
+        }
+
+        XlsxWriter writer(&f, {.level = options.compression, .parallel = true});
+        saveWorkbookSheets(writer, tr("Levels"), tr("Times"), options.layout);
+        writer.finish();
+        if (!f.commit())
         {
             throw std::runtime_error("Error saving config");
         }
     }
 
-    void Config::openSheetLevels(const QXlsx::Document* doc)
+    void Config::saveWorkbookSheets(XlsxWriter& writer, const QString& levelsName, const QString& timesName,
+                                    PresetLayout layout) const
+    {
+        const auto levelsPresetCols = presetColumns(kLevelsColPreset, layout);
+        const auto timesPresetCols = presetColumns(kTimesColPreset, layout);
+        // Headers are written first and in order so the shared strings are numbered the same way every time.
+        const auto levelsColCount = std::max(kLevelsColZone, levelsPresetCols.empty() ? 0 : levelsPresetCols.back());
+        auto& levels = writer.addSheet(levelsName, static_cast<int>(circuitCount()) + 1, levelsColCount);
+        saveSheetLevelsHeader(levels, levelsPresetCols);
+        const auto timesColCount = std::max(kTimesColSpace, timesPresetCols.empty() ? 0 : timesPresetCols.back());
+        auto& times = writer.addSheet(timesName, static_cast<int>(spaceCount()) + 1, timesColCount);
+        saveSheetTimesHeader(times, timesPresetCols);
+        // Levels is usually the larger sheet and goes straight into the file, so it stays on this thread.
+        thread_helpers::parallelInvoke([this, &times, &timesPresetCols]() { saveSheetTimes(times, timesPresetCols); },
+                                       [this, &levels, &levelsPresetCols]()
+                                       { saveSheetLevels(levels, levelsPresetCols); });
+    }
+
+    void Config::saveTables(const QString& path, char delimiter, PresetLayout layout) const
+    {
+        const auto [levelsPath, timesPath] = tablePaths(path);
+        QSaveFile levelsFile(levelsPath);
+        QSaveFile timesFile(timesPath);
+        if (!levelsFile.open(QIODevice::WriteOnly) || !timesFile.open(QIODevice::WriteOnly))
+        {
+            throw std::runtime_error("Error saving config");
+        }
+
+        const auto levelsPresetCols = presetColumns(kLevelsColPreset, layout);
+        const auto timesPresetCols = presetColumns(kTimesColPreset, layout);
+        thread_helpers::parallelInvoke(
+            [this, &timesFile, &timesPresetCols, delimiter]()
+            {
+                CsvWriter table(&timesFile, delimiter);
+                saveSheetTimesHeader(table, timesPresetCols);
+                saveSheetTimes(table, timesPresetCols);
+            },
+            [this, &levelsFile, &levelsPresetCols, delimiter]()
+            {
+                CsvWriter table(&levelsFile, delimiter);
+                saveSheetLevelsHeader(table, levelsPresetCols);
+                saveSheetLevels(table, levelsPresetCols);
+            });
+        if (!levelsFile.commit() || !timesFile.commit())
+        {
+            throw std::runtime_error("Error saving config");
+        }
+    }
+
+    template <typename SheetReader>
+    Config::LevelsSheet Config::readSheetLevels(SheetReader& sheet)
     {
         std::optional<int> colCircuit;
         std::optional<int> colSpace;
@@ -118,10 +403,11 @@ namespace echoconfig
         std::map<unsigned int, int> colPresets;
 
         // Columns
-        for (int colIx = 1; colIx <= doc->dimension().columnCount(); ++colIx)
+        const bool hasHeader = sheet.readRow() && sheet.rowNum() == 1;
+        for (int colIx = 1; hasHeader; ++colIx)
         {
-            const auto val = doc->read(1, colIx);
-            if (!val.isValid() || val.toString().isEmpty())
+            const auto val = sheet_helpers::cellText(sheet.cell(colIx));
+            if (val.isEmpty())
             {
                 break;
             }
@@ -139,7 +425,7 @@ namespace echoconfig
             }
             else
             {
-                auto match = kRePreset.match(val.toString());
+                auto match = kRePreset.match(val);
                 if (match.hasMatch())
                 {
                     const auto presetNum = match.captured(1).toUInt();
@@ -164,105 +450,107 @@ namespace echoconfig
             throw std::runtime_error("Missing preset column.");
         }
 
+        LevelsSheet levels;
+        std::ranges::copy(colPresets | std::views::keys, std::back_inserter(levels.presetNums));
+        std::vector<int> presetCols;
+        presetCols.reserve(colPresets.size());
+        std::ranges::copy(colPresets | std::views::values, std::back_inserter(presetCols));
+
         // Data.
-        for (int rowIx = 2; rowIx <= doc->dimension().rowCount(); ++rowIx)
+        while (sheet.readRow())
         {
-            const auto circuitNum = sheet_helpers::requiredCellUInt(doc, rowIx, colCircuit.value());
-            const auto spaceNum = sheet_helpers::requiredCellUInt(doc, rowIx, colSpace.value());
-            const auto zoneNum = sheet_helpers::requiredCellUInt(doc, rowIx, colZone.value());
-
-            auto& circuit = getCircuit(circuitNum);
-            circuit.num = circuitNum;
-            circuit.space = spaceNum;
-            circuit.zone = zoneNum;
-
-            auto& space = getSpace(spaceNum);
-            space.num = spaceNum;
-
-            for (const auto [presetNum, colPreset] : colPresets)
+            levels.rows.push_back({
+                .circuitNum = sheet_helpers::requiredCellUInt(sheet.cell(colCircuit.value())),
+                .spaceNum = sheet_helpers::requiredCellUInt(sheet.cell(colSpace.value())),
+                .zoneNum = sheet_helpers::requiredCellUInt(sheet.cell(colZone.value())),
+            });
+            for (const auto colPreset : presetCols)
             {
-                const auto level = sheet_helpers::requiredCellUInt(doc, rowIx, colPreset);
+                const auto level = sheet_helpers::requiredCellUInt(sheet.cell(colPreset));
                 if (level > 255)
                 {
                     throw std::runtime_error("Bad level.");
                 }
-                auto& preset = getPreset(presetNum);
-                preset.num = presetNum;
-                preset.levels[circuitNum] = level;
+                levels.levels.push_back(level);
             }
         }
+
+        return levels;
     }
 
-    void Config::saveSheetLevels(QXlsx::Document* doc) const
+    void Config::applySheetLevels(const LevelsSheet& sheet)
     {
-        constexpr auto kColCircuit = 1;
-        constexpr auto kColSpace = 2;
-        constexpr auto kColZone = 3;
-        constexpr auto kColPreset = 4;
-
-        // Header.
-        doc->write(1, kColCircuit, tr("Circuit"));
-        doc->write(1, kColSpace, tr("Space"));
-        doc->write(1, kColZone, tr("Zone"));
-        for (unsigned int presetIx = 0; presetIx < presetCount(); ++presetIx)
-        {
-            const auto& preset = getPresetAt(presetIx);
-            doc->write(1, kColPreset + preset.num - 1, tr("Preset %1").arg(preset.num));
-        }
-
-        // Values.
-        for (unsigned int circuitIx = 0; circuitIx < circuitCount(); ++circuitIx)
-        {
-            const auto& circuit = getCircuitAt(circuitIx);
-            const auto row = circuitIx + 2;
-            doc->write(row, kColCircuit, circuit.num);
-            doc->write(row, kColSpace, circuit.space);
-            doc->write(row, kColZone, circuit.zone);
-            for (unsigned int presetIx = 0; presetIx < presetCount(); ++presetIx)
+        if (sheet.rows.empty())
+        {
+            return;
+        }
+
+        const auto rowPresets = resolvePresets(sheet.presetNums);
+        auto level = sheet.levels.cbegin();
+        for (const auto& row : sheet.rows)
+        {
+            auto& circuit = getCircuit(row.circuitNum);
+            circuit.num = row.circuitNum;
+            circuit.space = row.spaceNum;
+            circuit.zone = row.zoneNum;
+
+            auto& space = getSpace(row.spaceNum);
+            space.num = row.spaceNum;
+
+            for (auto* preset : rowPresets)
             {
-                const auto& preset = getPresetAt(presetIx);
-                doc->write(row, kColPreset + preset.num - 1, preset.levels.at(circuit.num));
+                preset->levels[row.circuitNum] = *level++;
             }
         }
     }
 
-    void Config::saveSheetTimes(QXlsx::Document* doc) const
+    template <typename SheetWriter>
+    void Config::saveSheetLevelsHeader(SheetWriter& sheet, std::span<const int> presetCols) const
     {
-        constexpr auto kColSpace = 1;
-        constexpr auto kColPreset = 2;
-
-        // Header.
-        doc->write(1, kColSpace, tr("Space"));
-        for (unsigned int presetIx = 0; presetIx < presetCount(); ++presetIx)
+        sheet.beginRow();
+        sheet.writeString(kLevelsColCircuit, tr("Circuit"));
+        sheet.writeString(kLevelsColSpace, tr("Space"));
+        sheet.writeString(kLevelsColZone, tr("Zone"));
+        const auto allPresets = presets();
+        for (std::size_t ix = 0; ix < allPresets.size(); ++ix)
         {
-            const auto& preset = getPresetAt(presetIx);
-            doc->write(1, kColPreset + preset.num - 1, tr("Preset %1").arg(preset.num));
+            sheet.writeString(presetCols[ix], tr("Preset %1").arg(allPresets[ix].num));
         }
+        sheet.endRow();
+    }
 
-        // Values.
-        for (unsigned int spaceIx = 0; spaceIx < spaceCount(); ++spaceIx)
+    template <typename SheetWriter>
+    void Config::saveSheetLevels(SheetWriter& sheet, std::span<const int> presetCols) const
+    {
+        const auto allPresets = presets();
+        for (const auto& circuit : circuits())
         {
-            const auto& space = getSpaceAt(spaceIx);
-            const auto row = spaceIx + 2;
-            doc->write(row, kColSpace, space.num);
-            for (unsigned int presetIx = 0; presetIx < presetCount(); ++presetIx)
+            sheet.beginRow();
+            sheet.writeNumber(kLevelsColCircuit, circuit.num);
+            sheet.writeNumber(kLevelsColSpace, circuit.space);
+            sheet.writeNumber(kLevelsColZone, circuit.zone);
+            for (std::size_t ix = 0; ix < allPresets.size(); ++ix)
             {
-                const auto& preset = getPresetAt(presetIx);
-                doc->write(row, kColPreset + preset.num - 1, preset.fadeTimes.at(space.num));
+                sheet.writeNumber(presetCols[ix], allPresets[ix].levels.at(circuit.num));
             }
+            sheet.endRow();
         }
+
+        sheet.end();
     }
 
-    void Config::openSheetTimes(const QXlsx::Document* doc)
+    template <typename SheetReader>
+    Config::TimesSheet Config::readSheetTimes(SheetReader& sheet)
     {
         std::optional<int> colSpace;
         std::map<unsigned int, int> colPresets;
 
         // Columns
-        for (int colIx = 1; colIx <= doc->dimension().columnCount(); ++colIx)
+        const bool hasHeader = sheet.readRow() && sheet.rowNum() == 1;
+        for (int colIx = 1; hasHeader; ++colIx)
         {
-            const auto val = doc->read(1, colIx);
-            if (!val.isValid() || val.toString().isEmpty())
+            const auto val = sheet_helpers::cellText(sheet.cell(colIx));
+            if (val.isEmpty())
             {
                 break;
             }
@@ -272,7 +560,7 @@ namespace echoconfig
             }
             else
             {
-                auto match = kRePreset.match(val.toString());
+                auto match = kRePreset.match(val);
                 if (match.hasMatch())
                 {
                     const auto presetNum = match.captured(1).toUInt();
@@ -289,20 +577,107 @@ namespace echoconfig
             throw std::runtime_error("Missing preset column.");
         }
 
+        TimesSheet times;
+        std::ranges::copy(colPresets | std::views::keys, std::back_inserter(times.presetNums));
+        std::vector<int> presetCols;
+        presetCols.reserve(colPresets.size());
+        std::ranges::copy(colPresets | std::views::values, std::back_inserter(presetCols));
+
         // Data.
-        for (int rowIx = 2; rowIx <= doc->dimension().rowCount(); ++rowIx)
+        while (sheet.readRow())
+        {
+            times.spaceNums.push_back(sheet_helpers::requiredCellUInt(sheet.cell(colSpace.value())));
+            for (const auto colPreset : presetCols)
+            {
+                const auto uptime = sheet_helpers::requiredCellUInt(sheet.cell(colPreset));
+                if (uptime > std::numeric_limits<decltype(Preset::fadeTimes)::mapped_type>::max())
+                {
+                    throw std::runtime_error("Bad fade time.");
+                }
+                times.fadeTimes.push_back(uptime);
+            }
+        }
+
+        return times;
+    }
+
+    void Config::applySheetTimes(const TimesSheet& sheet)
+    {
+        if (sheet.spaceNums.empty())
+        {
+            return;
+        }
+
+        const auto rowPresets = resolvePresets(sheet.presetNums);
+        auto fadeTime = sheet.fadeTimes.cbegin();
+        for (const auto spaceNum : sheet.spaceNums)
         {
-            const auto spaceNum = sheet_helpers::requiredCellUInt(doc, rowIx, colSpace.value());
             auto& space = getSpace(spaceNum);
             space.num = spaceNum;
 
-            for (const auto [presetNum, colPreset] : colPresets)
+            for (auto* preset : rowPresets)
+            {
+                preset->fadeTimes[spaceNum] = *fadeTime++;
+            }
+        }
+    }
+
+    template <typename SheetWriter>
+    void Config::saveSheetTimesHeader(SheetWriter& sheet, std::span<const int> presetCols) const
+    {
+        sheet.beginRow();
+        sheet.writeString(kTimesColSpace, tr("Space"));
+        const auto allPresets = presets();
+        for (std::size_t ix = 0; ix < allPresets.size(); ++ix)
+        {
+            sheet.writeString(presetCols[ix], tr("Preset %1").arg(allPresets[ix].num));
+        }
+        sheet.endRow();
+    }
+
+    template <typename SheetWriter>
+    void Config::saveSheetTimes(SheetWriter& sheet, std::span<const int> presetCols) const
+    {
+        const auto allPresets = presets();
+        for (const auto& space : spaces())
+        {
+            sheet.beginRow();
+            sheet.writeNumber(kTimesColSpace, space.num);
+            for (std::size_t ix = 0; ix < allPresets.size(); ++ix)
             {
-                const auto uptime = sheet_helpers::requiredCellUInt(doc, rowIx, colPreset);
-                auto& preset = getPreset(presetNum);
-                preset.num = presetNum;
-                preset.fadeTimes[spaceNum] = uptime;
+                sheet.writeNumber(presetCols[ix], allPresets[ix].fadeTimes.at(space.num));
             }
+            sheet.endRow();
+        }
+
+        sheet.end();
+    }
+
+    std::vector<int> Config::presetColumns(int firstCol, PresetLayout layout) const
+    {
+        std::vector<int> presetCols;
+        presetCols.reserve(presets().size());
+        for (const auto& preset : presets())
+        {
+            presetCols.push_back(layout == PresetLayout::Compact ? firstCol + static_cast<int>(presetCols.size())
+                                                                 : firstCol + static_cast<int>(preset.num) - 1);
+        }
+        return presetCols;
+    }
+
+    std::vector<Preset*> Config::resolvePresets(std::span<const unsigned int> presetNums)
+    {
+        // Adding presets may move the others, so add them all before taking any pointers.
+        for (const auto presetNum : presetNums)
+        {
+            getPreset(presetNum).num = presetNum;
+        }
+        std::vector<Preset*> resolved;
+        resolved.reserve(presetNums.size());
+        for (const auto presetNum : presetNums)
+        {
+            resolved.push_back(&getPreset(presetNum));
         }
+        return resolved;
     }
 } // namespace echoconfig
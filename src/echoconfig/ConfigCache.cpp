@@ -0,0 +1,205 @@
+/**
+ * @file ConfigCache.cpp
+ *
+ * @author Dan Keenan
+ * @date 10/17/2026
+ * @copyright GNU GPLv3
+ */
+
+#include "echoconfig/ConfigCache.h"
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QStandardPaths>
+#include <QStringList>
+#include <stdexcept>
+#include "echoconfig/Config.h"
+#include "echoconfig/ConfigSnapshot.h"
+
+namespace echoconfig
+{
+    namespace
+    {
+        QStringList entryFilter() { return {QStringLiteral("*.snapshot")}; }
+
+        /**
+         * Map all of @p f into memory, or read it if it can't be mapped.  The result must not outlive @p f.
+         */
+        QByteArray readSource(QFile& f)
+        {
+            const auto* mapped = f.size() > 0 ? f.map(0, f.size()) : nullptr;
+            if (mapped != nullptr)
+            {
+                return QByteArray::fromRawData(reinterpret_cast<const char*>(mapped), f.size());
+            }
+            return f.readAll();
+        }
+
+        /**
+         * Keep only characters that are safe in a file name on every platform.
+         */
+        QString sanitized(const QString& text)
+        {
+            QString result = text;
+            for (auto& c : result)
+            {
+                if (!(c.isLetterOrNumber() && c.unicode() < 0x80) && c != u'_')
+                {
+                    c = u'_';
+                }
+            }
+            return result;
+        }
+
+        /**
+         * Mark an entry as recently used.
+         */
+        void touch(const QString& entry)
+        {
+            QFile f(entry);
+            if (f.open(QIODevice::Append))
+            {
+                f.setFileTime(QDateTime::currentDateTimeUtc(), QFileDevice::FileModificationTime);
+            }
+        }
+    } // namespace
+
+    ConfigCache::ConfigCache(const QString& dir, qint64 maxSize) : dir_(dir), maxSize_(maxSize) {}
+
+    QString ConfigCache::defaultDir(const QString& appName)
+    {
+        // QStandardPaths::CacheLocation is named after the running application, which would keep the GUI and the CLI
+        // from sharing a cache.
+        QStringList parts{QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation)};
+        if (const auto organization = QCoreApplication::organizationName(); !organization.isEmpty())
+        {
+            parts.append(organization);
+        }
+        parts.append(appName.isEmpty() ? QCoreApplication::applicationName() : appName);
+        parts.append(QStringLiteral("configs"));
+        return parts.join(u'/');
+    }
+
+    std::unique_ptr<Config> ConfigCache::load(const QString& path, const CfgHeader& header, bool retainBase,
+                                              const std::function<std::unique_ptr<Config>()>& parse)
+    {
+        QFile f(path);
+        if (!f.open(QIODevice::ReadOnly))
+        {
+            ++misses_;
+            return parse();
+        }
+        // Read once for the hash, a retained base and a new entry.
+        const auto source = readSource(f);
+        const auto hash = ConfigSnapshot::hashOf(source);
+
+        const auto entry = entryPath(hash, header);
+        if (auto cfg = find(entry, hash); cfg != nullptr)
+        {
+            ++hits_;
+            if (retainBase)
+            {
+                // A mapping doesn't outlive the file, so copy it.
+                cfg->retainBase(path, QByteArray(source.constData(), source.size()));
+            }
+            return cfg;
+        }
+
+        ++misses_;
+        auto cfg = parse();
+        if (cfg != nullptr && QDir().mkpath(dir_))
+        {
+            try
+            {
+                cfg->saveSnapshot(header, source, hash, entry);
+                evict();
+            }
+            catch (const std::exception&)
+            {
+                // The config is just as good without an entry.
+            }
+        }
+        return cfg;
+    }
+
+    ConfigCache::Stats ConfigCache::stats() const
+    {
+        return {
+            .hits = hits_,
+            .misses = misses_,
+            .evictions = evictions_,
+        };
+    }
+
+    qint64 ConfigCache::size() const
+    {
+        qint64 size = 0;
+        for (const auto& info : QDir(dir_).entryInfoList(entryFilter(), QDir::Files))
+        {
+            size += info.size();
+        }
+        return size;
+    }
+
+    void ConfigCache::clear()
+    {
+        std::scoped_lock lock(evictMutex_);
+        for (const auto& info : QDir(dir_).entryInfoList(entryFilter(), QDir::Files))
+        {
+            QFile::remove(info.filePath());
+        }
+    }
+
+    QString ConfigCache::entryPath(const QByteArray& hash, const CfgHeader& header) const
+    {
+        // The snapshot version is part of the name so entries from other versions are never opened, and age out.
+        const auto name = QStringLiteral("%1-%2-%3-v%4.snapshot")
+                              .arg(QString::fromLatin1(hash.toHex()), sanitized(header.rootTag),
+                                   sanitized(header.rackTag), QString::number(ConfigSnapshot::kVersion));
+        return QDir(dir_).filePath(name);
+    }
+
+    std::unique_ptr<Config> ConfigCache::find(const QString& entry, const QByteArray& hash)
+    {
+        if (!QFileInfo::exists(entry))
+        {
+            return nullptr;
+        }
+        try
+        {
+            const ConfigSnapshot snapshot(entry);
+            if (snapshot.sourceHash() == hash)
+            {
+                if (auto cfg = Config::fromSnapshot(snapshot); cfg != nullptr)
+                {
+                    touch(entry);
+                    return cfg;
+                }
+            }
+        }
+        catch (const std::exception&)
+        {
+            // Damaged or from another build; fall through and replace it.
+        }
+        QFile::remove(entry);
+        return nullptr;
+    }
+
+    void ConfigCache::evict()
+    {
+        std::scoped_lock lock(evictMutex_);
+        // Newest first.
+        const auto entries = QDir(dir_).entryInfoList(entryFilter(), QDir::Files, QDir::Time);
+        qint64 size = 0;
+        for (const auto& info : entries)
+        {
+            size += info.size();
+            if (size > maxSize_ && QFile::remove(info.filePath()))
+            {
+                ++evictions_;
+            }
+        }
+    }
+} // namespace echoconfig
@@ -0,0 +1,267 @@
+/**
+ * @file ConfigServer.cpp
+ *
+ * @author Dan Keenan
+ * @date 10/17/2026
+ * @copyright GNU GPLv3
+ */
+
+#include "echoconfig/ConfigServer.h"
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <QLocalSocket>
+#include <QPointer>
+#include <QThread>
+#include <exception>
+#include <stdexcept>
+
+namespace echoconfig
+{
+    namespace
+    {
+        /** Longer lines can't be requests; the connection is dropped rather than buffered forever. */
+        constexpr qint64 kMaxRequestSize = 64 * 1024;
+        /** How long a server already using the name has to answer before its socket is taken to be stale. */
+        constexpr int kProbeTimeoutMs = 1000;
+
+        QString requiredPath(const QJsonObject& request, const QString& key)
+        {
+            const auto path = request.value(key).toString();
+            if (path.isEmpty())
+            {
+                throw std::runtime_error(QStringLiteral("Missing \"%1\"").arg(key).toStdString());
+            }
+            return path;
+        }
+
+        SheetOptions sheetOptionsOf(const QJsonObject& request)
+        {
+            return {
+                .layout = request.value(QStringLiteral("compact")).toBool() ? PresetLayout::Compact
+                                                                            : PresetLayout::ByNumber,
+                .compression = request.value(QStringLiteral("store")).toBool() ? CompressionLevel::Store
+                                                                               : CompressionLevel::Default,
+            };
+        }
+    } // namespace
+
+    ConfigServer::ConfigServer(QObject* parent) : ConfigServer(Options(), parent) {}
+
+    ConfigServer::ConfigServer(const Options& options, QObject* parent) :
+        QObject(parent), options_(options), server_(this)
+    {
+        pool_.setMaxThreadCount(options_.threadCount > 0 ? static_cast<int>(options_.threadCount)
+                                                         : QThread::idealThreadCount());
+        connect(&server_, &QLocalServer::newConnection, this, &ConfigServer::acceptConnections);
+    }
+
+    ConfigServer::~ConfigServer()
+    {
+        server_.close();
+        // Requests still running use this object.
+        pool_.waitForDone();
+    }
+
+    bool ConfigServer::listen(const QString& name)
+    {
+        listenError_.clear();
+        // A socket left behind by a server that crashed is replaced; one that still answers belongs to a running
+        // server.  Checked first, as listening with socket options replaces whatever is at the name.
+        QLocalSocket probe;
+        probe.connectToServer(name);
+        if (probe.waitForConnected(kProbeTimeoutMs))
+        {
+            probe.disconnectFromServer();
+            listenError_ = QStringLiteral("Another server is listening on \"%1\"").arg(name);
+            return false;
+        }
+        QLocalServer::removeServer(name);
+
+        // Requests read and write files as this user, so no one else may send them.
+        server_.setSocketOptions(QLocalServer::UserAccessOption);
+        return server_.listen(name);
+    }
+
+    void ConfigServer::close() { server_.close(); }
+
+    QJsonObject ConfigServer::handle(const QJsonObject& request)
+    {
+        QElapsedTimer timer;
+        timer.start();
+        ++requests_;
+        QJsonObject response;
+        if (request.contains(QStringLiteral("id")))
+        {
+            response.insert(QStringLiteral("id"), request.value(QStringLiteral("id")));
+        }
+
+        try
+        {
+            const auto op = request.value(QStringLiteral("op")).toString();
+            if (op != QStringLiteral("info") && op != QStringLiteral("export-sheet") &&
+                op != QStringLiteral("import-sheet") && op != QStringLiteral("save-cfg"))
+            {
+                throw std::runtime_error(QStringLiteral("Unknown op \"%1\"").arg(op).toStdString());
+            }
+            const auto cfgPath = requiredPath(request, QStringLiteral("cfg"));
+            bool cached = false;
+            const auto config = hotConfig(cfgPath, cached);
+            response.insert(QStringLiteral("cached"), cached);
+
+            if (op == QStringLiteral("info"))
+            {
+                response.insert(QStringLiteral("result"),
+                                QJsonObject{
+                                    {QStringLiteral("type"), config->panelType()},
+                                    {QStringLiteral("name"), config->panelName()},
+                                    {QStringLiteral("circuits"), static_cast<qint64>(config->circuitCount())},
+                                    {QStringLiteral("spaces"), static_cast<qint64>(config->spaceCount())},
+                                    {QStringLiteral("presets"), static_cast<qint64>(config->presetCount())},
+                                });
+            }
+            else if (op == QStringLiteral("export-sheet"))
+            {
+                config->saveSheet(requiredPath(request, QStringLiteral("sheet")), sheetOptionsOf(request));
+            }
+            else
+            {
+                const auto outPath = requiredPath(request, QStringLiteral("out"));
+                if (op == QStringLiteral("import-sheet") || request.contains(QStringLiteral("sheet")))
+                {
+                    // Other requests may be using the kept config.
+                    const auto updated = config->clone();
+                    updated->parseSheet(requiredPath(request, QStringLiteral("sheet")));
+                    updated->saveCfg(cfgPath, outPath);
+                }
+                else
+                {
+                    config->saveCfg(cfgPath, outPath);
+                }
+            }
+            response.insert(QStringLiteral("ok"), true);
+        }
+        catch (const std::exception& e)
+        {
+            ++failures_;
+            response.insert(QStringLiteral("ok"), false);
+            response.insert(QStringLiteral("error"), QString::fromUtf8(e.what()));
+        }
+
+        response.insert(QStringLiteral("latencyMs"), static_cast<double>(timer.nsecsElapsed()) / 1e6);
+        return response;
+    }
+
+    ConfigServer::Stats ConfigServer::stats() const
+    {
+        return {
+            .requests = requests_,
+            .failures = failures_,
+            .configHits = configHits_,
+            .configMisses = configMisses_,
+        };
+    }
+
+    void ConfigServer::acceptConnections()
+    {
+        while (auto* socket = server_.nextPendingConnection())
+        {
+            connect(socket, &QLocalSocket::disconnected, socket, &QObject::deleteLater);
+            connect(socket, &QLocalSocket::readyRead, this, [this, socket]() { readRequests(socket); });
+        }
+    }
+
+    void ConfigServer::readRequests(QLocalSocket* socket)
+    {
+        while (socket->canReadLine())
+        {
+            const auto line = socket->readLine().trimmed();
+            if (line.isEmpty())
+            {
+                continue;
+            }
+            const auto doc = QJsonDocument::fromJson(line);
+            if (!doc.isObject())
+            {
+                ++requests_;
+                ++failures_;
+                send(socket, {
+                                 {QStringLiteral("ok"), false},
+                                 {QStringLiteral("error"), QStringLiteral("Invalid request")},
+                             });
+                continue;
+            }
+
+            const auto request = doc.object();
+            pool_.start(
+                [this, request, socket = QPointer(socket)]()
+                {
+                    const auto response = handle(request);
+                    // Sockets can only be written from their own thread.
+                    QMetaObject::invokeMethod(
+                        this,
+                        [this, request, response, socket]()
+                        {
+                            if (socket != nullptr)
+                            {
+                                send(socket, response);
+                            }
+                            Q_EMIT(requestFinished(request, response));
+                        },
+                        Qt::QueuedConnection);
+                });
+        }
+
+        if (socket->bytesAvailable() > kMaxRequestSize)
+        {
+            socket->disconnectFromServer();
+        }
+    }
+
+    void ConfigServer::send(QLocalSocket* socket, const QJsonObject& response)
+    {
+        socket->write(QJsonDocument(response).toJson(QJsonDocument::Compact) + '\n');
+    }
+
+    std::shared_ptr<const Config> ConfigServer::hotConfig(const QString& path, bool& cached)
+    {
+        // Taken before locking, as it reads from the file system, and before parsing, so a change while parsing is seen
+        // next time.
+        auto source = CfgSource::of(path);
+        const auto absPath = source.path;
+        {
+            std::scoped_lock lock(configsMutex_);
+            for (auto it = configs_.begin(); it != configs_.end(); ++it)
+            {
+                if (it->path != absPath)
+                {
+                    continue;
+                }
+                if (!it->source.isUnchanged(source))
+                {
+                    configs_.erase(it);
+                    break;
+                }
+                configs_.splice(configs_.begin(), configs_, it);
+                ++configHits_;
+                cached = true;
+                return configs_.front().config;
+            }
+        }
+
+        // Parsed without the lock, so one large config doesn't hold up requests for the others.  Two requests for the
+        // same new config both parse it; the second replaces the first.
+        ++configMisses_;
+        cached = false;
+        std::shared_ptr<const Config> config =
+            Config::loadCfgOrThrow(absPath, {.engine = ParseEngine::Mapped, .retainBase = true});
+
+        std::scoped_lock lock(configsMutex_);
+        std::erase_if(configs_, [&absPath](const HotConfig& hot) { return hot.path == absPath; });
+        configs_.push_front({.path = absPath, .source = std::move(source), .config = config});
+        while (configs_.size() > options_.maxConfigs)
+        {
+            configs_.pop_back();
+        }
+        return config;
+    }
+} // namespace echoconfig
@@ -0,0 +1,333 @@
+/**
+ * @file ConfigSnapshot.cpp
+ *
+ * @author Dan Keenan
+ * @date 10/17/2026
+ * @copyright GNU GPLv3
+ */
+
+#include "echoconfig/ConfigSnapshot.h"
+#include <QCryptographicHash>
+#include <QSaveFile>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <zlib.h>
+
+namespace echoconfig
+{
+    namespace
+    {
+        constexpr std::array<char, 8> kMagic = {'E', 'C', 'H', 'O', 'S', 'N', 'A', 'P'};
+        /** Reads back differently on a machine with the other byte order. */
+        constexpr quint32 kByteOrderMark = 0x01020304;
+        constexpr qsizetype kHashSize = 32;
+
+        // Circuits and spaces are stored as they are in memory, so they can be used straight from the file.
+        static_assert(std::is_trivially_copyable_v<Circuit> && sizeof(Circuit) == 3 * sizeof(quint32));
+        static_assert(std::is_trivially_copyable_v<Space> && sizeof(Space) == sizeof(quint32));
+
+        enum Section
+        {
+            kSectionText,
+            kSectionCircuits,
+            kSectionSpaces,
+            kSectionRackSpaces,
+            kSectionPresets,
+            kSectionLevelCircuits,
+            kSectionLevels,
+            kSectionFadeTimeSpaces,
+            kSectionFadeTimes,
+            kSectionCount,
+        };
+
+        struct SectionRef
+        {
+            quint64 offset;
+            /** Number of records. */
+            quint64 count;
+        };
+
+        /** A range of the text section. */
+        struct TextRef
+        {
+            quint32 offset;
+            quint32 size;
+        };
+
+        struct FileHeader
+        {
+            std::array<char, 8> magic;
+            quint32 version;
+            /** CRC-32 of everything after this field. */
+            quint32 checksum;
+            quint32 byteOrderMark;
+            quint32 headerSize;
+            quint64 fileSize;
+            quint64 sourceSize;
+            std::array<quint8, kHashSize> sourceHash;
+            TextRef rootTag;
+            TextRef rackTag;
+            TextRef cfgVersion;
+            TextRef panelName;
+            std::array<SectionRef, kSectionCount> sections;
+        };
+        static_assert(std::is_trivially_copyable_v<FileHeader> && sizeof(FileHeader) % 8 == 0);
+        constexpr auto kChecksumEnd = offsetof(FileHeader, checksum) + sizeof(FileHeader::checksum);
+
+        [[noreturn]] void malformed() { throw std::runtime_error("Invalid config snapshot"); }
+
+        quint32 checksumOf(QByteArrayView data)
+        {
+            const auto* begin = reinterpret_cast<const Bytef*>(data.data()) + kChecksumEnd;
+            return static_cast<quint32>(crc32_z(crc32(0, nullptr, 0), begin, data.size() - kChecksumEnd));
+        }
+
+        /**
+         * Builds the file in memory.
+         */
+        class SnapshotBuilder
+        {
+        public:
+            SnapshotBuilder() { data_.resize(sizeof(FileHeader)); }
+
+            FileHeader header{};
+
+            template <typename T>
+            void addSection(Section section, std::span<const T> records)
+            {
+                static_assert(std::is_trivially_copyable_v<T>);
+                // Align each array for its record type.
+                data_.append((alignof(T) - data_.size() % alignof(T)) % alignof(T), '\0');
+                header.sections[section] = {
+                    .offset = static_cast<quint64>(data_.size()),
+                    .count = records.size(),
+                };
+                data_.append(reinterpret_cast<const char*>(records.data()), records.size_bytes());
+            }
+
+            TextRef addText(const QString& text)
+            {
+                const TextRef ref{
+                    .offset = static_cast<quint32>(text_.size()),
+                    .size = static_cast<quint32>(text.size()),
+                };
+                text_.append(text);
+                return ref;
+            }
+
+            [[nodiscard]] const QString& text() const { return text_; }
+
+            QByteArray finish()
+            {
+                header.fileSize = data_.size();
+                std::memcpy(data_.data(), &header, sizeof(FileHeader));
+                const auto checksum = checksumOf(data_);
+                std::memcpy(data_.data() + offsetof(FileHeader, checksum), &checksum, sizeof(checksum));
+                return std::move(data_);
+            }
+
+        private:
+            QByteArray data_;
+            QString text_;
+        };
+
+        /**
+         * Get the records of @p section, checking that they lie within @p data.
+         */
+        template <typename T>
+        std::span<const T> sectionOf(QByteArrayView data, const FileHeader& header, Section section)
+        {
+            const auto& ref = header.sections[section];
+            if (ref.offset > static_cast<quint64>(data.size()) || ref.count > (data.size() - ref.offset) / sizeof(T))
+            {
+                malformed();
+            }
+            const auto* records = data.data() + ref.offset;
+            if (reinterpret_cast<quintptr>(records) % alignof(T) != 0)
+            {
+                malformed();
+            }
+            return {reinterpret_cast<const T*>(records), static_cast<std::size_t>(ref.count)};
+        }
+
+        QString textOf(std::span<const char16_t> text, const TextRef& ref)
+        {
+            if (ref.offset > text.size() || ref.size > text.size() - ref.offset)
+            {
+                malformed();
+            }
+            return QString(reinterpret_cast<const QChar*>(text.data() + ref.offset), ref.size);
+        }
+    } // namespace
+
+    void ConfigSnapshot::save(const QString& path, const Contents& contents)
+    {
+        std::vector<RackSpace> rackSpaces;
+        rackSpaces.reserve(contents.rackSpaces.size());
+        for (const auto& [rackSpaceNum, echoSpaceNum] : contents.rackSpaces)
+        {
+            rackSpaces.push_back({.rackSpaceNum = rackSpaceNum, .echoSpaceNum = echoSpaceNum});
+        }
+
+        // Flatten the preset maps into shared arrays.
+        std::vector<PresetRecord> presets;
+        presets.reserve(contents.presets.size());
+        std::vector<quint32> levelCircuits;
+        std::vector<quint8> levels;
+        std::vector<quint32> fadeTimeSpaces;
+        std::vector<quint16> fadeTimes;
+        for (const auto& preset : contents.presets)
+        {
+            presets.push_back({
+                .num = preset.num,
+                .firstLevel = static_cast<quint32>(levels.size()),
+                .levelCount = static_cast<quint32>(preset.levels.size()),
+                .firstFadeTime = static_cast<quint32>(fadeTimes.size()),
+                .fadeTimeCount = static_cast<quint32>(preset.fadeTimes.size()),
+            });
+            for (const auto [circuitNum, level] : preset.levels)
+            {
+                levelCircuits.push_back(circuitNum);
+                levels.push_back(level);
+            }
+            for (const auto [spaceNum, fadeTime] : preset.fadeTimes)
+            {
+                fadeTimeSpaces.push_back(spaceNum);
+                fadeTimes.push_back(fadeTime);
+            }
+        }
+
+        SnapshotBuilder builder;
+        auto& header = builder.header;
+        header.magic = kMagic;
+        header.version = kVersion;
+        header.byteOrderMark = kByteOrderMark;
+        header.headerSize = sizeof(FileHeader);
+        header.sourceSize = contents.source.size();
+        const auto sourceHash = contents.sourceHash.isEmpty() ? hashOf(contents.source) : contents.sourceHash;
+        std::memcpy(header.sourceHash.data(), sourceHash.constData(), kHashSize);
+        header.rootTag = builder.addText(contents.header.rootTag);
+        header.rackTag = builder.addText(contents.header.rackTag);
+        header.cfgVersion = builder.addText(contents.header.version);
+        header.panelName = builder.addText(contents.panelName);
+
+        const auto& text = builder.text();
+        builder.addSection(kSectionText, std::span(reinterpret_cast<const char16_t*>(text.utf16()), text.size()));
+        builder.addSection(kSectionCircuits, contents.circuits);
+        builder.addSection(kSectionSpaces, contents.spaces);
+        builder.addSection(kSectionRackSpaces, std::span<const RackSpace>(rackSpaces));
+        builder.addSection(kSectionPresets, std::span<const PresetRecord>(presets));
+        builder.addSection(kSectionLevelCircuits, std::span<const quint32>(levelCircuits));
+        builder.addSection(kSectionLevels, std::span<const quint8>(levels));
+        builder.addSection(kSectionFadeTimeSpaces, std::span<const quint32>(fadeTimeSpaces));
+        builder.addSection(kSectionFadeTimes, std::span<const quint16>(fadeTimes));
+        const auto data = builder.finish();
+
+        QSaveFile f(path);
+        if (!f.open(QIODevice::WriteOnly) || f.write(data) != data.size() || !f.commit())
+        {
+            throw std::runtime_error("Error saving config snapshot");
+        }
+    }
+
+    ConfigSnapshot::ConfigSnapshot(const QString& path) : file_(path)
+    {
+        if (!file_.open(QIODevice::ReadOnly))
+        {
+            throw std::runtime_error("Failed to open file");
+        }
+        const auto* mapped = file_.size() > 0 ? file_.map(0, file_.size()) : nullptr;
+        data_ = mapped != nullptr ? QByteArray::fromRawData(reinterpret_cast<const char*>(mapped), file_.size())
+                                  : file_.readAll();
+
+        FileHeader header;
+        if (data_.size() < static_cast<qsizetype>(sizeof(FileHeader)))
+        {
+            malformed();
+        }
+        std::memcpy(&header, data_.constData(), sizeof(FileHeader));
+        if (header.magic != kMagic || header.version != kVersion || header.byteOrderMark != kByteOrderMark ||
+            header.headerSize != sizeof(FileHeader) || header.fileSize != static_cast<quint64>(data_.size()) ||
+            header.checksum != checksumOf(data_))
+        {
+            malformed();
+        }
+
+        const auto text = sectionOf<char16_t>(data_, header, kSectionText);
+        header_ = {
+            .rootTag = textOf(text, header.rootTag),
+            .rackTag = textOf(text, header.rackTag),
+            .version = textOf(text, header.cfgVersion),
+        };
+        panelName_ = textOf(text, header.panelName);
+        sourceSize_ = static_cast<qint64>(header.sourceSize);
+        sourceHash_ = QByteArray(reinterpret_cast<const char*>(header.sourceHash.data()), kHashSize);
+
+        circuits_ = sectionOf<Circuit>(data_, header, kSectionCircuits);
+        spaces_ = sectionOf<Space>(data_, header, kSectionSpaces);
+        rackSpaces_ = sectionOf<RackSpace>(data_, header, kSectionRackSpaces);
+        presets_ = sectionOf<PresetRecord>(data_, header, kSectionPresets);
+        levelCircuits_ = sectionOf<quint32>(data_, header, kSectionLevelCircuits);
+        levels_ = sectionOf<quint8>(data_, header, kSectionLevels);
+        fadeTimeSpaces_ = sectionOf<quint32>(data_, header, kSectionFadeTimeSpaces);
+        fadeTimes_ = sectionOf<quint16>(data_, header, kSectionFadeTimes);
+        if (levelCircuits_.size() != levels_.size() || fadeTimeSpaces_.size() != fadeTimes_.size())
+        {
+            malformed();
+        }
+        // Presets store values indexed by these numbers, so a corrupt one would be a huge allocation.
+        for (const auto circuitNum : levelCircuits_)
+        {
+            if (circuitNum > decltype(Preset::levels)::kMaxKey)
+            {
+                malformed();
+            }
+        }
+        for (const auto spaceNum : fadeTimeSpaces_)
+        {
+            if (spaceNum > decltype(Preset::fadeTimes)::kMaxKey)
+            {
+                malformed();
+            }
+        }
+        for (const auto& preset : presets_)
+        {
+            if (preset.firstLevel > levels_.size() || preset.levelCount > levels_.size() - preset.firstLevel ||
+                preset.firstFadeTime > fadeTimes_.size() ||
+                preset.fadeTimeCount > fadeTimes_.size() - preset.firstFadeTime)
+            {
+                malformed();
+            }
+        }
+    }
+
+    QByteArray ConfigSnapshot::hashOf(QByteArrayView source)
+    {
+        return QCryptographicHash::hash(source, QCryptographicHash::Sha256);
+    }
+
+    bool ConfigSnapshot::isSnapshotOf(const QString& sourcePath) const
+    {
+        QFile f(sourcePath);
+        if (!f.open(QIODevice::ReadOnly) || f.size() != sourceSize_)
+        {
+            return false;
+        }
+        const auto* mapped = f.size() > 0 ? f.map(0, f.size()) : nullptr;
+        if (mapped != nullptr)
+        {
+            return isSnapshotOf(QByteArrayView(mapped, f.size()));
+        }
+        return isSnapshotOf(f.readAll());
+    }
+
+    bool ConfigSnapshot::isSnapshotOf(QByteArrayView source) const
+    {
+        return source.size() == sourceSize_ && hashOf(source) == sourceHash_;
+    }
+} // namespace echoconfig
@@ -0,0 +1,180 @@
+/**
+ * @file CsvReader.cpp
+ *
+ * @author Dan Keenan
+ * @date 10/17/2026
+ * @copyright GNU GPLv3
+ */
+
+#include "echoconfig/CsvReader.h"
+#include <QIODevice>
+#include <stdexcept>
+#include "echoconfig/sheet_helpers.h"
+
+namespace echoconfig
+{
+    namespace
+    {
+        /** Read from the device in chunks this big. */
+        constexpr qsizetype kReadSize = 64 * 1024;
+
+        [[noreturn]] void malformed() { throw std::runtime_error("Failed to read table"); }
+    } // namespace
+
+    CsvReader::CsvReader(QIODevice* device, char delimiter) : device_(device), delimiter_(delimiter)
+    {
+        fill();
+        if (buffer_.startsWith("\xEF\xBB\xBF"))
+        {
+            pos_ = 3;
+        }
+    }
+
+    bool CsvReader::readRow()
+    {
+        while (readRecord())
+        {
+            if (!row_.empty())
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool CsvReader::readRecord()
+    {
+        row_.clear();
+        if (peek() < 0)
+        {
+            return false;
+        }
+        ++rowNum_;
+
+        int col = 1;
+        while (true)
+        {
+            field_.resize(0);
+            if (peek() == '"')
+            {
+                ++pos_;
+                while (true)
+                {
+                    const auto c = peek();
+                    if (c < 0)
+                    {
+                        malformed();
+                    }
+                    ++pos_;
+                    if (c == '"')
+                    {
+                        if (peek() != '"')
+                        {
+                            break;
+                        }
+                        ++pos_;
+                    }
+                    field_.append(static_cast<char>(c));
+                }
+            }
+            else
+            {
+                // Copy the field a buffer at a time, rather than a byte at a time.
+                while (peek() >= 0)
+                {
+                    const auto start = pos_;
+                    while (pos_ < buffer_.size())
+                    {
+                        const auto c = buffer_.at(pos_);
+                        if (c == delimiter_ || c == '\n' || c == '\r')
+                        {
+                            break;
+                        }
+                        ++pos_;
+                    }
+                    field_.append(buffer_.constData() + start, pos_ - start);
+                    if (pos_ < buffer_.size())
+                    {
+                        break;
+                    }
+                }
+            }
+            addCell(col);
+
+            const auto c = peek();
+            if (c < 0)
+            {
+                break;
+            }
+            ++pos_;
+            if (c == delimiter_)
+            {
+                ++col;
+                if (col > SheetRow::kMaxColumns)
+                {
+                    malformed();
+                }
+                continue;
+            }
+            if (c == '\r')
+            {
+                if (peek() == '\n')
+                {
+                    ++pos_;
+                }
+                break;
+            }
+            if (c == '\n')
+            {
+                break;
+            }
+            // Text after a closing quote.
+            malformed();
+        }
+        return true;
+    }
+
+    void CsvReader::addCell(int col)
+    {
+        if (field_.isEmpty())
+        {
+            return;
+        }
+
+        if (const auto number = sheet_helpers::parseDigits(field_); number.has_value())
+        {
+            row_.add(Cell{.col = col, .type = CellType::Number, .number = number.value()});
+        }
+        else
+        {
+            row_.add(Cell{.col = col, .type = CellType::String, .text = QString::fromUtf8(field_)});
+        }
+    }
+
+    int CsvReader::peek()
+    {
+        if (pos_ >= buffer_.size() && !fill())
+        {
+            return -1;
+        }
+        return static_cast<unsigned char>(buffer_.at(pos_));
+    }
+
+    bool CsvReader::fill()
+    {
+        if (atEnd_)
+        {
+            return false;
+        }
+        buffer_.resize(kReadSize);
+        const auto count = device_->read(buffer_.data(), kReadSize);
+        if (count < 0)
+        {
+            throw std::runtime_error("Failed to read file");
+        }
+        buffer_.resize(count);
+        pos_ = 0;
+        atEnd_ = count == 0;
+        return !atEnd_;
+    }
+} // namespace echoconfig
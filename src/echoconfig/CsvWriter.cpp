@@ -0,0 +1,101 @@
+/**
+ * @file CsvWriter.cpp
+ *
+ * @author Dan Keenan
+ * @date 10/17/2026
+ * @copyright GNU GPLv3
+ */
+
+#include "echoconfig/CsvWriter.h"
+#include <QIODevice>
+#include <stdexcept>
+
+namespace echoconfig
+{
+    namespace
+    {
+        /** Write to the device in chunks about this big. */
+        constexpr qsizetype kFlushSize = 64 * 1024;
+    } // namespace
+
+    CsvWriter::CsvWriter(QIODevice* device, char delimiter) : device_(device), delimiter_(delimiter)
+    {
+        buffer_.reserve(kFlushSize + 1024);
+    }
+
+    void CsvWriter::beginRow() { col_ = 0; }
+
+    void CsvWriter::endRow()
+    {
+        buffer_.append("\r\n");
+        flush(false);
+    }
+
+    void CsvWriter::writeString(int col, const QString& value)
+    {
+        moveTo(col);
+        const auto utf8 = value.toUtf8();
+        const auto needsQuotes = utf8.contains(delimiter_) || utf8.contains('"') || utf8.contains('\r') ||
+                                 utf8.contains('\n');
+        if (!needsQuotes)
+        {
+            buffer_.append(utf8);
+            return;
+        }
+        buffer_.append('"');
+        for (const auto c : utf8)
+        {
+            if (c == '"')
+            {
+                buffer_.append('"');
+            }
+            buffer_.append(c);
+        }
+        buffer_.append('"');
+    }
+
+    void CsvWriter::writeNumber(int col, unsigned int value)
+    {
+        moveTo(col);
+        buffer_.append(QByteArray::number(value));
+    }
+
+    void CsvWriter::end()
+    {
+        if (ended_)
+        {
+            return;
+        }
+        flush(true);
+        ended_ = true;
+        buffer_ = QByteArray();
+    }
+
+    void CsvWriter::moveTo(int col)
+    {
+        if (col <= col_)
+        {
+            throw std::runtime_error("Columns must be written in order");
+        }
+        // Empty fields for skipped columns, and the separator before this one.
+        buffer_.append(col_ == 0 ? col - 1 : col - col_, delimiter_);
+        col_ = col;
+    }
+
+    void CsvWriter::flush(bool force)
+    {
+        if (ended_)
+        {
+            throw std::runtime_error("Table already ended");
+        }
+        if (force || buffer_.size() >= kFlushSize)
+        {
+            if (device_->write(buffer_) != buffer_.size())
+            {
+                throw std::runtime_error("Failed to write file");
+            }
+            // Keeps the allocation, unlike clear().
+            buffer_.resize(0);
+        }
+    }
+} // namespace echoconfig
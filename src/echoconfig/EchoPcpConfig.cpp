@@ -10,179 +10,1066 @@
 
 #include <QFile>
 #include <QSaveFile>
+#include <QThread>
 #include <QVersionNumber>
 #include <QXmlStreamReader>
-#include <ranges>
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <exception>
+#include <future>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <string_view>
+#include "echoconfig/BlockIo.h"
+#include "echoconfig/ConfigSnapshot.h"
+#include "echoconfig/StructuralIndex.h"
+#include "echoconfig/XmlScanner.h"
+#include "echoconfig/thread_helpers.h"
 #include "echoconfig/xml_helpers.h"
 
 namespace echoconfig
 {
-    void EchoPcpConfig::parseCfg(const QString& path)
+    namespace
     {
-        Config::parseCfg(path);
+        /**
+         * A tag or attribute name, in the encodings both parse engines need.
+         */
+        struct ParseName
+        {
+            explicit ParseName(const QString& name) : str(name), utf8(name.toUtf8()) {}
 
-        QFile f(path);
-        if (!f.open(QIODevice::ReadOnly))
+            QString str;
+            QByteArray utf8;
+
+            [[nodiscard]] std::string_view view() const
+            {
+                return {utf8.constData(), static_cast<std::size_t>(utf8.size())};
+            }
+        };
+
+        const ParseName kName(QStringLiteral("NAME"));
+        const ParseName kNumber(QStringLiteral("NUMBER"));
+        const ParseName kNumberExt(QStringLiteral("NUMBEREXT"));
+        const ParseName kLevel(QStringLiteral("LEVEL"));
+        const ParseName kPreFadeLevel(QStringLiteral("PREFADELEVEL"));
+        const ParseName kPreLevel(QStringLiteral("PRELEVEL"));
+        const ParseName kPreset(QStringLiteral("PRESET"));
+        const ParseName kSpace(QStringLiteral("SPACE"));
+        const ParseName kSpaceInRack(QStringLiteral("SPACEINRACK"));
+        const ParseName kSpaceInRackExt(QStringLiteral("SPACEINRACKEXT"));
+        const ParseName kVersion(QStringLiteral("VERSION"));
+        const ParseName kZone(QStringLiteral("ZONE"));
+
+        /** Smaller pieces of presets aren't worth handing to another thread. */
+        constexpr std::size_t kMinChunkSize = 64 * 1024;
+
+        /**
+         * Find the next PRESET start tag in @p data, starting at @p from.
+         *
+         * This only looks at bytes, so it may find one inside a comment.  Scanning the piece before it then fails,
+         * because the comment doesn't end inside that piece.
+         */
+        std::size_t findPresetTag(std::string_view data, std::size_t from)
         {
-            throw std::runtime_error("Failed to open file");
+            const auto tag = "<" + kPreset.utf8;
+            const std::string_view tagView(tag.constData(), tag.size());
+            for (auto pos = data.find(tagView, from); pos != std::string_view::npos;
+                 pos = data.find(tagView, pos + tagView.size()))
+            {
+                const auto after = pos + tagView.size();
+                if (after < data.size() && std::string_view(" \t\n\r/>").find(data[after]) != std::string_view::npos)
+                {
+                    return pos;
+                }
+            }
+            return std::string_view::npos;
+        }
+
+        /**
+         * The current element of a QXmlStreamReader.
+         */
+        class StreamElement
+        {
+        public:
+            explicit StreamElement(QXmlStreamReader& xml) : xml_(xml) {}
+
+            [[nodiscard]] bool nameIs(const ParseName& name) const { return xml_.name() == name.str; }
+            [[nodiscard]] bool hasAttr(const ParseName& name) const
+            {
+                return xml_.attributes().hasAttribute(name.str);
+            }
+            [[nodiscard]] QString attr(const ParseName& name) const
+            {
+                return xml_.attributes().value(name.str).toString();
+            }
+            [[nodiscard]] unsigned int requiredAttrUInt(const ParseName& name) const
+            {
+                return xml_helpers::requiredAttrUInt(xml_, name.str);
+            }
+
+        private:
+            QXmlStreamReader& xml_;
+        };
+
+        /**
+         * The current element of an XmlScanner.
+         */
+        class ScannedElement
+        {
+        public:
+            explicit ScannedElement(const XmlScanner& scanner) : scanner_(scanner) {}
+
+            [[nodiscard]] bool nameIs(const ParseName& name) const { return scanner_.name() == name.view(); }
+            [[nodiscard]] bool hasAttr(const ParseName& name) const { return scanner_.hasAttribute(name.view()); }
+            [[nodiscard]] QString attr(const ParseName& name) const { return scanner_.attribute(name.view()); }
+            [[nodiscard]] unsigned int requiredAttrUInt(const ParseName& name) const
+            {
+                return scanner_.requiredAttrUInt(name.view());
+            }
+
+        private:
+            const XmlScanner& scanner_;
+        };
+
+        /**
+         * Map all of @p f into memory, or read it if it can't be mapped.
+         *
+         * A mapping lasts until @p f is closed, so the result must not outlive @p f.
+         */
+        QByteArray mapFile(QFile& f)
+        {
+            if (f.size() > 0)
+            {
+                const auto* mapped = f.map(0, f.size());
+                if (mapped != nullptr)
+                {
+                    return QByteArray::fromRawData(reinterpret_cast<const char*>(mapped), f.size());
+                }
+            }
+            return f.readAll();
         }
+    } // namespace
 
-        QXmlStreamReader xml(&f);
+    /**
+     * Tag and attribute names that differ between config dialects.
+     */
+    struct EchoPcpConfig::DialectNames
+    {
+        const ParseName rootTag;
+        const ParseName rackTag;
+        const ParseName outputTag;
+        const ParseName outputAttr;
+        const ParseName fadeTimeAttr;
+    };
+
+    /**
+     * State carried between elements while parsing.
+     */
+    struct EchoPcpConfig::ParseState
+    {
+        explicit ParseState(const EchoPcpConfig& config) : names(config.dialectNames()) {}
+
+        const DialectNames names;
         bool parsedRoot = false;
         std::optional<Preset> currentPreset;
-        while (!xml.atEnd())
+        // Largest numbers seen so far, used to size each preset's level and time storage up front.
+        unsigned int maxCircuitNum = 0;
+        unsigned int maxEchoSpaceNum = 0;
+        /** Finished presets, in the order they were parsed. */
+        std::vector<Preset> presets;
+
+        void finishPreset()
         {
-            const auto tokenType = xml.readNext();
-            if (tokenType == QXmlStreamReader::StartElement)
+            if (currentPreset.has_value())
             {
-                const auto tagName = xml.name();
-                if (!parsedRoot && tagName != rootTagName())
+                presets.push_back(std::move(currentPreset.value()));
+                currentPreset.reset();
+            }
+        }
+    };
+
+    /**
+     * Records where the values saveCfg() may replace are in a scanned document.
+     */
+    class EchoPcpConfig::SpliceRecorder
+    {
+    public:
+        SpliceRecorder(const DialectNames& names, std::string_view data, std::vector<SplicePoint>& points) :
+            names_(names), data_(data), points_(points)
+        {}
+
+        void record(const XmlScanner& scanner)
+        {
+            const auto tagName = scanner.name();
+            if (tagName == names_.outputTag.view())
+            {
+                const auto circuitNum = scanner.requiredAttrUInt(kNumber.view());
+                add(SplicePoint::Kind::CircuitSpace, circuitNum, scanner.rawAttribute(kSpace.view()));
+                add(SplicePoint::Kind::CircuitZone, circuitNum, scanner.rawAttribute(kZone.view()));
+            }
+            else if (tagName == kSpace.view())
+            {
+                const auto rackSpace = scanner.rawAttribute(kSpaceInRack.view());
+                const auto rackSpaceExt = scanner.rawAttribute(kSpaceInRackExt.view());
+                if (!rackSpace.has_value() && !rackSpaceExt.has_value())
                 {
-                    throw std::runtime_error("Incorrect root tag.");
+                    throw std::runtime_error("Failed to read space attribute");
                 }
-                else
+                const auto rackSpaceNum =
+                    scanner.requiredAttrUInt(rackSpace.has_value() ? kSpaceInRack.view() : kSpaceInRackExt.view());
+                add(SplicePoint::Kind::RackSpace, rackSpaceNum, rackSpace);
+                add(SplicePoint::Kind::RackSpaceExt, rackSpaceNum, rackSpaceExt);
+                add(SplicePoint::Kind::EchoSpace, rackSpaceNum, scanner.rawAttribute(kNumber.view()));
+                add(SplicePoint::Kind::EchoSpaceExt, rackSpaceNum, scanner.rawAttribute(kNumberExt.view()));
+            }
+            else if (tagName == kPreset.view())
+            {
+                presetNum_ = scanner.requiredAttrUInt(kNumber.view());
+            }
+            else if (tagName == kPreFadeLevel.view() && presetNum_.has_value())
+            {
+                const auto fadeTime = scanner.rawAttribute(names_.fadeTimeAttr.view());
+                if (fadeTime.has_value())
                 {
-                    parsedRoot = true;
+                    add(SplicePoint::Kind::FadeTime, scanner.requiredAttrUInt(kSpaceInRack.view()), fadeTime);
                 }
+            }
+            else if (tagName == kPreLevel.view() && presetNum_.has_value())
+            {
+                const auto circuitNum = scanner.requiredAttrUInt(names_.outputAttr.view());
+                add(SplicePoint::Kind::Level, circuitNum, scanner.rawAttribute(kLevel.view()));
+            }
+        }
 
-                if (tagName == rackTagName())
-                {
-                    if (!isVersionCompatible(xml.attributes().value(QStringLiteral("VERSION"))))
-                    {
-                        throw std::runtime_error("Incorrect version.");
-                    }
-                    name_ = xml.attributes().value(QStringLiteral("NAME")).toString();
-                }
-                else if (tagName == outputTagName())
+    private:
+        const DialectNames& names_;
+        std::string_view data_;
+        std::vector<SplicePoint>& points_;
+        std::optional<std::uint32_t> presetNum_;
+
+        void add(SplicePoint::Kind kind, std::uint32_t key, std::optional<std::string_view> rawValue)
+        {
+            if (!rawValue.has_value())
+            {
+                return;
+            }
+            points_.push_back({
+                .kind = kind,
+                .key = key,
+                .presetNum = presetNum_.value_or(0),
+                .offset = static_cast<qsizetype>(rawValue->data() - data_.data()),
+                .length = static_cast<std::uint32_t>(rawValue->size()),
+            });
+        }
+    };
+
+    EchoPcpConfig::DialectNames EchoPcpConfig::dialectNames() const
+    {
+        return {
+            .rootTag = ParseName(rootTagName()),
+            .rackTag = ParseName(rackTagName()),
+            .outputTag = ParseName(outputTagName()),
+            .outputAttr = ParseName(outputAttrName()),
+            .fadeTimeAttr = ParseName(fadeTimeAttrName()),
+        };
+    }
+
+    void EchoPcpConfig::parseCfg(const QString& path)
+    {
+        Config::parseCfg(path);
+        source_.reset();
+        baseCfg_.clear();
+        spliceIndex_.reset();
+
+        QFile f(path);
+        if (!f.open(QIODevice::ReadOnly))
+        {
+            throw std::runtime_error("Failed to open file");
+        }
+        QByteArray data;
+        if (parseEngine() == ParseEngine::Mapped)
+        {
+            data = mapFile(f);
+        }
+        const std::string_view bytes(data.constData(), data.size());
+        std::shared_ptr<const StructuralIndex> structure;
+        if (parseEngine() == ParseEngine::Mapped)
+        {
+            // Built once, for counting elements here and for every scanner below.
+            structure = std::make_shared<const StructuralIndex>(bytes, 0, bytes.size());
+            reserveFor(bytes, *structure);
+        }
+
+        ParseState state(*this);
+        std::optional<SpliceIndex> index;
+        if (parseEngine() == ParseEngine::Mapped && XmlScanner::isUtf8Document(bytes))
+        {
+            // The scanner knows where each value is, so record that for saveCfg() while we're here.
+            index.emplace();
+            if (auto presets = parseChunked(bytes, index->points, structure); presets.has_value())
+            {
+                state.presets = std::move(presets.value());
+            }
+            else
+            {
+                index->points.clear();
+                SpliceRecorder recorder(state.names, bytes, index->points);
+                XmlScanner scanner(bytes, structure);
+                while (scanner.readNextStartElement())
                 {
-                    const auto circuitNum = xml_helpers::requiredAttrUInt(xml, QStringLiteral("NUMBER"));
-                    const auto spaceNum = xml_helpers::requiredAttrUInt(xml, QStringLiteral("SPACE"));
-                    const auto zoneNum = xml_helpers::requiredAttrUInt(xml, QStringLiteral("ZONE"));
-                    auto& circuit = circuits_[circuitNum];
-                    circuit.num = circuitNum;
-                    circuit.space = spaceNum;
-                    circuit.zone = zoneNum;
+                    parseElement(ScannedElement(scanner), state);
+                    recorder.record(scanner);
                 }
-                else if (tagName == QStringLiteral("SPACE"))
+            }
+        }
+        else
+        {
+            QXmlStreamReader xml;
+            const auto parseAvailable = [this, &xml, &state]()
+            {
+                while (!xml.atEnd())
                 {
-                    static const auto kSpaceInRack = QStringLiteral("SPACEINRACK");
-                    static const auto kSpaceInRackExt = QStringLiteral("SPACEINRACKEXT");
-                    static const auto kNumber = QStringLiteral("NUMBER");
-                    static const auto kNumberExt = QStringLiteral("NUMBEREXT");
-                    QString spaceAttr;
-                    QString numberAttr;
-                    if (xml.attributes().hasAttribute(kSpaceInRack))
+                    if (xml.readNext() == QXmlStreamReader::StartElement)
                     {
-                        spaceAttr = kSpaceInRack;
-                        numberAttr = kNumber;
+                        parseElement(StreamElement(xml), state);
                     }
-                    else if (xml.attributes().hasAttribute(kSpaceInRackExt))
+                }
+            };
+            bool readAny = false;
+            if (parseEngine() == ParseEngine::Mapped)
+            {
+                xml.addData(data);
+                parseAvailable();
+                readAny = true;
+            }
+            else
+            {
+                // The next blocks are read on another thread while this one is parsed.
+                ReadAhead readAhead(f);
+                for (auto block = readAhead.next(); !block.isEmpty(); block = readAhead.next())
+                {
+                    if (!readAny)
                     {
-                        spaceAttr = kSpaceInRackExt;
-                        numberAttr = kNumberExt;
+                        // Reserving again for each block would reallocate every time; the first one is a good enough
+                        // sample of the rest.
+                        reserveFor(block, f.size());
                     }
-                    else
+                    readAny = true;
+                    if (parseOptions().retainBase)
                     {
-                        throw std::runtime_error("Failed to read space attribute");
+                        data += block;
                     }
-                    const unsigned int echoSpaceNum = xml_helpers::requiredAttrUInt(xml, numberAttr);
-
-                    if (echoSpaceNum == 0)
+                    xml.addData(block);
+                    parseAvailable();
+                    // Running out of data is only an error once there's no more to add.
+                    if (xml.error() != QXmlStreamReader::PrematureEndOfDocumentError)
                     {
-                        continue;
+                        break;
                     }
-                    const unsigned int rackSpaceNum = xml_helpers::requiredAttrUInt(xml, spaceAttr);
-                    rackSpaces_.insert_or_assign(rackSpaceNum, echoSpaceNum);
-                    auto& space = spaces_[echoSpaceNum];
-                    space.num = echoSpaceNum;
                 }
-                else if (tagName == QStringLiteral("PRESET"))
+                if (parseOptions().ioStats != nullptr)
                 {
-                    if (currentPreset.has_value())
-                    {
-                        presets_.insert_or_assign(currentPreset->num, currentPreset.value());
-                    }
-                    const auto presetNum = xml_helpers::requiredAttrUInt(xml, QStringLiteral("NUMBER"));
-                    currentPreset.emplace();
-                    currentPreset->num = presetNum;
+                    *parseOptions().ioStats = readAhead.stats();
                 }
-                else if (tagName == QStringLiteral("PREFADELEVEL"))
+            }
+            if (!readAny || xml.hasError())
+            {
+                throw std::runtime_error("Failed to read file");
+            }
+        }
+        state.finishPreset();
+        for (auto& preset : state.presets)
+        {
+            presets_.insertOrAssign(std::move(preset));
+        }
+
+        // Only hash the contents if something depends on them.
+        const bool retainBase = parseOptions().retainBase;
+        source_ = CfgSource::of(path, retainBase || index.has_value() ? std::optional(QByteArrayView(data))
+                                                                      : std::nullopt);
+        if (retainBase)
+        {
+            // A mapping doesn't outlive the file, so copy it.
+            baseCfg_ = parseEngine() == ParseEngine::Mapped ? QByteArray(data.constData(), data.size()) : data;
+        }
+        if (index.has_value())
+        {
+            spliceIndex_ = std::make_shared<const SpliceIndex>(std::move(index.value()));
+        }
+    }
+
+    template <typename Element>
+    void EchoPcpConfig::parseElement(const Element& element, ParseState& state)
+    {
+        if (!state.parsedRoot && !element.nameIs(state.names.rootTag))
+        {
+            throw std::runtime_error("Incorrect root tag.");
+        }
+        else
+        {
+            state.parsedRoot = true;
+        }
+
+        if (element.nameIs(state.names.rackTag))
+        {
+            if (!isVersionCompatible(element.attr(kVersion)))
+            {
+                throw std::runtime_error("Incorrect version.");
+            }
+            name_ = element.attr(kName);
+        }
+        else if (element.nameIs(state.names.outputTag))
+        {
+            const auto circuitNum = element.requiredAttrUInt(kNumber);
+            if (circuitNum > decltype(Preset::levels)::kMaxKey)
+            {
+                throw std::runtime_error("Bad circuit number.");
+            }
+            const auto spaceNum = element.requiredAttrUInt(kSpace);
+            const auto zoneNum = element.requiredAttrUInt(kZone);
+            auto& circuit = circuits_.getOrInsert(circuitNum);
+            circuit.space = spaceNum;
+            circuit.zone = zoneNum;
+            state.maxCircuitNum = std::max(state.maxCircuitNum, circuitNum);
+        }
+        else if (element.nameIs(kSpace))
+        {
+            const ParseName* spaceAttr;
+            const ParseName* numberAttr;
+            if (element.hasAttr(kSpaceInRack))
+            {
+                spaceAttr = &kSpaceInRack;
+                numberAttr = &kNumber;
+            }
+            else if (element.hasAttr(kSpaceInRackExt))
+            {
+                spaceAttr = &kSpaceInRackExt;
+                numberAttr = &kNumberExt;
+            }
+            else
+            {
+                throw std::runtime_error("Failed to read space attribute");
+            }
+            const unsigned int echoSpaceNum = element.requiredAttrUInt(*numberAttr);
+
+            if (echoSpaceNum == 0)
+            {
+                return;
+            }
+            if (echoSpaceNum > decltype(Preset::fadeTimes)::kMaxKey)
+            {
+                throw std::runtime_error("Bad space number.");
+            }
+            const unsigned int rackSpaceNum = element.requiredAttrUInt(*spaceAttr);
+            rackSpaces_.insert_or_assign(rackSpaceNum, echoSpaceNum);
+            spaces_.getOrInsert(echoSpaceNum);
+            state.maxEchoSpaceNum = std::max(state.maxEchoSpaceNum, echoSpaceNum);
+        }
+        else
+        {
+            parsePresetElement(element, state);
+        }
+    }
+
+    template <typename Element>
+    bool EchoPcpConfig::parsePresetElement(const Element& element, ParseState& state) const
+    {
+        if (element.nameIs(kPreset))
+        {
+            state.finishPreset();
+            const auto presetNum = element.requiredAttrUInt(kNumber);
+            state.currentPreset.emplace();
+            state.currentPreset->num = presetNum;
+            state.currentPreset->levels.reserve(state.maxCircuitNum);
+            state.currentPreset->fadeTimes.reserve(state.maxEchoSpaceNum);
+        }
+        else if (element.nameIs(kPreFadeLevel))
+        {
+            if (!state.currentPreset.has_value())
+            {
+                throw std::runtime_error("No current preset.");
+            }
+            const auto fadeTime = element.requiredAttrUInt(state.names.fadeTimeAttr);
+            if (fadeTime > std::numeric_limits<decltype(Preset::fadeTimes)::mapped_type>::max())
+            {
+                throw std::runtime_error("Bad fade time.");
+            }
+            const auto rackSpaceNum = element.requiredAttrUInt(kSpaceInRack);
+            const auto echoSpaceNum = rackSpaces_.echoSpace(rackSpaceNum);
+            if (echoSpaceNum.has_value())
+            {
+                state.currentPreset->fadeTimes[echoSpaceNum.value()] = fadeTime;
+            }
+        }
+        else if (element.nameIs(kPreLevel))
+        {
+            if (!state.currentPreset.has_value())
+            {
+                throw std::runtime_error("No current preset.");
+            }
+            const auto level = element.requiredAttrUInt(kLevel);
+            if (level > 255)
+            {
+                throw std::runtime_error("Bad level.");
+            }
+            const auto circuit = element.requiredAttrUInt(state.names.outputAttr);
+            if (circuit > decltype(Preset::levels)::kMaxKey)
+            {
+                throw std::runtime_error("Bad circuit number.");
+            }
+            state.currentPreset->levels[circuit] = level;
+        }
+        else
+        {
+            return false;
+        }
+        return true;
+    }
+
+    std::optional<std::vector<Preset>> EchoPcpConfig::parseChunked(std::string_view data,
+                                                                   std::vector<SplicePoint>& points,
+                                                                   std::shared_ptr<const StructuralIndex> index)
+    {
+        const auto threadCount = parseOptions().threadCount > 0
+            ? parseOptions().threadCount
+            : static_cast<unsigned int>(QThread::idealThreadCount());
+        const auto firstPreset = findPresetTag(data, 0);
+        if (threadCount < 2 || firstPreset == std::string_view::npos)
+        {
+            return std::nullopt;
+        }
+
+        // Split the presets into about even pieces, each starting at a preset.  The last piece also has everything
+        // after the presets.
+        const auto presetsSize = data.size() - firstPreset;
+        const auto chunkCount = std::min<std::size_t>(threadCount, presetsSize / kMinChunkSize);
+        std::vector<std::size_t> bounds{firstPreset};
+        for (std::size_t ix = 1; ix < chunkCount; ++ix)
+        {
+            const auto bound =
+                findPresetTag(data, std::max(bounds.back() + 1, firstPreset + presetsSize * ix / chunkCount));
+            if (bound == std::string_view::npos)
+            {
+                break;
+            }
+            bounds.push_back(bound);
+        }
+        bounds.push_back(data.size());
+        if (bounds.size() < 3)
+        {
+            return std::nullopt;
+        }
+
+        struct Chunk
+        {
+            std::vector<Preset> presets;
+            std::vector<SplicePoint> points;
+        };
+        std::vector<Chunk> chunks(bounds.size() - 1);
+        try
+        {
+            // Presets need the rack spaces, so everything before them is parsed first.
+            ParseState headerState(*this);
+            SpliceRecorder recorder(headerState.names, data, points);
+            XmlScanner header(data, 0, firstPreset, {}, index);
+            while (header.readNextStartElement())
+            {
+                parseElement(ScannedElement(header), headerState);
+                recorder.record(header);
+            }
+            if (!headerState.parsedRoot || header.openElements().empty())
+            {
+                return std::nullopt;
+            }
+
+            const auto parseChunk = [&](std::size_t ix)
+            {
+                try
                 {
-                    if (!currentPreset.has_value())
+                    ParseState state(*this);
+                    state.parsedRoot = true;
+                    state.maxCircuitNum = headerState.maxCircuitNum;
+                    state.maxEchoSpaceNum = headerState.maxEchoSpaceNum;
+                    auto& chunk = chunks[ix];
+                    SpliceRecorder chunkRecorder(state.names, data, chunk.points);
+                    XmlScanner scanner(data, bounds[ix], bounds[ix + 1], header.openElements(), index);
+                    while (scanner.readNextStartElement())
                     {
-                        throw std::runtime_error("No current preset.");
-                    }
-                    const auto fadeTime = xml_helpers::requiredAttrUInt(xml, fadeTimeAttrName());
-                    const auto rackSpaceNum = xml_helpers::requiredAttrUInt(xml, QStringLiteral("SPACEINRACK"));
-                    const auto echoSpaceNum = rackSpaces_.find(rackSpaceNum);
-                    if (echoSpaceNum == rackSpaces_.end())
-                    {
-                        continue;
+                        const ScannedElement element(scanner);
+                        if (!parsePresetElement(element, state) &&
+                            (element.nameIs(state.names.rackTag) || element.nameIs(state.names.outputTag) ||
+                             element.nameIs(kSpace)))
+                        {
+                            // Presets after this depend on it.
+                            return false;
+                        }
+                        chunkRecorder.record(scanner);
                     }
-                    currentPreset->fadeTimes[echoSpaceNum->second] = fadeTime;
+                    state.finishPreset();
+                    chunk.presets = std::move(state.presets);
+                    // Each piece has to end where the next one starts.
+                    return ix + 1 == chunks.size() || scanner.openElements() == header.openElements();
                 }
-                else if (tagName == QStringLiteral("PRELEVEL"))
+                catch (const std::exception&)
                 {
-                    if (!currentPreset.has_value())
-                    {
-                        throw std::runtime_error("No current preset.");
-                    }
-                    const auto level = xml_helpers::requiredAttrUInt(xml, QStringLiteral("LEVEL"));
-                    const auto circuit = xml_helpers::requiredAttrUInt(xml, outputAttrName());
-                    currentPreset->levels[circuit] = level;
+                    return false;
                 }
+            };
+            std::vector<std::future<bool>> pending;
+            pending.reserve(chunks.size() - 1);
+            for (std::size_t ix = 1; ix < chunks.size(); ++ix)
+            {
+                pending.push_back(thread_helpers::runAsync([&parseChunk, ix]() { return parseChunk(ix); }));
             }
-            else if (tokenType == QXmlStreamReader::EndDocument)
+            bool parsed = parseChunk(0);
+            for (auto& result : pending)
             {
-                if (currentPreset.has_value())
-                {
-                    presets_.insert_or_assign(currentPreset->num, currentPreset.value());
-                }
+                parsed = result.get() && parsed;
             }
+            if (!parsed)
+            {
+                return std::nullopt;
+            }
+        }
+        catch (const std::exception&)
+        {
+            return std::nullopt;
+        }
+
+        // Every piece's points come after the ones before it, so the index stays sorted.
+        std::vector<Preset> presets;
+        for (auto& chunk : chunks)
+        {
+            points.insert(points.end(), chunk.points.begin(), chunk.points.end());
+            presets.insert(presets.end(), std::make_move_iterator(chunk.presets.begin()),
+                           std::make_move_iterator(chunk.presets.end()));
+        }
+        return presets;
+    }
+
+    bool EchoPcpConfig::acceptsHeader(const CfgHeader& header) const
+    {
+        return header.rootTag == rootTagName() && header.rackTag == rackTagName() &&
+            isVersionCompatible(header.version);
+    }
+
+    void EchoPcpConfig::sheetApplied()
+    {
+        // Update space mapping.  Spaces are already sorted by Echo space num.
+        rackSpaces_.clear();
+        rackSpaces_.reserve(spaces_.size());
+        unsigned int rackSpaceNum = 1;
+        for (const auto& space : spaces_)
+        {
+            rackSpaces_.insert_or_assign(rackSpaceNum++, space.num);
+        }
+    }
+
+    std::unique_ptr<Config> EchoPcpConfig::clone() const
+    {
+        auto copy = createEmpty();
+        copyStateTo(*copy);
+        copy->name_ = name_;
+        copy->circuits_ = circuits_;
+        copy->rackSpaces_ = rackSpaces_;
+        copy->spaces_ = spaces_;
+        copy->presets_ = presets_;
+        copy->source_ = source_;
+        copy->baseCfg_ = baseCfg_;
+        copy->spliceIndex_ = spliceIndex_;
+        return copy;
+    }
+
+    void EchoPcpConfig::saveSnapshot(const QString& sourcePath, const QString& path) const
+    {
+        const auto header = sniffCfg(sourcePath);
+        if (!header.has_value() || !acceptsHeader(header.value()))
+        {
+            throw std::runtime_error("Source is not this type of config");
         }
-        if (xml.hasError())
+        QFile f(sourcePath);
+        if (!f.open(QIODevice::ReadOnly))
         {
-            throw std::runtime_error("Failed to read file");
+            throw std::runtime_error("Failed to open source file");
         }
+        saveSnapshot(header.value(), mapFile(f), {}, path);
     }
 
-    void EchoPcpConfig::parseSheet(const QString& path)
+    void EchoPcpConfig::saveSnapshot(const CfgHeader& header, QByteArrayView source, const QByteArray& sourceHash,
+                                     const QString& path) const
     {
-        Config::parseSheet(path);
+        if (!acceptsHeader(header))
+        {
+            throw std::runtime_error("Source is not this type of config");
+        }
+        const ConfigSnapshot::Contents contents{
+            .header = header,
+            .panelName = name_,
+            .circuits = circuits(),
+            .spaces = spaces(),
+            .rackSpaces = rackSpaces_.entries(),
+            .presets = presets(),
+            .source = source,
+            .sourceHash = sourceHash,
+        };
+        ConfigSnapshot::save(path, contents);
+    }
+
+    void EchoPcpConfig::loadSnapshot(const ConfigSnapshot& snapshot)
+    {
+        if (!acceptsHeader(snapshot.cfgHeader()))
+        {
+            throw std::runtime_error("Snapshot is not of this type of config");
+        }
+        Config::loadSnapshot(snapshot);
+        // The values didn't come from a file that can be spliced.
+        source_.reset();
+        baseCfg_.clear();
+        spliceIndex_.reset();
 
-        // Update space mapping.
+        name_ = snapshot.panelName();
+        // Everything is already sorted, so each item is appended.
+        circuits_.clear();
+        circuits_.reserve(snapshot.circuits().size());
+        for (const auto& circuit : snapshot.circuits())
+        {
+            circuits_.insertOrAssign(circuit);
+        }
+        spaces_.clear();
+        spaces_.reserve(snapshot.spaces().size());
+        for (const auto& space : snapshot.spaces())
+        {
+            spaces_.insertOrAssign(space);
+        }
         rackSpaces_.clear();
-        std::vector<unsigned int> echoSpaceNums;
-        for (const auto echoSpaceNum : spaces_ | std::views::keys)
+        rackSpaces_.reserve(snapshot.rackSpaces().size());
+        for (const auto& rackSpace : snapshot.rackSpaces())
         {
-            echoSpaceNums.push_back(echoSpaceNum);
+            rackSpaces_.insert_or_assign(rackSpace.rackSpaceNum, rackSpace.echoSpaceNum);
         }
-        std::ranges::sort(echoSpaceNums);
-        auto echoSpaceNumsIt = echoSpaceNums.cbegin();
-        for (unsigned int rackSpaceNum = 1; echoSpaceNumsIt != echoSpaceNums.cend(); ++echoSpaceNumsIt, ++rackSpaceNum)
+        presets_.clear();
+        presets_.reserve(snapshot.presets().size());
+        for (const auto& record : snapshot.presets())
         {
-            rackSpaces_.emplace(rackSpaceNum, *echoSpaceNumsIt);
+            auto& preset = presets_.getOrInsert(record.num);
+            const auto levelCircuits = snapshot.levelCircuits(record);
+            const auto levels = snapshot.levels(record);
+            if (!levelCircuits.empty())
+            {
+                preset.levels.reserve(levelCircuits.back());
+            }
+            for (std::size_t ix = 0; ix < levelCircuits.size(); ++ix)
+            {
+                preset.levels[levelCircuits[ix]] = levels[ix];
+            }
+            const auto fadeTimeSpaces = snapshot.fadeTimeSpaces(record);
+            const auto fadeTimes = snapshot.fadeTimes(record);
+            for (std::size_t ix = 0; ix < fadeTimeSpaces.size(); ++ix)
+            {
+                preset.fadeTimes[fadeTimeSpaces[ix]] = fadeTimes[ix];
+            }
         }
     }
 
+    void EchoPcpConfig::retainBase(const QString& path, const QByteArray& data)
+    {
+        source_ = CfgSource::of(path, QByteArrayView(data));
+        baseCfg_ = data;
+        // Where values are is only known for the file last parsed, which may not be this one.
+        spliceIndex_.reset();
+    }
+
     void EchoPcpConfig::saveCfg(const QString& basePath, const QString& outPath) const
     {
         QFile fIn(basePath);
-        if (!fIn.open(QIODevice::ReadOnly))
+        QByteArray data;
+        const bool unchanged = source_.has_value() && source_->isUnchanged(basePath);
+        if (unchanged && !baseCfg_.isNull())
         {
-            throw std::runtime_error("Failed to open base file");
+            data = baseCfg_;
         }
+        else
+        {
+            if (!fIn.open(QIODevice::ReadOnly))
+            {
+                throw std::runtime_error("Failed to open base file");
+            }
+            data = mapFile(fIn);
+        }
+        // The file may have been touched or copied since it was parsed, without changing its contents.
+        const bool isSource = unchanged || (source_.has_value() && source_->hasContents(data));
+
         QSaveFile fOut(outPath);
         if (!fOut.open(QIODevice::WriteOnly))
         {
             throw std::runtime_error("Failed to open output file");
         }
 
-        QXmlStreamReader xmlIn(&fIn);
-        QXmlStreamWriter xmlOut(&fOut);
+        const std::string_view bytes(data.constData(), data.size());
+        if (!XmlScanner::isUtf8Document(bytes))
+        {
+            rewriteCfg(data, fOut);
+        }
+        else if (isSource && spliceIndex_ != nullptr)
+        {
+            spliceCfg(bytes, *spliceIndex_, fOut);
+        }
+        else
+        {
+            spliceCfg(bytes, indexCfg(bytes), fOut);
+        }
+
+        // Unmap the base file before replacing it, in case it's the same as the output file.
+        fIn.close();
+        if (!fOut.commit())
+        {
+            throw std::runtime_error("Failed to save file");
+        }
+    }
+
+    SpliceIndex EchoPcpConfig::indexCfg(std::string_view data) const
+    {
+        SpliceIndex index;
+        const auto names = dialectNames();
+        SpliceRecorder recorder(names, data, index.points);
+        XmlScanner scanner(data);
+        bool parsedRoot = false;
+        while (scanner.readNextStartElement())
+        {
+            if (!parsedRoot && scanner.name() != names.rootTag.view())
+            {
+                throw std::runtime_error("Incorrect root tag.");
+            }
+            parsedRoot = true;
+            if (scanner.name() == names.rackTag.view() && !isVersionCompatible(scanner.attribute(kVersion.view())))
+            {
+                throw std::runtime_error("Incorrect version.");
+            }
+            recorder.record(scanner);
+        }
+        return index;
+    }
+
+    void EchoPcpConfig::spliceCfg(std::string_view data, const SpliceIndex& index, QIODevice& out) const
+    {
+        // Serializing overlaps with writing the blocks before.
+        WriteBehind writer(out);
+        const auto write = [&writer](const char* bytes, qsizetype size) { writer.write(bytes, size); };
+        const auto finish = [this, &writer]()
+        {
+            writer.finish();
+            if (saveOptions().ioStats != nullptr)
+            {
+                *saveOptions().ioStats = writer.stats();
+            }
+        };
+
+        // Split at the start of presets into about even pieces, which are spliced into buffers at the same time.
+        const auto threadCount = saveOptions().threadCount > 0
+            ? saveOptions().threadCount
+            : static_cast<unsigned int>(QThread::idealThreadCount());
+        const auto chunkCount = std::min<std::size_t>(threadCount, data.size() / kMinChunkSize);
+        const std::span<const SplicePoint> points(index.points);
+        // Bounds are indexes into points; piece n starts at the first of its points, except the first piece.
+        std::vector<std::size_t> bounds{0};
+        for (std::size_t ix = 1; ix < chunkCount; ++ix)
+        {
+            const auto target = static_cast<qsizetype>(data.size() * ix / chunkCount);
+            const auto targetIt = std::ranges::lower_bound(points, target, {}, &SplicePoint::offset);
+            auto pointIx = std::max(bounds.back() + 1, static_cast<std::size_t>(targetIt - points.begin()));
+            while (pointIx < points.size() && points[pointIx].presetNum == points[pointIx - 1].presetNum)
+            {
+                ++pointIx;
+            }
+            if (pointIx >= points.size())
+            {
+                break;
+            }
+            bounds.push_back(pointIx);
+        }
+        bounds.push_back(points.size());
+        const auto chunkBegin = [&](std::size_t chunkIx)
+        {
+            if (chunkIx == 0)
+            {
+                return std::size_t{0};
+            }
+            if (chunkIx + 1 == bounds.size())
+            {
+                return data.size();
+            }
+            return static_cast<std::size_t>(points[bounds[chunkIx]].offset);
+        };
+        const auto chunkPoints = [&](std::size_t chunkIx)
+        { return points.subspan(bounds[chunkIx], bounds[chunkIx + 1] - bounds[chunkIx]); };
+
+        if (bounds.size() <= 2)
+        {
+            spliceRange(data, 0, data.size(), points, write);
+            finish();
+            return;
+        }
+
+        const auto spliceChunk = [&](std::size_t chunkIx)
+        {
+            const auto begin = chunkBegin(chunkIx);
+            const auto end = chunkBegin(chunkIx + 1);
+            QByteArray buffer;
+            // Values are about as long as the ones they replace.
+            buffer.reserve(static_cast<qsizetype>(end - begin));
+            spliceRange(data, begin, end, chunkPoints(chunkIx),
+                        [&buffer](const char* bytes, qsizetype size) { buffer.append(bytes, size); });
+            return buffer;
+        };
+        std::vector<std::future<QByteArray>> pending;
+        pending.reserve(bounds.size() - 2);
+        for (std::size_t chunkIx = 1; chunkIx + 1 < bounds.size(); ++chunkIx)
+        {
+            pending.push_back(thread_helpers::runAsync([&spliceChunk, chunkIx]() { return spliceChunk(chunkIx); }));
+        }
+        try
+        {
+            writer.write(spliceChunk(0));
+            for (auto& result : pending)
+            {
+                writer.write(result.get());
+            }
+            finish();
+        }
+        catch (...)
+        {
+            // The pieces still being spliced use data.
+            for (auto& result : pending)
+            {
+                if (result.valid())
+                {
+                    result.wait();
+                }
+            }
+            throw;
+        }
+    }
+
+    template <typename Write>
+    void EchoPcpConfig::spliceRange(std::string_view data, std::size_t begin, std::size_t end,
+                                    std::span<const SplicePoint> points, Write&& write) const
+    {
+        // Copy everything up to offset verbatim.
+        auto copied = static_cast<qsizetype>(begin);
+        const auto copyTo = [&data, &write, &copied](qsizetype offset)
+        {
+            write(data.data() + copied, offset - copied);
+            copied = offset;
+        };
+        const auto splice = [&](qsizetype offset, qsizetype length, std::string_view value)
+        {
+            copyTo(offset);
+            write(value.data(), static_cast<qsizetype>(value.size()));
+            copied = offset + length;
+        };
+
+        // QXmlStreamWriter always declares UTF-8 this way, so keep doing that.
+        static constexpr std::string_view kEncoding = "UTF-8";
+        if (const auto encoding = begin == 0 ? XmlScanner::declaredEncoding(data) : std::nullopt;
+            encoding.has_value() && data.substr(encoding->first, encoding->second) != kEncoding)
+        {
+            splice(static_cast<qsizetype>(encoding->first), static_cast<qsizetype>(encoding->second), kEncoding);
+        }
+
+        std::optional<std::uint32_t> presetNum;
+        const Preset* preset = nullptr;
+        for (const auto& point : points)
+        {
+            if (point.presetNum != presetNum)
+            {
+                presetNum = point.presetNum;
+                preset = presets_.find(point.presetNum);
+            }
+            const auto value = splicedValue(point, preset);
+            if (!value.has_value())
+            {
+                continue;
+            }
+            std::array<char, std::numeric_limits<unsigned int>::digits10 + 1> buf;
+            const auto [valueEnd, ec] = std::to_chars(buf.data(), buf.data() + buf.size(), value.value());
+            const std::string_view text(buf.data(), valueEnd - buf.data());
+            if (data.substr(point.offset, point.length) != text)
+            {
+                splice(point.offset, point.length, text);
+            }
+        }
+        copyTo(static_cast<qsizetype>(end));
+    }
+
+    std::optional<unsigned int> EchoPcpConfig::splicedValue(const SplicePoint& point, const Preset* preset) const
+    {
+        using Kind = SplicePoint::Kind;
+        switch (point.kind)
+        {
+        case Kind::CircuitSpace:
+        case Kind::CircuitZone:
+        {
+            const auto* circuit = circuits_.find(point.key);
+            if (circuit == nullptr)
+            {
+                return std::nullopt;
+            }
+            return point.kind == Kind::CircuitSpace ? circuit->space : circuit->zone;
+        }
+        case Kind::RackSpace:
+        case Kind::RackSpaceExt:
+        case Kind::EchoSpace:
+        case Kind::EchoSpaceExt:
+        {
+            // Only the attributes for the new space number's range are updated, like rewriteCfg() does.
+            const unsigned int echoSpaceNum = rackSpaces_.echoSpace(point.key).value_or(0);
+            const bool ext = echoSpaceNum > 16 || echoSpaceNum < 1;
+            if (ext != (point.kind == Kind::RackSpaceExt || point.kind == Kind::EchoSpaceExt))
+            {
+                return std::nullopt;
+            }
+            return point.kind == Kind::RackSpace || point.kind == Kind::RackSpaceExt ? point.key : echoSpaceNum;
+        }
+        case Kind::FadeTime:
+        {
+            if (preset == nullptr)
+            {
+                return std::nullopt;
+            }
+            const auto echoSpaceNum = rackSpaces_.echoSpace(point.key).value_or(0);
+            const auto fadeTimeIt = preset->fadeTimes.find(echoSpaceNum);
+            if (fadeTimeIt == preset->fadeTimes.end())
+            {
+                return std::nullopt;
+            }
+            return fadeTimeIt->second;
+        }
+        case Kind::Level:
+        {
+            if (preset == nullptr)
+            {
+                return std::nullopt;
+            }
+            const auto levelIt = preset->levels.find(point.key);
+            if (levelIt == preset->levels.end())
+            {
+                return std::nullopt;
+            }
+            return levelIt->second;
+        }
+        }
+        return std::nullopt;
+    }
+
+    void EchoPcpConfig::rewriteCfg(const QByteArray& base, QIODevice& out) const
+    {
+        QXmlStreamReader xmlIn(base);
+        QXmlStreamWriter xmlOut(&out);
         xmlOut.setAutoFormatting(true);
         bool parsedRoot = false;
-        std::optional<Preset> currentPreset;
+        const Preset* currentPreset = nullptr;
         while (!xmlIn.atEnd() && !xmlOut.hasError())
         {
             const auto tokenType = xmlIn.readNext();
@@ -211,12 +1098,11 @@ namespace echoconfig
                 else if (tagName == outputTagName())
                 {
                     const auto circuitNum = xml_helpers::requiredAttrUInt(xmlIn, QStringLiteral("NUMBER"));
-                    auto circuit = circuits_.find(circuitNum);
-                    if (circuit != circuits_.end())
+                    const auto* circuit = circuits_.find(circuitNum);
+                    if (circuit != nullptr)
                     {
-                        xml_helpers::replaceAttr(attrs, QStringLiteral("SPACE"),
-                                                 QString::number(circuit->second.space));
-                        xml_helpers::replaceAttr(attrs, QStringLiteral("ZONE"), QString::number(circuit->second.zone));
+                        xml_helpers::replaceAttr(attrs, QStringLiteral("SPACE"), QString::number(circuit->space));
+                        xml_helpers::replaceAttr(attrs, QStringLiteral("ZONE"), QString::number(circuit->zone));
                     }
                 }
                 else if (tagName == QStringLiteral("SPACE"))
@@ -240,12 +1126,7 @@ namespace echoconfig
                         throw std::runtime_error("Failed to read space attribute");
                     }
                     const unsigned int rackSpaceNum = xml_helpers::requiredAttrUInt(xmlIn, spaceAttr);
-                    unsigned int echoSpaceNum = 0;
-                    const auto echoSpaceNumIt = rackSpaces_.find(rackSpaceNum);
-                    if (echoSpaceNumIt != rackSpaces_.end())
-                    {
-                        echoSpaceNum = echoSpaceNumIt->second;
-                    }
+                    const unsigned int echoSpaceNum = rackSpaces_.echoSpace(rackSpaceNum).value_or(0);
                     if (echoSpaceNum > 16 || echoSpaceNum < 1)
                     {
                         spaceAttr = kSpaceInRackExt;
@@ -262,27 +1143,14 @@ namespace echoconfig
                 else if (tagName == QStringLiteral("PRESET"))
                 {
                     const auto presetNum = xml_helpers::requiredAttrUInt(xmlIn, QStringLiteral("NUMBER"));
-                    const auto currentPresetIt = presets_.find(presetNum);
-                    if (currentPresetIt != presets_.end())
-                    {
-                        currentPreset = currentPresetIt->second;
-                    }
-                    else
-                    {
-                        currentPreset.reset();
-                    }
+                    currentPreset = presets_.find(presetNum);
                 }
                 else if (tagName == QStringLiteral("PREFADELEVEL"))
                 {
-                    if (currentPreset.has_value())
+                    if (currentPreset != nullptr)
                     {
                         const auto rackSpaceNum = xml_helpers::requiredAttrUInt(xmlIn, QStringLiteral("SPACEINRACK"));
-                        unsigned int echoSpaceNum = 0;
-                        const auto echoSpaceNumIt = rackSpaces_.find(rackSpaceNum);
-                        if (echoSpaceNumIt != rackSpaces_.end())
-                        {
-                            echoSpaceNum = echoSpaceNumIt->second;
-                        }
+                        const auto echoSpaceNum = rackSpaces_.echoSpace(rackSpaceNum).value_or(0);
                         const auto fadeTimeIt = currentPreset->fadeTimes.find(echoSpaceNum);
                         if (fadeTimeIt != currentPreset->fadeTimes.end())
                         {
@@ -292,7 +1160,7 @@ namespace echoconfig
                 }
                 else if (tagName == QStringLiteral("PRELEVEL"))
                 {
-                    if (currentPreset.has_value())
+                    if (currentPreset != nullptr)
                     {
                         const auto circuit = xml_helpers::requiredAttrUInt(xmlIn, outputAttrName());
                         const auto levelIt = currentPreset->levels.find(circuit);
@@ -327,74 +1195,118 @@ namespace echoconfig
         {
             throw std::runtime_error("Failed to save file");
         }
-
-        fOut.commit();
     }
 
     const Circuit& EchoPcpConfig::getCircuitAt(const unsigned int ix) const
     {
         Q_ASSERT(ix < circuits_.size());
-        auto it = circuits_.cbegin();
-        std::advance(it, ix);
-        return it->second;
+        return circuits_[ix];
     }
 
     Circuit& EchoPcpConfig::getCircuitAt(unsigned int ix)
     {
         Q_ASSERT(ix < circuits_.size());
-        auto it = circuits_.begin();
-        std::advance(it, ix);
-        return it->second;
+        return circuits_[ix];
     }
 
     const Space& EchoPcpConfig::getSpaceAt(unsigned int ix) const
     {
         Q_ASSERT(ix < spaces_.size());
-        auto it = spaces_.cbegin();
-        std::advance(it, ix);
-        return it->second;
+        return spaces_[ix];
     }
 
     Space& EchoPcpConfig::getSpaceAt(unsigned int ix)
     {
         Q_ASSERT(ix < spaces_.size());
-        auto it = spaces_.begin();
-        std::advance(it, ix);
-        return it->second;
+        return spaces_[ix];
     }
 
     const Space& EchoPcpConfig::getSpaceAtRack(unsigned int ix) const
     {
-        Q_ASSERT(ix < spaces_.size());
-        auto rackIt = rackSpaces_.begin();
-        std::advance(rackIt, ix);
-        const auto echoSpaceNum = rackIt->second;
-        return spaces_.at(echoSpaceNum);
+        Q_ASSERT(ix < rackSpaces_.size());
+        return spaces_.get(rackSpaces_.at(ix).second);
     }
 
     Space& EchoPcpConfig::getSpaceAtRack(unsigned int ix)
     {
-        Q_ASSERT(ix < spaces_.size());
-        auto rackIt = rackSpaces_.begin();
-        std::advance(rackIt, ix);
-        const auto echoSpaceNum = rackIt->second;
-        return spaces_.at(echoSpaceNum);
+        Q_ASSERT(ix < rackSpaces_.size());
+        return spaces_.get(rackSpaces_.at(ix).second);
+    }
+
+    const Space& EchoPcpConfig::getRackSpace(unsigned int num) const
+    {
+        const auto echoSpaceNum = rackSpaces_.echoSpace(num);
+        if (!echoSpaceNum.has_value())
+        {
+            throw std::out_of_range("No such rack space");
+        }
+        return spaces_.get(echoSpaceNum.value());
+    }
+
+    Space& EchoPcpConfig::getRackSpace(unsigned int num)
+    {
+        const auto echoSpaceNum = rackSpaces_.echoSpace(num);
+        if (!echoSpaceNum.has_value())
+        {
+            throw std::out_of_range("No such rack space");
+        }
+        return spaces_.get(echoSpaceNum.value());
     }
 
     const Preset& EchoPcpConfig::getPresetAt(unsigned int ix) const
     {
         Q_ASSERT(ix < presets_.size());
-        auto it = presets_.cbegin();
-        std::advance(it, ix);
-        return it->second;
+        return presets_[ix];
     }
 
     Preset& EchoPcpConfig::getPresetAt(unsigned int ix)
     {
         Q_ASSERT(ix < presets_.size());
-        auto it = presets_.begin();
-        std::advance(it, ix);
-        return it->second;
+        return presets_[ix];
+    }
+
+    void EchoPcpConfig::reserveFor(const QByteArray& head, qint64 totalSize)
+    {
+        const std::string_view bytes(head.constData(), head.size());
+        reserveFor(bytes, StructuralIndex(bytes, 0, bytes.size()),
+                   std::max(1.0, static_cast<double>(totalSize) / static_cast<double>(head.size())));
+    }
+
+    void EchoPcpConfig::reserveFor(std::string_view data, const StructuralIndex& index, double scale)
+    {
+        // One pass over the tags, instead of searching the whole file for each name.
+        const auto outputTag = outputTagName().toUtf8();
+        const std::string_view outputName(outputTag.constData(), outputTag.size());
+        std::size_t outputCount = 0;
+        std::size_t spaceCount = 0;
+        std::size_t presetCount = 0;
+        for (auto pos = index.find(StructuralIndex::Mark::Tag, 0); pos != std::string_view::npos;
+             pos = index.find(StructuralIndex::Mark::Tag, pos + 1))
+        {
+            const auto rest = data.substr(pos + 1);
+            const auto isTag = [&rest](std::string_view tagName)
+            { return rest.size() > tagName.size() && rest.starts_with(tagName) && rest[tagName.size()] == ' '; };
+            if (isTag(outputName))
+            {
+                ++outputCount;
+            }
+            else if (isTag("SPACE"))
+            {
+                ++spaceCount;
+            }
+            else if (isTag("PRESET"))
+            {
+                ++presetCount;
+            }
+        }
+
+        const auto scaled = [scale](std::size_t count)
+        { return static_cast<std::size_t>(static_cast<double>(count) * scale); };
+        circuits_.reserve(circuits_.size() + scaled(outputCount));
+        // Unused spaces are not stored, but there are never many spaces.
+        spaces_.reserve(spaces_.size() + scaled(spaceCount));
+        rackSpaces_.reserve(rackSpaces_.size() + scaled(spaceCount));
+        presets_.reserve(presets_.size() + scaled(presetCount));
     }
 
     bool EchoPcpConfig::isVersionCompatible(QStringView versionStr) const {
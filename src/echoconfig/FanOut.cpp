@@ -0,0 +1,206 @@
+/**
+ * @file FanOut.cpp
+ *
+ * @author Dan Keenan
+ * @date 10/17/2026
+ * @copyright GNU GPLv3
+ */
+
+#include "echoconfig/FanOut.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QRegularExpression>
+#include <QSaveFile>
+#include <QThread>
+#include <QThreadPool>
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <stdexcept>
+#include <utility>
+#include "echoconfig/XlsxReader.h"
+#include "echoconfig/XlsxWriter.h"
+#include "echoconfig/batch_helpers.h"
+
+namespace echoconfig
+{
+    namespace
+    {
+        using Clock = std::chrono::steady_clock;
+
+        /**
+         * Whether @p rack can be a file name on any platform, and only names a file directly in the output directory.
+         */
+        bool isPlainFileName(const QString& rack)
+        {
+            // Only characters known to be safe are allowed, as what isn't differs between file systems.
+            static const auto kPunctuation = QStringLiteral(" -_.,()+&#");
+            if (rack.isEmpty() || rack.startsWith(u'.') || rack.startsWith(u' ') || rack.endsWith(u'.') ||
+                rack.endsWith(u' '))
+            {
+                return false;
+            }
+            for (const auto c : rack)
+            {
+                if (!c.isLetterOrNumber() && !kPunctuation.contains(c))
+                {
+                    return false;
+                }
+            }
+
+            // Windows keeps these names for devices, whatever the extension.
+            static const auto kReservedNames =
+                QRegularExpression(QStringLiteral(R"(^(CON|PRN|AUX|NUL|COM[1-9]|LPT[1-9]) *(\..*)?$)"),
+                                   QRegularExpression::CaseInsensitiveOption);
+            return !kReservedNames.match(rack).hasMatch();
+        }
+    } // namespace
+
+    std::size_t FanOut::Report::failedCount() const
+    {
+        return batch_helpers::failedCount(results);
+    }
+
+    FanOut::FanOut(const QString& basePath) : basePath_(basePath)
+    {
+        // Keeping the base and where its values are is what lets every rack skip reading it.
+        base_ = Config::loadCfgOrThrow(basePath, {.engine = ParseEngine::Mapped, .retainBase = true, .threadCount = 0});
+    }
+
+    QString FanOut::levelsSheetName(const QString& rack) { return rack + u' ' + Config::tr("Levels"); }
+
+    QString FanOut::timesSheetName(const QString& rack) { return rack + u' ' + Config::tr("Times"); }
+
+    QStringList FanOut::rackNames(const XlsxReader& workbook)
+    {
+        const auto levelsSuffix = levelsSheetName(QString());
+        QStringList racks;
+        for (const auto& sheetName : workbook.sheetNames())
+        {
+            if (sheetName.size() <= levelsSuffix.size() || !sheetName.endsWith(levelsSuffix))
+            {
+                continue;
+            }
+            auto rack = sheetName.chopped(levelsSuffix.size());
+            if (!workbook.hasSheet(timesSheetName(rack)))
+            {
+                throw std::runtime_error(
+                    QStringLiteral("Missing \"%1\" sheet.").arg(timesSheetName(rack)).toStdString());
+            }
+            racks.push_back(std::move(rack));
+        }
+        return racks;
+    }
+
+    void FanOut::saveWorkbook(const QString& path, std::span<const std::pair<QString, const Config*>> racks,
+                              const SheetOptions& options)
+    {
+        QSaveFile f(path);
+        if (!f.open(QIODevice::WriteOnly))
+        {
+            throw std::runtime_error("Error saving config");
+        }
+        XlsxWriter writer(&f, {.level = options.compression, .parallel = true});
+        for (const auto& [rack, config] : racks)
+        {
+            config->saveWorkbookSheets(writer, levelsSheetName(rack), timesSheetName(rack), options.layout);
+        }
+        writer.finish();
+        if (!f.commit())
+        {
+            throw std::runtime_error("Error saving config");
+        }
+    }
+
+    FanOut::Report FanOut::run(const QString& workbookPath, const QString& outDir) const
+    {
+        return run(workbookPath, outDir, Options());
+    }
+
+    FanOut::Report FanOut::run(const QString& workbookPath, const QString& outDir, const Options& options) const
+    {
+        const auto start = Clock::now();
+        QFile f(workbookPath);
+        if (!f.open(QIODevice::ReadOnly))
+        {
+            throw std::runtime_error("Failed to open file");
+        }
+        // Shared by every rack; reading sheets from it at the same time is safe.
+        const XlsxReader workbook(&f);
+        const auto racks = rackNames(workbook);
+
+        Report report;
+        report.results.resize(racks.size());
+        const auto threadCount = options.threadCount > 0 ? options.threadCount
+                                                         : static_cast<unsigned int>(QThread::idealThreadCount());
+        report.threadCount = std::max(1u, std::min(threadCount, static_cast<unsigned int>(racks.size())));
+
+        const QDir dir(outDir);
+        const auto suffix = QFileInfo(basePath_).suffix();
+        // Rack names come from the workbook, so they mustn't write outside outDir or over each other.  Names are
+        // compared without case, as some file systems do.
+        QHash<QString, QString> racksByFile;
+        for (qsizetype ix = 0; ix < racks.size(); ++ix)
+        {
+            const auto& rack = racks[ix];
+            auto& result = report.results[ix];
+            result.rack = rack;
+            if (!isPlainFileName(rack))
+            {
+                result.error = QStringLiteral("Rack name can't be used as a file name.");
+                continue;
+            }
+            const auto fileName = rack + u'.' + suffix;
+            const auto fileKey = fileName.toCaseFolded();
+            if (const auto existing = racksByFile.constFind(fileKey); existing != racksByFile.cend())
+            {
+                result.error = QStringLiteral("Saved to the same file as rack \"%1\".").arg(existing.value());
+                continue;
+            }
+            racksByFile.insert(fileKey, rack);
+            result.outPath = dir.filePath(fileName);
+        }
+
+        // Racks are all about the same size, so handing them out in order keeps every worker busy.
+        std::atomic<qsizetype> next = 0;
+        const auto work = [&]()
+        {
+            for (auto ix = next++; ix < racks.size(); ix = next++)
+            {
+                const auto& rack = racks[ix];
+                auto& result = report.results[ix];
+                if (!result.error.isEmpty())
+                {
+                    continue;
+                }
+                try
+                {
+                    const auto config = base_->clone();
+                    batch_helpers::timed(
+                        result.parseSheets,
+                        [&]() { config->parseWorkbookSheets(workbook, levelsSheetName(rack), timesSheetName(rack)); });
+                    batch_helpers::timed(result.saveCfg, [&]() { config->saveCfg(basePath_, result.outPath); });
+                    result.ok = true;
+                }
+                catch (const std::exception& e)
+                {
+                    result.error = QString::fromUtf8(e.what());
+                }
+            }
+        };
+
+        QThreadPool pool;
+        pool.setMaxThreadCount(static_cast<int>(report.threadCount));
+        for (unsigned int worker = 1; worker < report.threadCount; ++worker)
+        {
+            pool.start(work);
+        }
+        work();
+        pool.waitForDone();
+
+        report.wallTime = Clock::now() - start;
+        return report;
+    }
+} // namespace echoconfig
@@ -0,0 +1,294 @@
+/**
+ * @file FixtureGenerator.cpp
+ *
+ * @author Dan Keenan
+ * @date 10/17/2026
+ * @copyright GNU GPLv3
+ */
+
+#include "echoconfig/FixtureGenerator.h"
+
+#include <QSaveFile>
+#include <QTemporaryDir>
+#include <algorithm>
+#include <random>
+#include "echoconfig/EchoAcpConfig.h"
+#include "echoconfig/EchoPcpConfig.h"
+
+namespace echoconfig
+{
+    namespace
+    {
+        /** Number of steps in every sequence. */
+        constexpr unsigned int kSequenceSteps = 6;
+        /** Addresses per DMX/sACN universe. */
+        constexpr unsigned int kUniverseSize = 512;
+        /** The hardware has at least this many rack spaces, whether used or not. */
+        constexpr unsigned int kMinRackSpaces = 16;
+        /** Rack spaces above this use the "EXT" attribute names. */
+        constexpr unsigned int kMaxBasicRackSpace = 8;
+        constexpr unsigned int kZoneCount = 16;
+        constexpr unsigned int kMaxFadeTime = 10;
+
+        /**
+         * Dialect-specific tag and attribute names.
+         */
+        struct Names
+        {
+            const char* rack;
+            const char* output;
+            const char* outputAttr;
+            const char* fadeTimeAttr;
+            const char* seqTimeAttr;
+        };
+
+        const Names kPcpNames{
+            .rack = "<CABINET VERSION=\"3.1.X\" CONFIGVERSION=\"1.0\" NUM=\"1\" NAME=\"Rack\" RACKTYPE=\"ERP\" "
+                    "STATION=\"DISABLED\" DMX=\"ENABLED\" DMXPRI=\"100\" PRESETPRI=\"100\" CIPRI=\"100\" "
+                    "PACKETDELAY=\"0\" DMXLOSSMODE=\"HOLD LAST LOOK\" DMXWAITTIME=\"180\" DMXFADETIME=\"3\" "
+                    "SACNLOSSMODE=\"HOLD LAST LOOK\" SACNWAITTIME=\"180\" SACNFADETIME=\"3\" POWERON=\"LAST-LOOK\" "
+                    "RELAYDELAY=\"0\" REMOTERECORD=\"ENABLED\" WEBINTERFACEENABLED=\"ENABLED\"/>\n",
+            .output = "RELAY",
+            .outputAttr = "RELAY",
+            .fadeTimeAttr = "UPTIME",
+            .seqTimeAttr = "UPTIME",
+        };
+
+        const Names kAcpNames{
+            .rack = "<RACK VERSION=\"2.0.3.7\" NUM=\"1\" NAME=\"Rack\" DMX=\"DISABLED\" DMXPRI=\"100\" "
+                    "PRESETPRI=\"100\" DMXLOSSMODE=\"HOLD LAST LOOK\" DMXWAITTIME=\"180\" DMXFADETIME=\"3\" "
+                    "SACNLOSSMODE=\"WAIT AND FADE\" SACNWAITTIME=\"180\" SACNFADETIME=\"3\" POWERON=\"NONE\" "
+                    "REMOTERECORD=\"ENABLED\" WEBINTERFACEENABLED=\"ENABLED\"/>\n",
+            .output = "OUTPUT",
+            .outputAttr = "OUTPUT",
+            .fadeTimeAttr = "PREFADELEVEL",
+            .seqTimeAttr = "FADETIME",
+        };
+
+        /**
+         * Appends elements to a document, one per line, in the same layout the panels use.
+         */
+        class Writer
+        {
+        public:
+            explicit Writer(QByteArray& out) : out_(out) {}
+
+            Writer& raw(const char* text)
+            {
+                out_.append(text);
+                return *this;
+            }
+
+            Writer& open(const char* tag)
+            {
+                out_.append('<').append(tag);
+                return *this;
+            }
+
+            Writer& attr(const char* name, unsigned int value)
+            {
+                out_.append(' ').append(name).append("=\"").append(QByteArray::number(value)).append('"');
+                return *this;
+            }
+
+            Writer& attr(const char* name, const char* value)
+            {
+                out_.append(' ').append(name).append("=\"").append(value).append('"');
+                return *this;
+            }
+
+            Writer& close()
+            {
+                out_.append("/>\n");
+                return *this;
+            }
+
+        private:
+            QByteArray& out_;
+        };
+    } // namespace
+
+    FixtureGenerator::FixtureGenerator(const Options& options) : options_(options)
+    {
+        if (options_.circuitCount == 0)
+        {
+            throw std::runtime_error("At least one circuit is required.");
+        }
+        if (options_.spaceCount == 0)
+        {
+            throw std::runtime_error("At least one space is required.");
+        }
+        if (options_.spaceCount > options_.circuitCount)
+        {
+            throw std::runtime_error("Every space must have at least one circuit.");
+        }
+    }
+
+    std::unique_ptr<Config> FixtureGenerator::createConfig() const
+    {
+        switch (options_.dialect)
+        {
+        case Dialect::Pcp:
+            return std::make_unique<EchoPcpConfig>();
+        case Dialect::Acp:
+            return std::make_unique<EchoAcpConfig>();
+        }
+        return nullptr;
+    }
+
+    QString FixtureGenerator::cfgSuffix() const
+    {
+        return options_.dialect == Dialect::Acp ? QStringLiteral("eacp") : QStringLiteral("cfg");
+    }
+
+    unsigned int FixtureGenerator::rackSpaceCount() const { return std::max(options_.spaceCount, kMinRackSpaces); }
+
+    QByteArray FixtureGenerator::generateCfg() const
+    {
+        const bool pcp = options_.dialect == Dialect::Pcp;
+        const Names& names = pcp ? kPcpNames : kAcpNames;
+        const auto circuitCount = options_.circuitCount;
+        const auto spaceCount = options_.spaceCount;
+        const auto rackSpaces = rackSpaceCount();
+        // Only the Mersenne Twister's raw output is specified by the standard; the distributions are not, so use
+        // the raw output to keep fixtures identical across standard libraries.
+        std::mt19937 rng(options_.seed);
+        const auto randomLevel = [&rng]() { return static_cast<unsigned int>(rng() % 256); };
+        const auto randomTime = [&rng]() { return static_cast<unsigned int>(rng() % (kMaxFadeTime + 1)); };
+
+        QByteArray out;
+        // Roughly 40 bytes per element.
+        out.reserve(static_cast<qsizetype>(40) *
+                    (circuitCount + rackSpaces +
+                     options_.presetCount * (1 + rackSpaces + circuitCount) +
+                     options_.sequenceCount * (1 + kSequenceSteps * (1 + kMinRackSpaces + circuitCount))));
+        Writer xml(out);
+
+        xml.raw("<?xml version=\"1.0\" encoding=\"utf-8\"?>\n");
+        xml.raw(pcp ? "\n<SMARTSWITCH2>\n\n" : "<EACP>\n");
+        xml.raw(names.rack);
+
+        // Circuits, split into contiguous blocks across the spaces.
+        for (unsigned int num = 1; num <= circuitCount; ++num)
+        {
+            const auto space = static_cast<unsigned int>(static_cast<unsigned long long>(num - 1) * spaceCount /
+                                                         circuitCount) + 1;
+            xml.open(names.output).attr("NUMBER", num).attr("UDN", num);
+            if (pcp)
+            {
+                xml.attr("DMX", num);
+            }
+            xml.attr("UNIV", (num - 1) / kUniverseSize + 1).attr("SACNADDR", (num - 1) % kUniverseSize + 1);
+            if (!pcp)
+            {
+                xml.attr("SACNBADDR", (num - 1) % kUniverseSize + 1);
+            }
+            xml.attr("SPACE", space).attr("ZONE", (num - 1) % kZoneCount + 1);
+            if (pcp)
+            {
+                xml.attr("TYPE", "1-POLE").attr("OPMODE", "NORMAL").attr("ONTHRESH", 1u).attr("OFFTHRESH", 0u);
+                xml.attr("PANIC", "YES").attr("ALLOWMAN", "ALLOW").attr("ANMODE", "NORMALLYOPEN");
+            }
+            out.append(" NAME=\"Circuit ").append(QByteArray::number(num)).append('"');
+            xml.close();
+        }
+
+        // Universes.
+        const auto universeCount = (circuitCount - 1) / kUniverseSize + 1;
+        for (unsigned int univ = 1; univ <= std::max(universeCount, 4u); ++univ)
+        {
+            xml.open("UNIVERSE").attr("UNIVINRACK", univ).attr("NUMBER", univ <= universeCount ? univ : 0).close();
+        }
+
+        // Spaces.  The first spaceCount rack spaces are used, the rest are empty.
+        for (unsigned int rackSpace = 1; rackSpace <= rackSpaces; ++rackSpace)
+        {
+            const auto echoSpace = rackSpace <= spaceCount ? rackSpace : 0;
+            if (rackSpace <= kMaxBasicRackSpace)
+            {
+                xml.open("SPACE").attr("SPACEINRACK", rackSpace).attr("NUMBER", echoSpace).attr("NAME", "").close();
+            }
+            else
+            {
+                xml.open("SPACE")
+                    .attr("SPACEINRACKEXT", rackSpace)
+                    .attr("NUMBEREXT", echoSpace)
+                    .attr("NAMEEXT", "")
+                    .close();
+            }
+        }
+
+        // Presets.
+        for (unsigned int preset = 1; preset <= options_.presetCount; ++preset)
+        {
+            xml.open("PRESET").attr("NUMBER", preset).close();
+            for (unsigned int rackSpace = 1; rackSpace <= rackSpaces; ++rackSpace)
+            {
+                xml.open("PREFADELEVEL")
+                    .attr("SPACEINRACK", rackSpace)
+                    .attr(names.fadeTimeAttr, rackSpace <= spaceCount ? randomTime() : 0)
+                    .close();
+            }
+            for (unsigned int circuit = 1; circuit <= circuitCount; ++circuit)
+            {
+                xml.open("PRELEVEL").attr(names.outputAttr, circuit).attr("LEVEL", randomLevel()).close();
+            }
+        }
+
+        // Sequences.
+        for (unsigned int sequence = 1; sequence <= options_.sequenceCount; ++sequence)
+        {
+            xml.open("SEQUENCE").attr("NUMBER", sequence).attr("TYPE", "SINGLE").close();
+            for (unsigned int step = 1; step <= kSequenceSteps; ++step)
+            {
+                xml.open("STEP").attr("STEPNUM", step).attr("USED", "YES").close();
+                for (unsigned int space = 1; space <= kMinRackSpaces; ++space)
+                {
+                    xml.open("SEQTIME")
+                        .attr("SPACE", space)
+                        .attr(names.seqTimeAttr, randomTime())
+                        .attr("HOLDTIME", randomTime())
+                        .close();
+                }
+                for (unsigned int circuit = 1; circuit <= circuitCount; ++circuit)
+                {
+                    xml.open("SEQLEVEL").attr(names.outputAttr, circuit).attr("LEVEL", randomLevel()).close();
+                }
+            }
+        }
+
+        xml.raw("<SACNHLL TIMEMS=\"1000\"/>\n");
+        xml.raw(pcp ? "</SMARTSWITCH2>" : "</EACP>");
+
+        return out;
+    }
+
+    void FixtureGenerator::saveCfg(const QString& path) const
+    {
+        QSaveFile f(path);
+        if (!f.open(QIODevice::WriteOnly))
+        {
+            throw std::runtime_error("Failed to open output file");
+        }
+        const auto data = generateCfg();
+        if (f.write(data) != data.size() || !f.commit())
+        {
+            throw std::runtime_error("Failed to save file");
+        }
+    }
+
+    void FixtureGenerator::saveSheet(const QString& path) const
+    {
+        // Round-trip through the real parser so the sheet is exactly what a user would export.
+        QTemporaryDir tempDir;
+        if (!tempDir.isValid())
+        {
+            throw std::runtime_error("Failed to create temporary directory");
+        }
+        const auto cfgPath = tempDir.filePath(QStringLiteral("fixture.%1").arg(cfgSuffix()));
+        saveCfg(cfgPath);
+        const auto config = createConfig();
+        config->parseCfg(cfgPath);
+        config->saveSheet(path);
+    }
+} // namespace echoconfig
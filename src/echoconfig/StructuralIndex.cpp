@@ -0,0 +1,259 @@
+/**
+ * @file StructuralIndex.cpp
+ *
+ * @author Dan Keenan
+ * @date 10/17/2026
+ * @copyright GNU GPLv3
+ */
+
+#include "echoconfig/StructuralIndex.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define ECHOCONFIG_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#else
+#define ECHOCONFIG_X86 0
+#endif
+
+// GCC and Clang only emit AVX2 instructions in functions marked for it; MSVC emits whatever intrinsics are used.
+#if ECHOCONFIG_X86 && (defined(__GNUC__) || defined(__clang__))
+#define ECHOCONFIG_TARGET_SSE2 __attribute__((target("sse2")))
+#define ECHOCONFIG_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define ECHOCONFIG_TARGET_SSE2
+#define ECHOCONFIG_TARGET_AVX2
+#endif
+
+namespace echoconfig
+{
+    namespace
+    {
+        using Bitmaps = std::array<std::vector<std::uint64_t>, 2>;
+
+        /** One word of each bitmap, for 64 bytes of data. */
+        struct Words
+        {
+            std::uint64_t tag = 0;
+            std::uint64_t quote = 0;
+        };
+
+        constexpr std::uint8_t kTagBit = 1;
+        constexpr std::uint8_t kQuoteBit = 2;
+
+        constexpr auto kMarkBits = []()
+        {
+            std::array<std::uint8_t, 256> table{};
+            table['<'] = kTagBit;
+            table['"'] = kQuoteBit;
+            table['\''] = kQuoteBit;
+            return table;
+        }();
+
+        /** Index up to 64 bytes a byte at a time. */
+        Words scalarWords(const char* data, std::size_t size)
+        {
+            Words words;
+            for (std::size_t ix = 0; ix < size; ++ix)
+            {
+                const auto bits = kMarkBits[static_cast<unsigned char>(data[ix])];
+                words.tag |= std::uint64_t{(bits & kTagBit) != 0} << ix;
+                words.quote |= std::uint64_t{(bits & kQuoteBit) != 0} << ix;
+            }
+            return words;
+        }
+
+        void store(Bitmaps& bits, std::size_t wordIx, const Words& words)
+        {
+            bits[0][wordIx] = words.tag;
+            bits[1][wordIx] = words.quote;
+        }
+
+        void indexScalar(const char* data, std::size_t size, Bitmaps& bits)
+        {
+            for (std::size_t wordIx = 0; wordIx * 64 < size; ++wordIx)
+            {
+                store(bits, wordIx, scalarWords(data + wordIx * 64, std::min<std::size_t>(64, size - wordIx * 64)));
+            }
+        }
+
+#if ECHOCONFIG_X86
+        /** Widen a movemask result without sign-extending it. */
+        constexpr std::uint64_t sse2Mask(int mask) { return static_cast<std::uint16_t>(mask); }
+        constexpr std::uint64_t avx2Mask(int mask) { return static_cast<std::uint32_t>(mask); }
+
+        ECHOCONFIG_TARGET_SSE2 void indexSse2(const char* data, std::size_t size, Bitmaps& bits)
+        {
+            const auto tag = _mm_set1_epi8('<');
+            const auto quote = _mm_set1_epi8('"');
+            const auto apos = _mm_set1_epi8('\'');
+            std::size_t wordIx = 0;
+            for (; wordIx * 64 + 64 <= size; ++wordIx)
+            {
+                Words words;
+                for (unsigned int part = 0; part < 4; ++part)
+                {
+                    const auto chunk =
+                        _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + wordIx * 64 + part * 16));
+                    const auto quotes = _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, apos));
+                    words.tag |= sse2Mask(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, tag))) << (part * 16);
+                    words.quote |= sse2Mask(_mm_movemask_epi8(quotes)) << (part * 16);
+                }
+                store(bits, wordIx, words);
+            }
+            if (wordIx * 64 < size)
+            {
+                store(bits, wordIx, scalarWords(data + wordIx * 64, size - wordIx * 64));
+            }
+        }
+
+        ECHOCONFIG_TARGET_AVX2 void indexAvx2(const char* data, std::size_t size, Bitmaps& bits)
+        {
+            const auto tag = _mm256_set1_epi8('<');
+            const auto quote = _mm256_set1_epi8('"');
+            const auto apos = _mm256_set1_epi8('\'');
+            std::size_t wordIx = 0;
+            for (; wordIx * 64 + 64 <= size; ++wordIx)
+            {
+                Words words;
+                for (unsigned int part = 0; part < 2; ++part)
+                {
+                    const auto chunk =
+                        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + wordIx * 64 + part * 32));
+                    const auto quotes =
+                        _mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote), _mm256_cmpeq_epi8(chunk, apos));
+                    words.tag |= avx2Mask(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, tag))) << (part * 32);
+                    words.quote |= avx2Mask(_mm256_movemask_epi8(quotes)) << (part * 32);
+                }
+                store(bits, wordIx, words);
+            }
+            if (wordIx * 64 < size)
+            {
+                store(bits, wordIx, scalarWords(data + wordIx * 64, size - wordIx * 64));
+            }
+        }
+
+        bool cpuHasSse2()
+        {
+#if defined(__x86_64__) || defined(_M_X64)
+            // Part of the x86-64 baseline.
+            return true;
+#elif defined(_MSC_VER)
+            int info[4];
+            __cpuid(info, 1);
+            return (info[3] & (1 << 26)) != 0;
+#else
+            return __builtin_cpu_supports("sse2");
+#endif
+        }
+
+        bool cpuHasAvx2()
+        {
+#ifdef _MSC_VER
+            int info[4];
+            __cpuid(info, 0);
+            if (info[0] < 7)
+            {
+                return false;
+            }
+            // The OS must also save the wider registers when switching threads.
+            __cpuid(info, 1);
+            const bool osSavesYmm = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+            __cpuidex(info, 7, 0);
+            return osSavesYmm && (info[1] & (1 << 5)) != 0;
+#else
+            return __builtin_cpu_supports("avx2");
+#endif
+        }
+#endif
+    } // namespace
+
+    StructuralIndex::StructuralIndex(std::string_view data, std::size_t begin, std::size_t end) :
+        StructuralIndex(data, begin, end, bestIsa())
+    {}
+
+    StructuralIndex::StructuralIndex(std::string_view data, std::size_t begin, std::size_t end, Isa isa) :
+        begin_(std::min(begin, data.size())), end_(std::clamp(end, begin_, data.size()))
+    {
+        if (!isSupported(isa))
+        {
+            throw std::runtime_error("Instruction set not supported");
+        }
+        const auto* bytes = data.data() + begin_;
+        const auto size = end_ - begin_;
+        for (auto& bits : bits_)
+        {
+            bits.resize((size + 63) / 64);
+        }
+        switch (isa)
+        {
+#if ECHOCONFIG_X86
+        case Isa::Avx2:
+            indexAvx2(bytes, size, bits_);
+            break;
+        case Isa::Sse2:
+            indexSse2(bytes, size, bits_);
+            break;
+#endif
+        default:
+            indexScalar(bytes, size, bits_);
+            break;
+        }
+    }
+
+    std::size_t StructuralIndex::count(Mark mark) const
+    {
+        std::size_t count = 0;
+        for (const auto word : bits_[static_cast<std::size_t>(mark)])
+        {
+            count += static_cast<std::size_t>(std::popcount(word));
+        }
+        return count;
+    }
+
+    bool StructuralIndex::isSupported(Isa isa)
+    {
+        switch (isa)
+        {
+        case Isa::Scalar:
+            return true;
+#if ECHOCONFIG_X86
+        case Isa::Sse2:
+        {
+            static const bool supported = cpuHasSse2();
+            return supported;
+        }
+        case Isa::Avx2:
+        {
+            static const bool supported = cpuHasAvx2();
+            return supported;
+        }
+#endif
+        default:
+            return false;
+        }
+    }
+
+    StructuralIndex::Isa StructuralIndex::bestIsa()
+    {
+        static const Isa best = []()
+        {
+            for (const auto isa : {Isa::Avx2, Isa::Sse2})
+            {
+                if (isSupported(isa))
+                {
+                    return isa;
+                }
+            }
+            return Isa::Scalar;
+        }();
+        return best;
+    }
+} // namespace echoconfig
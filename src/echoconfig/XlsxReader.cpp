@@ -0,0 +1,433 @@
+/**
+ * @file XlsxReader.cpp
+ *
+ * @author Dan Keenan
+ * @date 10/17/2026
+ * @copyright GNU GPLv3
+ */
+
+#include "echoconfig/XlsxReader.h"
+#include <QIODevice>
+#include <stdexcept>
+#include "echoconfig/sheet_helpers.h"
+
+namespace echoconfig
+{
+    namespace
+    {
+        [[noreturn]] void malformed() { throw std::runtime_error("Failed to read spreadsheet"); }
+
+        struct Relationship
+        {
+            QString type;
+            /** Archive path. */
+            QString target;
+        };
+
+        /**
+         * Resolve relationship @p target relative to directory @p dir.
+         */
+        QString resolveTarget(const QString& dir, const QString& target)
+        {
+            if (target.startsWith(u'/'))
+            {
+                return target.mid(1);
+            }
+            auto parts = dir.split(u'/', Qt::SkipEmptyParts);
+            for (const auto& part : target.split(u'/', Qt::SkipEmptyParts))
+            {
+                if (part == QLatin1String(".."))
+                {
+                    if (!parts.isEmpty())
+                    {
+                        parts.removeLast();
+                    }
+                }
+                else if (part != QLatin1String("."))
+                {
+                    parts.append(part);
+                }
+            }
+            return parts.join(u'/');
+        }
+
+        /**
+         * Read the relationships of the part at @p partPath, by id.  Use an empty path for the package itself.
+         */
+        QHash<QString, Relationship> readRelationships(const ZipReader& zip, const QString& partPath)
+        {
+            const auto slash = partPath.lastIndexOf(u'/');
+            const auto dir = slash < 0 ? QString() : partPath.left(slash);
+            const auto relsPath = resolveTarget(dir, QStringLiteral("_rels/%1.rels").arg(partPath.mid(slash + 1)));
+            QHash<QString, Relationship> relationships;
+            if (!zip.contains(relsPath))
+            {
+                return relationships;
+            }
+
+            QXmlStreamReader xml(zip.read(relsPath));
+            while (!xml.atEnd())
+            {
+                if (xml.readNext() != QXmlStreamReader::StartElement || xml.name() != u"Relationship")
+                {
+                    continue;
+                }
+                const auto attrs = xml.attributes();
+                if (attrs.value(u"TargetMode") == u"External")
+                {
+                    continue;
+                }
+                relationships.insert(attrs.value(u"Id").toString(),
+                                     {
+                                         .type = attrs.value(u"Type").toString(),
+                                         .target = resolveTarget(dir, attrs.value(u"Target").toString()),
+                                     });
+            }
+            if (xml.hasError())
+            {
+                malformed();
+            }
+            return relationships;
+        }
+
+        /**
+         * Find the target of the first relationship in @p relationships with a type ending in @p typeName.
+         */
+        QString findTarget(const QHash<QString, Relationship>& relationships, QStringView typeName)
+        {
+            for (const auto& relationship : relationships)
+            {
+                if (relationship.type.endsWith(typeName))
+                {
+                    return relationship.target;
+                }
+            }
+            return {};
+        }
+
+        /**
+         * Get the column number from a cell reference like "AB12".
+         */
+        int parseColumn(QStringView ref)
+        {
+            int col = 0;
+            qsizetype ix = 0;
+            for (; ix < ref.size() && ref[ix] >= u'A' && ref[ix] <= u'Z'; ++ix)
+            {
+                col = col * 26 + (ref[ix].unicode() - u'A' + 1);
+                if (col > SheetRow::kMaxColumns)
+                {
+                    malformed();
+                }
+            }
+            if (ix == 0)
+            {
+                malformed();
+            }
+            return col;
+        }
+    } // namespace
+
+    XlsxReader::XlsxReader(QIODevice* device) : zip_(device)
+    {
+        auto workbookPath = findTarget(readRelationships(zip_, {}), u"/officeDocument");
+        if (workbookPath.isEmpty())
+        {
+            workbookPath = QStringLiteral("xl/workbook.xml");
+        }
+        if (!zip_.contains(workbookPath))
+        {
+            malformed();
+        }
+        const auto relationships = readRelationships(zip_, workbookPath);
+
+        QXmlStreamReader xml(zip_.read(workbookPath));
+        while (!xml.atEnd())
+        {
+            if (xml.readNext() != QXmlStreamReader::StartElement || xml.name() != u"sheet")
+            {
+                continue;
+            }
+            // The relationship id is namespaced; the prefix varies.
+            QString relationshipId;
+            for (const auto& attr : xml.attributes())
+            {
+                if (attr.name() == u"id" && !attr.namespaceUri().isEmpty())
+                {
+                    relationshipId = attr.value().toString();
+                }
+            }
+            const auto relationship = relationships.constFind(relationshipId);
+            if (relationship == relationships.cend())
+            {
+                malformed();
+            }
+            sheetNames_.append(xml.attributes().value(u"name").toString());
+            sheetPaths_.append(relationship->target);
+        }
+        if (xml.hasError())
+        {
+            malformed();
+        }
+
+        const auto sharedStringsPath = findTarget(relationships, u"/sharedStrings");
+        if (!sharedStringsPath.isEmpty() && zip_.contains(sharedStringsPath))
+        {
+            readSharedStrings(sharedStringsPath);
+        }
+    }
+
+    void XlsxReader::readSharedStrings(const QString& path)
+    {
+        const auto device = zip_.open(path);
+        QXmlStreamReader xml(device.get());
+        QString text;
+        while (!xml.atEnd())
+        {
+            const auto token = xml.readNext();
+            if (token == QXmlStreamReader::StartElement)
+            {
+                if (xml.name() == u"si")
+                {
+                    text.clear();
+                }
+                else if (xml.name() == u"t")
+                {
+                    text.append(xml.readElementText());
+                }
+                else if (xml.name() == u"rPh")
+                {
+                    // Phonetic hints aren't part of the value.
+                    xml.skipCurrentElement();
+                }
+            }
+            else if (token == QXmlStreamReader::EndElement && xml.name() == u"si")
+            {
+                sharedStrings_.append(text);
+            }
+        }
+        if (xml.hasError())
+        {
+            malformed();
+        }
+    }
+
+    XlsxSheetReader::XlsxSheetReader(const XlsxReader& workbook, const QString& name) : workbook_(workbook)
+    {
+        const auto sheetIx = workbook_.sheetNames_.indexOf(name);
+        if (sheetIx < 0)
+        {
+            throw std::runtime_error("Missing sheet");
+        }
+        device_ = workbook_.zip_.open(workbook_.sheetPaths_.at(sheetIx));
+        xml_.setDevice(device_.get());
+    }
+
+    bool XlsxSheetReader::readRow()
+    {
+        row_.clear();
+
+        while (!xml_.atEnd())
+        {
+            if (xml_.readNext() != QXmlStreamReader::StartElement || xml_.name() != u"row")
+            {
+                continue;
+            }
+            const auto ref = xml_.attributes().value(u"r");
+            if (ref.isEmpty())
+            {
+                ++rowNum_;
+            }
+            else
+            {
+                bool ok;
+                rowNum_ = ref.toInt(&ok);
+                if (!ok)
+                {
+                    malformed();
+                }
+            }
+
+            int col = 0;
+            while (!xml_.atEnd())
+            {
+                const auto token = xml_.readNext();
+                if (token == QXmlStreamReader::StartElement && xml_.name() == u"c")
+                {
+                    col = readCell(col);
+                }
+                else if (token == QXmlStreamReader::EndElement && xml_.name() == u"row")
+                {
+                    break;
+                }
+            }
+            if (!row_.empty())
+            {
+                return true;
+            }
+        }
+        if (xml_.hasError())
+        {
+            malformed();
+        }
+        return false;
+    }
+
+    int XlsxSheetReader::readCell(int prevCol)
+    {
+        const auto attrs = xml_.attributes();
+        const auto ref = attrs.value(u"r");
+        const auto col = ref.isEmpty() ? prevCol + 1 : parseColumn(ref);
+        if (col > SheetRow::kMaxColumns)
+        {
+            malformed();
+        }
+        const auto typeAttr = attrs.value(u"t");
+        auto type = CellType::Number;
+        bool isSharedString = false;
+        if (typeAttr == u"s")
+        {
+            type = CellType::String;
+            isSharedString = true;
+        }
+        else if (typeAttr == u"str" || typeAttr == u"inlineStr" || typeAttr == u"d")
+        {
+            type = CellType::String;
+        }
+        else if (typeAttr == u"b")
+        {
+            type = CellType::Boolean;
+        }
+        else if (typeAttr == u"e")
+        {
+            type = CellType::Error;
+        }
+
+        bool hasValue = false;
+        while (!xml_.atEnd())
+        {
+            const auto token = xml_.readNext();
+            if (token == QXmlStreamReader::StartElement)
+            {
+                if (xml_.name() == u"v")
+                {
+                    readValue();
+                    hasValue = true;
+                }
+                else if (xml_.name() == u"is")
+                {
+                    readInlineString();
+                    hasValue = true;
+                }
+                else
+                {
+                    // Formulas and extensions.
+                    xml_.skipCurrentElement();
+                }
+            }
+            else if (token == QXmlStreamReader::EndElement && xml_.name() == u"c")
+            {
+                break;
+            }
+        }
+        if (xml_.hasError())
+        {
+            malformed();
+        }
+        if (!hasValue)
+        {
+            return col;
+        }
+
+        auto& cell = row_.add(Cell{.col = col, .type = type});
+        switch (type)
+        {
+        case CellType::Number:
+        case CellType::Boolean:
+            cell.number = parseNumber();
+            break;
+        case CellType::String:
+            if (isSharedString)
+            {
+                const auto ix = parseNumber();
+                if (ix < 0 || ix >= workbook_.sharedStrings_.size())
+                {
+                    malformed();
+                }
+                cell.text = workbook_.sharedStrings_.at(static_cast<qsizetype>(ix));
+            }
+            else
+            {
+                cell.text = value_;
+            }
+            break;
+        case CellType::Error:
+            cell.text = value_;
+            break;
+        }
+        return col;
+    }
+
+    void XlsxSheetReader::readValue()
+    {
+        value_.resize(0);
+        while (!xml_.atEnd())
+        {
+            const auto token = xml_.readNext();
+            if (token == QXmlStreamReader::Characters)
+            {
+                value_.append(xml_.text());
+            }
+            else if (token == QXmlStreamReader::EndElement)
+            {
+                return;
+            }
+            else if (token != QXmlStreamReader::Comment)
+            {
+                malformed();
+            }
+        }
+        malformed();
+    }
+
+    void XlsxSheetReader::readInlineString()
+    {
+        value_.resize(0);
+        while (!xml_.atEnd())
+        {
+            const auto token = xml_.readNext();
+            if (token == QXmlStreamReader::StartElement)
+            {
+                if (xml_.name() == u"t")
+                {
+                    value_.append(xml_.readElementText());
+                }
+                else if (xml_.name() == u"rPh")
+                {
+                    xml_.skipCurrentElement();
+                }
+            }
+            else if (token == QXmlStreamReader::EndElement && xml_.name() == u"is")
+            {
+                return;
+            }
+        }
+        malformed();
+    }
+
+    double XlsxSheetReader::parseNumber() const
+    {
+        if (const auto number = sheet_helpers::parseDigits(value_); number.has_value())
+        {
+            return number.value();
+        }
+
+        bool ok;
+        const auto val = QStringView(value_).trimmed().toDouble(&ok);
+        if (!ok)
+        {
+            malformed();
+        }
+        return val;
+    }
+} // namespace echoconfig
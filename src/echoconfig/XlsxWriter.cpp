@@ -0,0 +1,274 @@
+/**
+ * @file XlsxWriter.cpp
+ *
+ * @author Dan Keenan
+ * @date 10/17/2026
+ * @copyright GNU GPLv3
+ */
+
+#include "echoconfig/XlsxWriter.h"
+#include <mutex>
+#include <stdexcept>
+
+namespace echoconfig
+{
+    namespace
+    {
+        /** Hand sheet XML to the zip writer in chunks about this big. */
+        constexpr qsizetype kFlushSize = 64 * 1024;
+
+        constexpr auto kXmlDecl = R"(<?xml version="1.0" encoding="UTF-8" standalone="yes"?>)";
+        constexpr auto kNsMain = "http://schemas.openxmlformats.org/spreadsheetml/2006/main";
+        constexpr auto kNsRelationships = "http://schemas.openxmlformats.org/officeDocument/2006/relationships";
+        constexpr auto kNsPackageRelationships = "http://schemas.openxmlformats.org/package/2006/relationships";
+        constexpr auto kNsContentTypes = "http://schemas.openxmlformats.org/package/2006/content-types";
+
+        constexpr auto kStyles =
+            R"(<styleSheet xmlns="http://schemas.openxmlformats.org/spreadsheetml/2006/main">)"
+            R"(<fonts count="1"><font><name val="Calibri"/></font></fonts>)"
+            R"(<fills count="2"><fill><patternFill patternType="none"/></fill>)"
+            R"(<fill><patternFill patternType="gray125"/></fill></fills>)"
+            R"(<borders count="1"><border><left/><right/><top/><bottom/><diagonal/></border></borders>)"
+            R"(<cellStyleXfs count="1"><xf numFmtId="0" fontId="0" fillId="0" borderId="0"/></cellStyleXfs>)"
+            R"(<cellXfs count="1"><xf numFmtId="0" fontId="0" fillId="0" borderId="0" xfId="0"/></cellXfs>)"
+            R"(<cellStyles count="1"><cellStyle name="Normal" xfId="0" builtinId="0"/></cellStyles>)"
+            R"(</styleSheet>)";
+
+        QByteArray xmlEscaped(const QString& text) { return text.toHtmlEscaped().toUtf8(); }
+    } // namespace
+
+    XlsxSheetWriter::XlsxSheetWriter(XlsxWriter& workbook, bool direct, int rowCount, int columnCount) :
+        workbook_(workbook)
+    {
+        if (!direct)
+        {
+            compressor_.emplace(workbook_.zip_.options());
+        }
+
+        buffer_.append(kXmlDecl);
+        buffer_.append(R"(<worksheet xmlns=")").append(kNsMain);
+        buffer_.append(R"(" xmlns:r=")").append(kNsRelationships).append(R"(">)");
+        if (rowCount > 0 && columnCount > 0)
+        {
+            buffer_.append(R"(<dimension ref="A1:)");
+            buffer_.append(XlsxWriter::columnName(columnCount)).append(QByteArray::number(rowCount)).append(R"("/>)");
+        }
+        buffer_.append(R"(<sheetViews><sheetView workbookViewId="0"/></sheetViews>)");
+        buffer_.append("<sheetData>");
+    }
+
+    void XlsxSheetWriter::beginRow()
+    {
+        ++row_;
+        buffer_.append(R"(<row r=")").append(QByteArray::number(row_)).append(R"(">)");
+    }
+
+    void XlsxSheetWriter::endRow()
+    {
+        buffer_.append("</row>");
+        flush(false);
+    }
+
+    void XlsxSheetWriter::writeString(int col, const QString& value)
+    {
+        const auto ix = workbook_.stringIndex(value);
+        writeCellRef(col);
+        buffer_.append(R"(" t="s"><v>)").append(QByteArray::number(ix)).append("</v></c>");
+    }
+
+    void XlsxSheetWriter::writeNumber(int col, unsigned int value)
+    {
+        writeCellRef(col);
+        buffer_.append(R"(" t="n"><v>)").append(QByteArray::number(value)).append("</v></c>");
+    }
+
+    void XlsxSheetWriter::end()
+    {
+        if (ended_)
+        {
+            return;
+        }
+        buffer_.append("</sheetData></worksheet>");
+        flush(true);
+        if (compressor_.has_value())
+        {
+            compressor_->finish();
+        }
+        else
+        {
+            workbook_.zip_.endFile();
+            workbook_.directSheet_ = nullptr;
+        }
+        ended_ = true;
+        buffer_ = QByteArray();
+    }
+
+    void XlsxSheetWriter::writeCellRef(int col)
+    {
+        buffer_.append(R"(<c r=")").append(XlsxWriter::columnName(col)).append(QByteArray::number(row_));
+    }
+
+    void XlsxSheetWriter::flush(bool force)
+    {
+        if (ended_)
+        {
+            throw std::runtime_error("Sheet already ended");
+        }
+        if (force || buffer_.size() >= kFlushSize)
+        {
+            if (compressor_.has_value())
+            {
+                compressor_->write(buffer_);
+            }
+            else
+            {
+                workbook_.zip_.write(buffer_);
+            }
+            // Keeps the allocation, unlike clear().
+            buffer_.resize(0);
+        }
+    }
+
+    XlsxWriter::XlsxWriter(QIODevice* device, const ZipOptions& options) : zip_(device, options) {}
+
+    XlsxSheetWriter& XlsxWriter::addSheet(const QString& name, int rowCount, int columnCount)
+    {
+        if (finished_)
+        {
+            throw std::runtime_error("Workbook already finished");
+        }
+        sheetNames_.append(name);
+        const bool direct = directSheet_ == nullptr;
+        // Not make_unique, as the constructor is private.
+        auto& sheet = *sheets_.emplace_back(new XlsxSheetWriter(*this, direct, rowCount, columnCount));
+        if (direct)
+        {
+            zip_.beginFile(sheetPath(sheetNames_.size()));
+            directSheet_ = &sheet;
+        }
+        return sheet;
+    }
+
+    void XlsxWriter::finish()
+    {
+        if (finished_)
+        {
+            return;
+        }
+        for (const auto& sheet : sheets_)
+        {
+            sheet->end();
+        }
+        for (std::size_t ix = 0; ix < sheets_.size(); ++ix)
+        {
+            if (sheets_[ix]->compressor_.has_value())
+            {
+                zip_.addCompressed(sheetPath(static_cast<int>(ix) + 1), *sheets_[ix]->compressor_);
+            }
+        }
+        sheets_.clear();
+
+        // Shared strings.
+        QByteArray sst(kXmlDecl);
+        sst.append(R"(<sst xmlns=")").append(kNsMain).append(R"(" count=")").append(QByteArray::number(stringRefs_));
+        sst.append(R"(" uniqueCount=")").append(QByteArray::number(strings_.size())).append(R"(">)");
+        for (const auto& string : strings_)
+        {
+            if (string != string.trimmed())
+            {
+                sst.append(R"(<si><t xml:space="preserve">)");
+            }
+            else
+            {
+                sst.append("<si><t>");
+            }
+            sst.append(xmlEscaped(string)).append("</t></si>");
+        }
+        sst.append("</sst>");
+        zip_.addFile(QStringLiteral("xl/sharedStrings.xml"), sst);
+
+        zip_.addFile(QStringLiteral("xl/styles.xml"), QByteArray(kXmlDecl).append(kStyles));
+
+        // Workbook and its relationships.  Sheet n is rIdn; styles and strings come after the sheets.
+        QByteArray workbook(kXmlDecl);
+        workbook.append(R"(<workbook xmlns=")").append(kNsMain);
+        workbook.append(R"(" xmlns:r=")").append(kNsRelationships).append(R"(">)");
+        workbook.append(R"(<bookViews><workbookView activeTab="0"/></bookViews><sheets>)");
+        QByteArray workbookRels(kXmlDecl);
+        workbookRels.append(R"(<Relationships xmlns=")").append(kNsPackageRelationships).append(R"(">)");
+        QByteArray contentTypes(kXmlDecl);
+        contentTypes.append(R"(<Types xmlns=")").append(kNsContentTypes).append(R"(">)");
+        contentTypes.append(R"(<Default Extension="rels" )"
+                            R"(ContentType="application/vnd.openxmlformats-package.relationships+xml"/>)");
+        contentTypes.append(R"(<Default Extension="xml" ContentType="application/xml"/>)");
+        contentTypes.append(R"(<Override PartName="/xl/workbook.xml" ContentType=")"
+                            R"(application/vnd.openxmlformats-officedocument.spreadsheetml.sheet.main+xml"/>)");
+        for (int ix = 1; ix <= sheetNames_.size(); ++ix)
+        {
+            const auto num = QByteArray::number(ix);
+            workbook.append(R"(<sheet name=")").append(xmlEscaped(sheetNames_.at(ix - 1)));
+            workbook.append(R"(" sheetId=")").append(num).append(R"(" r:id="rId)").append(num).append(R"("/>)");
+            workbookRels.append(R"(<Relationship Id="rId)").append(num);
+            workbookRels.append(R"(" Type="http://schemas.openxmlformats.org/officeDocument/2006/relationships/)"
+                                R"(worksheet" Target="worksheets/sheet)");
+            workbookRels.append(num).append(R"(.xml"/>)");
+            contentTypes.append(R"(<Override PartName="/xl/worksheets/sheet)").append(num);
+            contentTypes.append(R"(.xml" ContentType=")"
+                                R"(application/vnd.openxmlformats-officedocument.spreadsheetml.worksheet+xml"/>)");
+        }
+        workbook.append("</sheets></workbook>");
+        const auto stylesId = QByteArray::number(sheetNames_.size() + 1);
+        const auto stringsId = QByteArray::number(sheetNames_.size() + 2);
+        workbookRels.append(R"(<Relationship Id="rId)").append(stylesId);
+        workbookRels.append(R"(" Type="http://schemas.openxmlformats.org/officeDocument/2006/relationships/)"
+                            R"(styles" Target="styles.xml"/>)");
+        workbookRels.append(R"(<Relationship Id="rId)").append(stringsId);
+        workbookRels.append(R"(" Type="http://schemas.openxmlformats.org/officeDocument/2006/relationships/)"
+                            R"(sharedStrings" Target="sharedStrings.xml"/>)");
+        workbookRels.append("</Relationships>");
+        contentTypes.append(R"(<Override PartName="/xl/styles.xml" ContentType=")"
+                            R"(application/vnd.openxmlformats-officedocument.spreadsheetml.styles+xml"/>)");
+        contentTypes.append(R"(<Override PartName="/xl/sharedStrings.xml" ContentType=")"
+                            R"(application/vnd.openxmlformats-officedocument.spreadsheetml.sharedStrings+xml"/>)");
+        contentTypes.append("</Types>");
+        zip_.addFile(QStringLiteral("xl/workbook.xml"), workbook);
+        zip_.addFile(QStringLiteral("xl/_rels/workbook.xml.rels"), workbookRels);
+        zip_.addFile(QStringLiteral("[Content_Types].xml"), contentTypes);
+
+        QByteArray rels(kXmlDecl);
+        rels.append(R"(<Relationships xmlns=")").append(kNsPackageRelationships).append(R"(">)");
+        rels.append(R"(<Relationship Id="rId1" )"
+                    R"(Type="http://schemas.openxmlformats.org/officeDocument/2006/relationships/officeDocument" )"
+                    R"(Target="xl/workbook.xml"/>)");
+        rels.append("</Relationships>");
+        zip_.addFile(QStringLiteral("_rels/.rels"), rels);
+
+        zip_.finish();
+        finished_ = true;
+    }
+
+    QByteArray XlsxWriter::columnName(int col)
+    {
+        QByteArray name;
+        for (; col > 0; col = (col - 1) / 26)
+        {
+            name.prepend(static_cast<char>('A' + (col - 1) % 26));
+        }
+        return name;
+    }
+
+    int XlsxWriter::stringIndex(const QString& value)
+    {
+        const std::scoped_lock lock(stringsMutex_);
+        auto it = stringIxs_.constFind(value);
+        if (it == stringIxs_.cend())
+        {
+            it = stringIxs_.insert(value, strings_.size());
+            strings_.append(value);
+        }
+        ++stringRefs_;
+        return it.value();
+    }
+
+    QString XlsxWriter::sheetPath(int sheetNum) { return QStringLiteral("xl/worksheets/sheet%1.xml").arg(sheetNum); }
+} // namespace echoconfig
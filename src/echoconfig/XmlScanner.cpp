@@ -0,0 +1,491 @@
+/**
+ * @file XmlScanner.cpp
+ *
+ * @author Dan Keenan
+ * @date 10/17/2026
+ * @copyright GNU GPLv3
+ */
+
+#include "echoconfig/XmlScanner.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace echoconfig
+{
+    namespace
+    {
+        constexpr bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+
+        constexpr bool isNameEnd(char c) { return isSpace(c) || c == '/' || c == '>' || c == '='; }
+
+        [[noreturn]] void malformed() { throw std::runtime_error("Failed to read file"); }
+
+        bool isBlank(std::string_view text)
+        {
+            return std::ranges::all_of(text, [](char c) { return isSpace(c); });
+        }
+
+        std::string_view trimmed(std::string_view text)
+        {
+            // QString::toUInt() also skips vertical tab and form feed.
+            constexpr std::string_view kWhitespace = " \t\n\r\v\f";
+            const auto first = text.find_first_not_of(kWhitespace);
+            if (first == std::string_view::npos)
+            {
+                return {};
+            }
+            return text.substr(first, text.find_last_not_of(kWhitespace) - first + 1);
+        }
+
+        void appendUtf8(std::string& out, char32_t codePoint)
+        {
+            if (codePoint == 0 || codePoint > 0x10FFFF || (codePoint >= 0xD800 && codePoint <= 0xDFFF))
+            {
+                malformed();
+            }
+            if (codePoint < 0x80)
+            {
+                out += static_cast<char>(codePoint);
+            }
+            else if (codePoint < 0x800)
+            {
+                out += static_cast<char>(0xC0 | (codePoint >> 6));
+                out += static_cast<char>(0x80 | (codePoint & 0x3F));
+            }
+            else if (codePoint < 0x10000)
+            {
+                out += static_cast<char>(0xE0 | (codePoint >> 12));
+                out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+                out += static_cast<char>(0x80 | (codePoint & 0x3F));
+            }
+            else
+            {
+                out += static_cast<char>(0xF0 | (codePoint >> 18));
+                out += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+                out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+                out += static_cast<char>(0x80 | (codePoint & 0x3F));
+            }
+        }
+    } // namespace
+
+    XmlScanner::XmlScanner(std::string_view data, std::shared_ptr<const StructuralIndex> index) :
+        XmlScanner(data, 0, data.size(), {}, std::move(index))
+    {}
+
+    XmlScanner::XmlScanner(std::string_view data, std::size_t begin, std::size_t end,
+                           std::vector<std::string_view> openElements, std::shared_ptr<const StructuralIndex> index) :
+        data_(data.substr(0, end)), pos_(begin), index_(std::move(index)), openElements_(std::move(openElements)),
+        seenRoot_(!openElements_.empty()), endsDocument_(end >= data.size())
+    {
+        // Skip the UTF-8 byte order mark.
+        if (pos_ == 0 && data_.starts_with("\xEF\xBB\xBF"))
+        {
+            pos_ = 3;
+        }
+        if (index_ == nullptr)
+        {
+            index_ = std::make_shared<const StructuralIndex>(data_, pos_, data_.size());
+        }
+        Q_ASSERT(index_->begin() <= pos_ && index_->end() >= data_.size());
+    }
+
+    bool XmlScanner::readNextStartElement()
+    {
+        while (true)
+        {
+            const auto markupStart = find(StructuralIndex::Mark::Tag, pos_);
+            if (openElements_.empty() &&
+                !isBlank(data_.substr(pos_, std::min(markupStart, data_.size()) - pos_)))
+            {
+                // Text outside the root element.
+                malformed();
+            }
+            if (markupStart == std::string_view::npos)
+            {
+                if (endsDocument_ && (!seenRoot_ || !openElements_.empty()))
+                {
+                    malformed();
+                }
+                pos_ = data_.size();
+                return false;
+            }
+
+            pos_ = markupStart + 1;
+            const auto rest = data_.substr(pos_);
+            if (rest.starts_with('?'))
+            {
+                skipPast("?>");
+            }
+            else if (rest.starts_with("!--"))
+            {
+                skipPast("-->");
+            }
+            else if (rest.starts_with("![CDATA["))
+            {
+                if (openElements_.empty())
+                {
+                    malformed();
+                }
+                skipPast("]]>");
+            }
+            else if (rest.starts_with("!DOCTYPE"))
+            {
+                if (seenRoot_)
+                {
+                    malformed();
+                }
+                skipDoctype();
+            }
+            else if (rest.starts_with('/'))
+            {
+                readEndTag();
+            }
+            else
+            {
+                if (seenRoot_ && openElements_.empty())
+                {
+                    // A second root element.
+                    malformed();
+                }
+                readStartTag();
+                return true;
+            }
+        }
+    }
+
+    std::optional<std::string_view> XmlScanner::rawAttribute(std::string_view name) const
+    {
+        for (const auto& attr : attributes_)
+        {
+            if (attr.name == name)
+            {
+                return attr.rawValue;
+            }
+        }
+        return std::nullopt;
+    }
+
+    QString XmlScanner::attribute(std::string_view name) const
+    {
+        const auto rawValue = rawAttribute(name);
+        if (!rawValue.has_value())
+        {
+            return {};
+        }
+        return decodeAttrValue(rawValue.value());
+    }
+
+    unsigned int XmlScanner::requiredAttrUInt(std::string_view name) const
+    {
+        const auto rawValue = rawAttribute(name);
+        if (!rawValue.has_value())
+        {
+            throw std::runtime_error("Required attribute missing");
+        }
+        if (rawValue->find('&') != std::string_view::npos)
+        {
+            // Rare enough that it's not worth handling without allocating.
+            bool isInt;
+            const unsigned int val = decodeAttrValue(rawValue.value()).toUInt(&isInt);
+            if (!isInt)
+            {
+                throw std::runtime_error("Not a UInt");
+            }
+            return val;
+        }
+
+        auto digits = trimmed(rawValue.value());
+        if (digits.starts_with('+'))
+        {
+            digits.remove_prefix(1);
+        }
+        unsigned long long val = 0;
+        const auto* end = digits.data() + digits.size();
+        const auto [ptr, ec] = std::from_chars(digits.data(), end, val);
+        if (digits.empty() || ec != std::errc() || ptr != end || val > std::numeric_limits<unsigned int>::max())
+        {
+            throw std::runtime_error("Not a UInt");
+        }
+        return static_cast<unsigned int>(val);
+    }
+
+    QString XmlScanner::decodeAttrValue(std::string_view rawValue)
+    {
+        if (rawValue.find_first_of("&\t\n\r") == std::string_view::npos)
+        {
+            return QString::fromUtf8(rawValue.data(), static_cast<qsizetype>(rawValue.size()));
+        }
+
+        std::string decoded;
+        decoded.reserve(rawValue.size());
+        for (std::size_t ix = 0; ix < rawValue.size(); ++ix)
+        {
+            const char c = rawValue[ix];
+            if (c == '\r')
+            {
+                // Line endings are normalized to a single newline, which then becomes a space.
+                if (ix + 1 < rawValue.size() && rawValue[ix + 1] == '\n')
+                {
+                    ++ix;
+                }
+                decoded += ' ';
+            }
+            else if (c == '\t' || c == '\n')
+            {
+                decoded += ' ';
+            }
+            else if (c == '&')
+            {
+                const auto end = rawValue.find(';', ix);
+                if (end == std::string_view::npos)
+                {
+                    malformed();
+                }
+                const auto entity = rawValue.substr(ix + 1, end - ix - 1);
+                if (entity == "lt")
+                {
+                    decoded += '<';
+                }
+                else if (entity == "gt")
+                {
+                    decoded += '>';
+                }
+                else if (entity == "amp")
+                {
+                    decoded += '&';
+                }
+                else if (entity == "apos")
+                {
+                    decoded += '\'';
+                }
+                else if (entity == "quot")
+                {
+                    decoded += '"';
+                }
+                else if (entity.starts_with('#'))
+                {
+                    const bool hex = entity.starts_with("#x");
+                    const auto digits = entity.substr(hex ? 2 : 1);
+                    std::uint32_t codePoint = 0;
+                    const auto* digitsEnd = digits.data() + digits.size();
+                    const auto [ptr, ec] = std::from_chars(digits.data(), digitsEnd, codePoint, hex ? 16 : 10);
+                    if (digits.empty() || ec != std::errc() || ptr != digitsEnd)
+                    {
+                        malformed();
+                    }
+                    appendUtf8(decoded, codePoint);
+                }
+                else
+                {
+                    malformed();
+                }
+                ix = end;
+            }
+            else
+            {
+                decoded += c;
+            }
+        }
+        return QString::fromStdString(decoded);
+    }
+
+    bool XmlScanner::isUtf8Document(std::string_view data)
+    {
+        if (data.starts_with("\xFF\xFE") || data.starts_with("\xFE\xFF"))
+        {
+            return false;
+        }
+        if (!data.starts_with("<?xml") && !data.starts_with("\xEF\xBB\xBF<?xml"))
+        {
+            return true;
+        }
+        const auto range = declaredEncoding(data);
+        if (!range.has_value())
+        {
+            // UTF-8 is the default.
+            return data.find("encoding") > data.find("?>");
+        }
+        const auto encodingName = data.substr(range->first, range->second);
+        const auto encoding =
+            QString::fromLatin1(encodingName.data(), static_cast<qsizetype>(encodingName.size())).toLower();
+        return encoding == QStringLiteral("utf-8") || encoding == QStringLiteral("utf8") ||
+            encoding == QStringLiteral("us-ascii");
+    }
+
+    std::optional<std::pair<std::size_t, std::size_t>> XmlScanner::declaredEncoding(std::string_view data)
+    {
+        const std::size_t start = data.starts_with("\xEF\xBB\xBF") ? 3 : 0;
+        if (data.substr(start, 5) != "<?xml")
+        {
+            return std::nullopt;
+        }
+        const auto declarationEnd = data.find("?>", start);
+        const auto encodingPos = data.find("encoding", start);
+        if (declarationEnd == std::string_view::npos || encodingPos > declarationEnd)
+        {
+            return std::nullopt;
+        }
+        const auto quotePos = data.find_first_of("\"'", encodingPos);
+        if (quotePos > declarationEnd)
+        {
+            return std::nullopt;
+        }
+        const auto valueEnd = data.find(data[quotePos], quotePos + 1);
+        if (valueEnd > declarationEnd)
+        {
+            return std::nullopt;
+        }
+        return std::make_pair(quotePos + 1, valueEnd - quotePos - 1);
+    }
+
+    void XmlScanner::skipPast(std::string_view terminator)
+    {
+        const auto end = data_.find(terminator, pos_);
+        if (end == std::string_view::npos)
+        {
+            malformed();
+        }
+        pos_ = end + terminator.size();
+    }
+
+    void XmlScanner::skipDoctype()
+    {
+        // Skip any internal subset in brackets.
+        int depth = 0;
+        for (; pos_ < data_.size(); ++pos_)
+        {
+            const char c = data_[pos_];
+            if (c == '[')
+            {
+                ++depth;
+            }
+            else if (c == ']')
+            {
+                --depth;
+            }
+            else if (c == '>' && depth == 0)
+            {
+                ++pos_;
+                return;
+            }
+        }
+        malformed();
+    }
+
+    void XmlScanner::skipSpace()
+    {
+        while (pos_ < data_.size() && isSpace(data_[pos_]))
+        {
+            ++pos_;
+        }
+    }
+
+    void XmlScanner::readEndTag()
+    {
+        // Skip the slash.
+        ++pos_;
+        const auto end = data_.find('>', pos_);
+        if (end == std::string_view::npos || openElements_.empty())
+        {
+            malformed();
+        }
+        auto name = data_.substr(pos_, end - pos_);
+        while (!name.empty() && isSpace(name.back()))
+        {
+            name.remove_suffix(1);
+        }
+        if (name != openElements_.back())
+        {
+            malformed();
+        }
+        openElements_.pop_back();
+        pos_ = end + 1;
+    }
+
+    void XmlScanner::readStartTag()
+    {
+        const auto nameStart = pos_;
+        while (pos_ < data_.size() && !isNameEnd(data_[pos_]))
+        {
+            ++pos_;
+        }
+        if (pos_ == nameStart)
+        {
+            malformed();
+        }
+        name_ = data_.substr(nameStart, pos_ - nameStart);
+        seenRoot_ = true;
+
+        attributes_.clear();
+        while (true)
+        {
+            const auto beforeSpace = pos_;
+            skipSpace();
+            if (pos_ >= data_.size())
+            {
+                malformed();
+            }
+            const char c = data_[pos_];
+            if (c == '>')
+            {
+                ++pos_;
+                openElements_.push_back(name_);
+                return;
+            }
+            if (c == '/')
+            {
+                if (pos_ + 1 >= data_.size() || data_[pos_ + 1] != '>')
+                {
+                    malformed();
+                }
+                pos_ += 2;
+                return;
+            }
+            if (pos_ == beforeSpace)
+            {
+                // Attributes must be separated by whitespace.
+                malformed();
+            }
+
+            const auto attrNameStart = pos_;
+            while (pos_ < data_.size() && !isNameEnd(data_[pos_]))
+            {
+                ++pos_;
+            }
+            const auto attrName = data_.substr(attrNameStart, pos_ - attrNameStart);
+            skipSpace();
+            if (attrName.empty() || pos_ >= data_.size() || data_[pos_] != '=')
+            {
+                malformed();
+            }
+            ++pos_;
+            skipSpace();
+            if (pos_ >= data_.size() || (data_[pos_] != '"' && data_[pos_] != '\''))
+            {
+                malformed();
+            }
+            const char quote = data_[pos_++];
+            auto valueEnd = find(StructuralIndex::Mark::Quote, pos_);
+            while (valueEnd != std::string_view::npos && data_[valueEnd] != quote)
+            {
+                // The other kind of quote.
+                valueEnd = find(StructuralIndex::Mark::Quote, valueEnd + 1);
+            }
+            // Values can't contain '<'.
+            if (valueEnd == std::string_view::npos || find(StructuralIndex::Mark::Tag, pos_) < valueEnd ||
+                hasAttribute(attrName))
+            {
+                malformed();
+            }
+            const auto rawValue = data_.substr(pos_, valueEnd - pos_);
+            attributes_.push_back({attrName, rawValue});
+            pos_ = valueEnd + 1;
+        }
+    }
+} // namespace echoconfig
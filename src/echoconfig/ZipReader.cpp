@@ -0,0 +1,316 @@
+/**
+ * @file ZipReader.cpp
+ *
+ * @author Dan Keenan
+ * @date 10/17/2026
+ * @copyright GNU GPLv3
+ */
+
+#include "echoconfig/ZipReader.h"
+#include <QIODevice>
+#include <QtEndian>
+#include <algorithm>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <zlib.h>
+
+namespace echoconfig
+{
+    namespace
+    {
+        constexpr quint32 kLocalHeaderSig = 0x04034b50;
+        constexpr quint32 kCentralHeaderSig = 0x02014b50;
+        constexpr quint32 kEndOfCentralDirSig = 0x06054b50;
+        constexpr qint64 kLocalHeaderSize = 30;
+        constexpr qint64 kCentralHeaderSize = 46;
+        constexpr qint64 kEndOfCentralDirSize = 22;
+        constexpr quint16 kFlagEncrypted = 0x0001;
+        constexpr quint16 kMethodStore = 0;
+        constexpr quint16 kMethodDeflate = 8;
+        constexpr qint64 kInBufSize = 64 * 1024;
+
+        [[noreturn]] void malformed() { throw std::runtime_error("Failed to read archive"); }
+
+        quint16 get16(const QByteArray& data, qsizetype pos)
+        {
+            if (pos + 2 > data.size())
+            {
+                malformed();
+            }
+            return qFromLittleEndian<quint16>(data.constData() + pos);
+        }
+
+        quint32 get32(const QByteArray& data, qsizetype pos)
+        {
+            if (pos + 4 > data.size())
+            {
+                malformed();
+            }
+            return qFromLittleEndian<quint32>(data.constData() + pos);
+        }
+
+        QByteArray readAt(QIODevice* device, qint64 pos, qint64 size)
+        {
+            if (!device->seek(pos))
+            {
+                malformed();
+            }
+            auto data = device->read(size);
+            if (data.size() != size)
+            {
+                malformed();
+            }
+            return data;
+        }
+
+        /**
+         * Decompresses one file as it is read.
+         */
+        class EntryDevice : public QIODevice
+        {
+        public:
+            EntryDevice(QIODevice* source, std::mutex& sourceMutex, qint64 dataOffset, quint16 method, quint32 crc,
+                        qint64 compressedSize, qint64 size) :
+                source_(source), sourceMutex_(sourceMutex), sourcePos_(dataOffset), compressedLeft_(compressedSize),
+                method_(method), expectedCrc_(crc), expectedSize_(size)
+            {
+                if (method_ == kMethodDeflate && inflateInit2(&zs_, -MAX_WBITS) != Z_OK)
+                {
+                    throw std::runtime_error("Failed to initialize decompression");
+                }
+                QIODevice::open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+            }
+
+            ~EntryDevice() override
+            {
+                if (method_ == kMethodDeflate)
+                {
+                    inflateEnd(&zs_);
+                }
+            }
+
+            [[nodiscard]] bool isSequential() const override { return true; }
+
+        protected:
+            qint64 readData(char* data, qint64 maxSize) override
+            {
+                if (finished_ || maxSize <= 0)
+                {
+                    return 0;
+                }
+
+                qint64 produced = 0;
+                if (method_ == kMethodStore)
+                {
+                    const auto want = std::min(maxSize, compressedLeft_);
+                    produced = readSource(data, want);
+                    if (produced < 0 || (produced == 0 && want > 0))
+                    {
+                        return fail();
+                    }
+                    sourcePos_ += produced;
+                    compressedLeft_ -= produced;
+                    finished_ = compressedLeft_ == 0;
+                }
+                else
+                {
+                    zs_.next_out = reinterpret_cast<Bytef*>(data);
+                    zs_.avail_out = static_cast<uInt>(std::min<qint64>(maxSize, std::numeric_limits<uInt>::max()));
+                    while (zs_.avail_out > 0 && !finished_)
+                    {
+                        if (zs_.avail_in == 0 && compressedLeft_ > 0 && !fillInput())
+                        {
+                            return fail();
+                        }
+                        const auto ret = inflate(&zs_, Z_NO_FLUSH);
+                        if (ret == Z_STREAM_END)
+                        {
+                            finished_ = true;
+                        }
+                        else if (ret != Z_OK)
+                        {
+                            // Z_BUF_ERROR here means the data is truncated.
+                            return fail();
+                        }
+                        // Hand back what's there rather than waiting to fill the caller's buffer.
+                        if (zs_.next_out != reinterpret_cast<Bytef*>(data))
+                        {
+                            break;
+                        }
+                    }
+                    produced = reinterpret_cast<char*>(zs_.next_out) - data;
+                }
+
+                crc_ = crc32_z(crc_, reinterpret_cast<const Bytef*>(data), produced);
+                size_ += produced;
+                if (finished_ && (crc_ != expectedCrc_ || size_ != expectedSize_))
+                {
+                    return fail();
+                }
+                return produced;
+            }
+
+            qint64 writeData(const char*, qint64) override { return -1; }
+
+        private:
+            QIODevice* source_;
+            std::mutex& sourceMutex_;
+            qint64 sourcePos_;
+            qint64 compressedLeft_;
+            quint16 method_;
+            quint32 expectedCrc_;
+            qint64 expectedSize_;
+            z_stream zs_{};
+            QByteArray inBuf_;
+            quint32 crc_ = crc32(0, nullptr, 0);
+            qint64 size_ = 0;
+            bool finished_ = false;
+
+            bool fillInput()
+            {
+                inBuf_.resize(std::min(kInBufSize, compressedLeft_));
+                const auto got = readSource(inBuf_.data(), inBuf_.size());
+                if (got <= 0)
+                {
+                    return false;
+                }
+                sourcePos_ += got;
+                compressedLeft_ -= got;
+                zs_.next_in = reinterpret_cast<Bytef*>(inBuf_.data());
+                zs_.avail_in = got;
+                return true;
+            }
+
+            /**
+             * Read from where this file's data left off.
+             * @return Bytes read, or -1 on error.
+             */
+            qint64 readSource(char* data, qint64 maxSize)
+            {
+                const std::scoped_lock lock(sourceMutex_);
+                if (!source_->seek(sourcePos_))
+                {
+                    return -1;
+                }
+                return source_->read(data, maxSize);
+            }
+
+            qint64 fail()
+            {
+                setErrorString(QStringLiteral("Corrupt archive"));
+                finished_ = true;
+                return -1;
+            }
+        };
+    } // namespace
+
+    ZipReader::ZipReader(QIODevice* device) : device_(device)
+    {
+        // Find the end of central directory record, which may be followed by a comment.
+        const auto fileSize = device_->size();
+        if (fileSize < kEndOfCentralDirSize)
+        {
+            malformed();
+        }
+        const auto tailSize = std::min<qint64>(fileSize, kEndOfCentralDirSize + 0xFFFF);
+        const auto tail = readAt(device_, fileSize - tailSize, tailSize);
+        qsizetype eocd = tail.size() - kEndOfCentralDirSize;
+        while (eocd >= 0 && get32(tail, eocd) != kEndOfCentralDirSig)
+        {
+            --eocd;
+        }
+        if (eocd < 0)
+        {
+            malformed();
+        }
+        const auto entryCount = get16(tail, eocd + 10);
+        const auto dirSize = get32(tail, eocd + 12);
+        const auto dirOffset = get32(tail, eocd + 16);
+        if (dirOffset == 0xFFFFFFFF || entryCount == 0xFFFF)
+        {
+            // ZIP64
+            malformed();
+        }
+
+        const auto dir = readAt(device_, dirOffset, dirSize);
+        entries_.reserve(entryCount);
+        qsizetype pos = 0;
+        for (unsigned int ix = 0; ix < entryCount; ++ix)
+        {
+            if (get32(dir, pos) != kCentralHeaderSig)
+            {
+                malformed();
+            }
+            const auto flags = get16(dir, pos + 8);
+            const Entry entry{
+                .method = get16(dir, pos + 10),
+                .crc = get32(dir, pos + 16),
+                .compressedSize = get32(dir, pos + 20),
+                .size = get32(dir, pos + 24),
+                .headerOffset = get32(dir, pos + 42),
+            };
+            const auto nameSize = get16(dir, pos + 28);
+            const auto extraSize = get16(dir, pos + 30);
+            const auto commentSize = get16(dir, pos + 32);
+            if (pos + kCentralHeaderSize + nameSize > dir.size())
+            {
+                malformed();
+            }
+            const auto name = QString::fromUtf8(dir.constData() + pos + kCentralHeaderSize, nameSize);
+            pos += kCentralHeaderSize + nameSize + extraSize + commentSize;
+            if ((flags & kFlagEncrypted) || (entry.method != kMethodStore && entry.method != kMethodDeflate))
+            {
+                // Can't be read, so pretend it isn't there.
+                continue;
+            }
+            entries_.insert(name, entry);
+        }
+    }
+
+    std::unique_ptr<QIODevice> ZipReader::open(const QString& name) const
+    {
+        const auto it = entries_.constFind(name);
+        if (it == entries_.cend())
+        {
+            throw std::runtime_error("Missing file in archive");
+        }
+        const auto& entry = it.value();
+
+        // The local header's name and extra field may differ in size from the central directory's.
+        QByteArray header;
+        {
+            const std::scoped_lock lock(deviceMutex_);
+            header = readAt(device_, entry.headerOffset, kLocalHeaderSize);
+        }
+        if (get32(header, 0) != kLocalHeaderSig)
+        {
+            malformed();
+        }
+        const auto dataOffset = entry.headerOffset + kLocalHeaderSize + get16(header, 26) + get16(header, 28);
+        return std::make_unique<EntryDevice>(device_, deviceMutex_, dataOffset, entry.method, entry.crc,
+                                             entry.compressedSize, entry.size);
+    }
+
+    QByteArray ZipReader::read(const QString& name) const
+    {
+        const auto f = open(name);
+        QByteArray data(entries_.value(name).size, Qt::Uninitialized);
+        for (qint64 got = 0; got < data.size();)
+        {
+            const auto count = f->read(data.data() + got, data.size() - got);
+            if (count <= 0)
+            {
+                malformed();
+            }
+            got += count;
+        }
+        // Reading past the end checks the data is complete and intact.
+        char extra;
+        if (f->read(&extra, 1) != 0)
+        {
+            malformed();
+        }
+        return data;
+    }
+} // namespace echoconfig
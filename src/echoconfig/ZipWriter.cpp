@@ -0,0 +1,527 @@
+/**
+ * @file ZipWriter.cpp
+ *
+ * @author Dan Keenan
+ * @date 10/17/2026
+ * @copyright GNU GPLv3
+ */
+
+#include "echoconfig/ZipWriter.h"
+#include <QDateTime>
+#include <QIODevice>
+#include <QThreadPool>
+#include <QtEndian>
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <future>
+#include <limits>
+#include <stdexcept>
+#include <zlib.h>
+#include "echoconfig/thread_helpers.h"
+
+namespace echoconfig
+{
+    namespace
+    {
+        constexpr quint32 kLocalHeaderSig = 0x04034b50;
+        constexpr quint32 kDataDescriptorSig = 0x08074b50;
+        constexpr quint32 kCentralHeaderSig = 0x02014b50;
+        constexpr quint32 kEndOfCentralDirSig = 0x06054b50;
+        /** 2.0, the first version with deflate. */
+        constexpr quint16 kVersion = 20;
+        /** Sizes and CRC follow the data; names are UTF-8. */
+        constexpr quint16 kFlags = 0x0008 | 0x0800;
+        constexpr quint16 kMethodStore = 0;
+        constexpr quint16 kMethodDeflate = 8;
+        constexpr std::size_t kOutBufSize = 64 * 1024;
+        /** Size of the blocks compressed in parallel.  The same as pigz. */
+        constexpr qsizetype kBlockSize = 128 * 1024;
+        /** Deflate can refer back this far, so this much of the previous block primes the next. */
+        constexpr qsizetype kDictSize = 32 * 1024;
+
+        void put16(QByteArray& out, quint16 val)
+        {
+            const auto le = qToLittleEndian(val);
+            out.append(reinterpret_cast<const char*>(&le), sizeof(le));
+        }
+
+        void put32(QByteArray& out, quint32 val)
+        {
+            const auto le = qToLittleEndian(val);
+            out.append(reinterpret_cast<const char*>(&le), sizeof(le));
+        }
+
+        quint32 checked32(qint64 val)
+        {
+            if (val > std::numeric_limits<quint32>::max())
+            {
+                throw std::runtime_error("Archive too large");
+            }
+            return static_cast<quint32>(val);
+        }
+
+        int zlibLevel(CompressionLevel level)
+        {
+            return level == CompressionLevel::Fast ? Z_BEST_SPEED : Z_DEFAULT_COMPRESSION;
+        }
+
+        void initDeflater(z_stream* zs, int level)
+        {
+            if (deflateInit2(zs, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+            {
+                throw std::runtime_error("Failed to initialize compression");
+            }
+        }
+
+        /**
+         * Compress @p data with @p zs, using @p outBuf for output.  @p drain is called with each chunk of output.
+         */
+        template <typename Drain>
+        void deflateInto(z_stream* zs, QByteArray& outBuf, QByteArrayView data, int flush, Drain&& drain)
+        {
+            auto* in = reinterpret_cast<const Bytef*>(data.data());
+            auto remaining = data.size();
+            do
+            {
+                // avail_in is only 32 bits.
+                const auto chunk = std::min<qsizetype>(remaining, std::numeric_limits<uInt>::max());
+                zs->next_in = const_cast<Bytef*>(in);
+                zs->avail_in = chunk;
+                const auto chunkFlush = chunk == remaining ? flush : Z_NO_FLUSH;
+                do
+                {
+                    zs->next_out = reinterpret_cast<Bytef*>(outBuf.data());
+                    zs->avail_out = outBuf.size();
+                    if (deflate(zs, chunkFlush) == Z_STREAM_ERROR)
+                    {
+                        throw std::runtime_error("Failed to compress data");
+                    }
+                    drain(QByteArrayView(outBuf.constData(), outBuf.size() - zs->avail_out));
+                } while (zs->avail_out == 0);
+                in += chunk;
+                remaining -= chunk;
+            } while (remaining > 0);
+        }
+
+        struct CompressedBlock
+        {
+            QByteArray data;
+            quint32 crc;
+            qsizetype size;
+        };
+
+        /**
+         * Compress one block of a file independently of the others.
+         *
+         * Blocks other than the last end on a byte boundary without ending the stream, so the compressed blocks can
+         * be joined into one deflate stream.
+         *
+         * @param block
+         * @param prevBlock The block before, if any, to prime the compressor with.
+         * @param level zlib compression level.
+         * @param last If this is the last block of the file.
+         */
+        CompressedBlock compressBlock(const QByteArray& block, const QByteArray& prevBlock, int level, bool last)
+        {
+            // Setting up a deflate stream costs about as much as compressing a block, so each thread keeps one.
+            struct ThreadDeflater
+            {
+                z_stream zs{};
+                int level = 0;
+                bool initialized = false;
+                QByteArray outBuf;
+
+                ~ThreadDeflater()
+                {
+                    if (initialized)
+                    {
+                        deflateEnd(&zs);
+                    }
+                }
+            };
+            thread_local ThreadDeflater deflater;
+            if (deflater.initialized && deflater.level != level)
+            {
+                deflateEnd(&deflater.zs);
+                deflater.initialized = false;
+            }
+            if (deflater.initialized)
+            {
+                deflateReset(&deflater.zs);
+            }
+            else
+            {
+                deflater.zs = {};
+                initDeflater(&deflater.zs, level);
+                deflater.level = level;
+                deflater.initialized = true;
+                deflater.outBuf.resize(kOutBufSize);
+            }
+
+            if (!prevBlock.isEmpty())
+            {
+                const auto dictSize = std::min(prevBlock.size(), kDictSize);
+                const auto* dict = prevBlock.constData() + prevBlock.size() - dictSize;
+                deflateSetDictionary(&deflater.zs, reinterpret_cast<const Bytef*>(dict), dictSize);
+            }
+            CompressedBlock compressed;
+            compressed.crc =
+                crc32_z(crc32(0, nullptr, 0), reinterpret_cast<const Bytef*>(block.constData()), block.size());
+            compressed.size = block.size();
+            compressed.data.reserve(deflateBound(&deflater.zs, block.size()) + 16);
+            deflateInto(&deflater.zs, deflater.outBuf, block, last ? Z_FINISH : Z_SYNC_FLUSH,
+                        [&compressed](QByteArrayView out) { compressed.data.append(out); });
+            return compressed;
+        }
+    } // namespace
+
+    /**
+     * Compresses files one at a time according to the ZipOptions.
+     */
+    class ZipWriter::Deflater
+    {
+    public:
+        using Sink = std::function<void(QByteArrayView)>;
+
+        explicit Deflater(const ZipOptions& options) : options_(options)
+        {
+            if (options_.level == CompressionLevel::Store)
+            {
+                return;
+            }
+            if (options_.parallel)
+            {
+                // Enough to keep the pool busy while this thread waits for the oldest block.
+                maxPending_ = std::max(2, 2 * QThreadPool::globalInstance()->maxThreadCount());
+                block_.reserve(kBlockSize);
+            }
+            else
+            {
+                zs_ = std::make_unique<z_stream>();
+                initDeflater(zs_.get(), zlibLevel(options_.level));
+                outBuf_.resize(kOutBufSize);
+            }
+        }
+
+        ~Deflater()
+        {
+            if (zs_)
+            {
+                deflateEnd(zs_.get());
+            }
+        }
+
+        Deflater(const Deflater&) = delete;
+        Deflater& operator=(const Deflater&) = delete;
+
+        [[nodiscard]] quint16 method() const
+        {
+            return options_.level == CompressionLevel::Store ? kMethodStore : kMethodDeflate;
+        }
+
+        /**
+         * Compress @p data, passing output to @p sink.
+         */
+        void write(QByteArrayView data, const Sink& sink)
+        {
+            if (maxPending_ > 0)
+            {
+                while (!data.isEmpty())
+                {
+                    const auto take = std::min(kBlockSize - block_.size(), data.size());
+                    block_.append(data.first(take));
+                    data = data.sliced(take);
+                    if (block_.size() == kBlockSize)
+                    {
+                        submitBlock(false, sink);
+                    }
+                }
+                return;
+            }
+
+            addChecksum(data);
+            if (zs_)
+            {
+                deflateInto(zs_.get(), outBuf_, data, Z_NO_FLUSH, sink);
+            }
+            else
+            {
+                sink(data);
+            }
+        }
+
+        /**
+         * End the file, passing the remaining output to @p sink, and fill in @p entry's method, CRC, and size.
+         *
+         * The deflater is then ready for the next file.
+         */
+        void finish(const Sink& sink, Entry& entry)
+        {
+            if (maxPending_ > 0)
+            {
+                submitBlock(true, sink);
+                prevBlock_ = QByteArray();
+            }
+            else if (zs_)
+            {
+                deflateInto(zs_.get(), outBuf_, {}, Z_FINISH, sink);
+                deflateReset(zs_.get());
+            }
+
+            entry.method = method();
+            entry.crc = crc_;
+            entry.size = size_;
+            crc_ = crc32(0, nullptr, 0);
+            size_ = 0;
+        }
+
+    private:
+        ZipOptions options_;
+        /** For compressing on this thread. */
+        std::unique_ptr<z_stream> zs_;
+        QByteArray outBuf_;
+        /** For compressing on the thread pool. */
+        QByteArray block_;
+        QByteArray prevBlock_;
+        std::deque<std::future<CompressedBlock>> pending_;
+        /** 0 unless compressing on the thread pool. */
+        std::size_t maxPending_ = 0;
+        quint32 crc_ = crc32(0, nullptr, 0);
+        qint64 size_ = 0;
+
+        void addChecksum(QByteArrayView data)
+        {
+            crc_ = crc32_z(crc_, reinterpret_cast<const Bytef*>(data.data()), data.size());
+            size_ += data.size();
+        }
+
+        /**
+         * Start compressing block_, then write out finished blocks, in order, until few enough are outstanding.
+         */
+        void submitBlock(bool last, const Sink& sink)
+        {
+            pending_.push_back(thread_helpers::runAsync(
+                [block = block_, prevBlock = prevBlock_, level = zlibLevel(options_.level), last]()
+                { return compressBlock(block, prevBlock, level, last); }));
+            // The tasks share the data, so start a new array rather than reusing this one.
+            prevBlock_ = std::move(block_);
+            block_ = QByteArray();
+            block_.reserve(kBlockSize);
+
+            while (!pending_.empty() && (last || pending_.size() > maxPending_))
+            {
+                const auto compressed = pending_.front().get();
+                pending_.pop_front();
+                crc_ = crc32_combine(crc_, compressed.crc, compressed.size);
+                size_ += compressed.size;
+                sink(compressed.data);
+            }
+        }
+    };
+
+    ZipWriter::Compressor::Compressor(const ZipOptions& options) : deflater_(std::make_unique<Deflater>(options)) {}
+
+    ZipWriter::Compressor::~Compressor() = default;
+
+    void ZipWriter::Compressor::write(QByteArrayView data)
+    {
+        if (finished_)
+        {
+            throw std::runtime_error("File already finished");
+        }
+        deflater_->write(data, [this](QByteArrayView out) { compressed_.append(out); });
+    }
+
+    void ZipWriter::Compressor::finish()
+    {
+        if (finished_)
+        {
+            return;
+        }
+        deflater_->finish([this](QByteArrayView out) { compressed_.append(out); }, entry_);
+        finished_ = true;
+        // Only the output is needed from here on.
+        deflater_.reset();
+    }
+
+    ZipWriter::ZipWriter(QIODevice* device, const ZipOptions& options) :
+        device_(device), options_(options), deflater_(std::make_unique<Deflater>(options))
+    {
+        const auto now = QDateTime::currentDateTime();
+        const auto date = now.date();
+        const auto time = now.time();
+        dosTime_ = (time.hour() << 11) | (time.minute() << 5) | (time.second() / 2);
+        dosDate_ = ((std::max(date.year(), 1980) - 1980) << 9) | (date.month() << 5) | date.day();
+    }
+
+    ZipWriter::~ZipWriter() = default;
+
+    void ZipWriter::beginFile(const QString& name)
+    {
+        if (finished_)
+        {
+            throw std::runtime_error("Archive already finished");
+        }
+        endFile();
+
+        current_.emplace();
+        current_->name = name.toUtf8();
+        current_->method = deflater_->method();
+        current_->offset = offset_;
+        writeLocalHeader(*current_);
+    }
+
+    void ZipWriter::write(QByteArrayView data)
+    {
+        if (!current_.has_value())
+        {
+            throw std::runtime_error("No file to write to");
+        }
+        deflater_->write(data,
+                         [this](QByteArrayView out)
+                         {
+                             current_->compressedSize += out.size();
+                             writeRaw(out);
+                         });
+    }
+
+    void ZipWriter::endFile()
+    {
+        if (!current_.has_value())
+        {
+            return;
+        }
+        deflater_->finish(
+            [this](QByteArrayView out)
+            {
+                current_->compressedSize += out.size();
+                writeRaw(out);
+            },
+            *current_);
+        writeDescriptor(*current_);
+
+        entries_.push_back(std::move(*current_));
+        current_.reset();
+    }
+
+    void ZipWriter::addFile(const QString& name, QByteArrayView data)
+    {
+        beginFile(name);
+        write(data);
+        endFile();
+    }
+
+    void ZipWriter::addCompressed(const QString& name, const Compressor& compressor)
+    {
+        if (finished_)
+        {
+            throw std::runtime_error("Archive already finished");
+        }
+        if (!compressor.isFinished())
+        {
+            throw std::runtime_error("File not finished");
+        }
+        endFile();
+
+        auto entry = compressor.entry_;
+        entry.name = name.toUtf8();
+        entry.compressedSize = compressor.compressed_.size();
+        entry.offset = offset_;
+        writeLocalHeader(entry);
+        writeRaw(compressor.compressed_);
+        writeDescriptor(entry);
+        entries_.push_back(std::move(entry));
+    }
+
+    void ZipWriter::finish()
+    {
+        if (finished_)
+        {
+            return;
+        }
+        endFile();
+
+        const auto dirOffset = offset_;
+        QByteArray dir;
+        for (const auto& entry : entries_)
+        {
+            put32(dir, kCentralHeaderSig);
+            put16(dir, kVersion);
+            put16(dir, kVersion);
+            put16(dir, kFlags);
+            put16(dir, entry.method);
+            put16(dir, dosTime_);
+            put16(dir, dosDate_);
+            put32(dir, entry.crc);
+            put32(dir, checked32(entry.compressedSize));
+            put32(dir, checked32(entry.size));
+            put16(dir, entry.name.size());
+            // Extra field, comment, disk number, internal and external attributes.
+            put16(dir, 0);
+            put16(dir, 0);
+            put16(dir, 0);
+            put16(dir, 0);
+            put32(dir, 0);
+            put32(dir, checked32(entry.offset));
+            dir.append(entry.name);
+        }
+        if (entries_.size() > std::numeric_limits<quint16>::max())
+        {
+            throw std::runtime_error("Archive too large");
+        }
+        const auto dirSize = dir.size();
+        put32(dir, kEndOfCentralDirSig);
+        put16(dir, 0);
+        put16(dir, 0);
+        put16(dir, entries_.size());
+        put16(dir, entries_.size());
+        put32(dir, checked32(dirSize));
+        put32(dir, checked32(dirOffset));
+        put16(dir, 0);
+        writeRaw(dir);
+        finished_ = true;
+    }
+
+    void ZipWriter::writeLocalHeader(const Entry& entry)
+    {
+        QByteArray header;
+        put32(header, kLocalHeaderSig);
+        put16(header, kVersion);
+        put16(header, kFlags);
+        put16(header, entry.method);
+        put16(header, dosTime_);
+        put16(header, dosDate_);
+        // CRC and sizes are in the data descriptor.
+        put32(header, 0);
+        put32(header, 0);
+        put32(header, 0);
+        put16(header, entry.name.size());
+        put16(header, 0);
+        header.append(entry.name);
+        writeRaw(header);
+    }
+
+    void ZipWriter::writeDescriptor(const Entry& entry)
+    {
+        QByteArray descriptor;
+        put32(descriptor, kDataDescriptorSig);
+        put32(descriptor, entry.crc);
+        put32(descriptor, checked32(entry.compressedSize));
+        put32(descriptor, checked32(entry.size));
+        writeRaw(descriptor);
+    }
+
+    void ZipWriter::writeRaw(QByteArrayView data)
+    {
+        if (data.isEmpty())
+        {
+            return;
+        }
+        if (device_->write(data.data(), data.size()) != data.size())
+        {
+            throw std::runtime_error("Failed to write archive");
+        }
+        offset_ += data.size();
+    }
+} // namespace echoconfig
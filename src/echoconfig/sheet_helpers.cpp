@@ -7,22 +7,88 @@
  */
 
 #include "echoconfig/sheet_helpers.h"
+#include <QLocale>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
 
 namespace echoconfig::sheet_helpers
 {
-    unsigned int requiredCellUInt(const QXlsx::Document* doc, int row, int col)
+    namespace
     {
-        bool isInt;
-        auto val = doc->read(row, col);
-        if (!val.isValid() || val.toString().isEmpty())
+        /** More digits than this might not fit exactly in a double. */
+        constexpr qsizetype kMaxFastDigits = 15;
+
+        char16_t codeOf(QChar c) { return c.unicode(); }
+
+        char16_t codeOf(char c) { return static_cast<unsigned char>(c); }
+
+        template <typename Text>
+        std::optional<double> parseDigitsOf(Text text)
+        {
+            if (text.isEmpty() || text.size() > kMaxFastDigits)
+            {
+                return std::nullopt;
+            }
+            quint64 intVal = 0;
+            for (const auto c : text)
+            {
+                const auto code = codeOf(c);
+                if (code < u'0' || code > u'9')
+                {
+                    return std::nullopt;
+                }
+                intVal = intVal * 10 + (code - u'0');
+            }
+            return static_cast<double>(intVal);
+        }
+    } // namespace
+
+    QString cellText(const SheetCell* cell)
+    {
+        if (cell == nullptr)
+        {
+            return {};
+        }
+        switch (cell->type)
+        {
+        case SheetCell::Type::Number:
+            return QString::number(cell->number, 'g', QLocale::FloatingPointShortest);
+        case SheetCell::Type::Boolean:
+            return cell->number != 0 ? QStringLiteral("true") : QStringLiteral("false");
+        case SheetCell::Type::String:
+        case SheetCell::Type::Error:
+            return cell->text;
+        }
+        return {};
+    }
+
+    unsigned int requiredCellUInt(const SheetCell* cell)
+    {
+        if (cell == nullptr || (cell->type == SheetCell::Type::String && cell->text.isEmpty()))
         {
             throw std::runtime_error("Missing required value");
         }
-        const auto intVal = val.toUInt(&isInt);
+        if (cell->type == SheetCell::Type::Number)
+        {
+            if (cell->number < 0 || cell->number > std::numeric_limits<unsigned int>::max() ||
+                std::trunc(cell->number) != cell->number)
+            {
+                throw std::runtime_error("Non-numeric value");
+            }
+            return static_cast<unsigned int>(cell->number);
+        }
+
+        bool isInt = false;
+        const auto intVal = cell->type == SheetCell::Type::String ? cell->text.toUInt(&isInt) : 0;
         if (!isInt)
         {
             throw std::runtime_error("Non-numeric value");
         }
         return intVal;
     }
+
+    std::optional<double> parseDigits(QStringView text) { return parseDigitsOf(text); }
+
+    std::optional<double> parseDigits(QByteArrayView text) { return parseDigitsOf(text); }
 } // namespace echoconfig::sheet_helpers
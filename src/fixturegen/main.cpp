@@ -0,0 +1,119 @@
+/**
+ * @file main.cpp
+ *
+ * @author Dan Keenan
+ * @date 10/17/2026
+ * @copyright GNU GPLv3
+ */
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QTextStream>
+#include <exception>
+#include "echoblind_config.h"
+#include "echoconfig/FixtureGenerator.h"
+
+using echoconfig::FixtureGenerator;
+
+namespace
+{
+    /**
+     * Read a numeric option, reporting bad values.
+     */
+    bool readUInt(const QCommandLineParser& parser, const QString& name, unsigned int& out)
+    {
+        if (!parser.isSet(name))
+        {
+            return true;
+        }
+        bool ok = false;
+        const auto value = parser.value(name).toUInt(&ok);
+        if (!ok)
+        {
+            QTextStream(stderr) << "Invalid value for --" << name << ": " << parser.value(name) << "\n";
+            return false;
+        }
+        out = value;
+        return true;
+    }
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setOrganizationName(echoblind::config::kProjectOrganizationName);
+    app.setOrganizationDomain(echoblind::config::kProjectOrganizationDomain);
+    app.setApplicationName(QStringLiteral("echoconfig_fixturegen"));
+    app.setApplicationVersion(echoblind::config::kProjectVersion);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Generate synthetic Echo config files for stress testing."));
+    parser.addHelpOption();
+    parser.addVersionOption();
+    const FixtureGenerator::Options defaults;
+    parser.addOptions({
+        {QStringLiteral("type"), QStringLiteral("Config type: pcp or acp."), QStringLiteral("type"),
+         QStringLiteral("pcp")},
+        {QStringLiteral("circuits"), QStringLiteral("Number of circuits."), QStringLiteral("count"),
+         QString::number(defaults.circuitCount)},
+        {QStringLiteral("spaces"), QStringLiteral("Number of spaces."), QStringLiteral("count"),
+         QString::number(defaults.spaceCount)},
+        {QStringLiteral("presets"), QStringLiteral("Number of presets."), QStringLiteral("count"),
+         QString::number(defaults.presetCount)},
+        {QStringLiteral("sequences"), QStringLiteral("Number of sequences."), QStringLiteral("count"),
+         QString::number(defaults.sequenceCount)},
+        {QStringLiteral("seed"), QStringLiteral("Random seed."), QStringLiteral("seed"),
+         QString::number(defaults.seed)},
+        {QStringLiteral("sheet"), QStringLiteral("Also write a matching spreadsheet to <path>."),
+         QStringLiteral("path")},
+    });
+    parser.addPositionalArgument(QStringLiteral("output"), QStringLiteral("Config file to write."));
+    parser.process(app);
+
+    const auto positional = parser.positionalArguments();
+    if (positional.size() != 1)
+    {
+        parser.showHelp(1);
+    }
+
+    FixtureGenerator::Options options;
+    const auto type = parser.value(QStringLiteral("type")).toLower();
+    if (type == QStringLiteral("pcp"))
+    {
+        options.dialect = FixtureGenerator::Dialect::Pcp;
+    }
+    else if (type == QStringLiteral("acp"))
+    {
+        options.dialect = FixtureGenerator::Dialect::Acp;
+    }
+    else
+    {
+        QTextStream(stderr) << "Unknown config type: " << type << "\n";
+        return 1;
+    }
+    if (!readUInt(parser, QStringLiteral("circuits"), options.circuitCount) ||
+        !readUInt(parser, QStringLiteral("spaces"), options.spaceCount) ||
+        !readUInt(parser, QStringLiteral("presets"), options.presetCount) ||
+        !readUInt(parser, QStringLiteral("sequences"), options.sequenceCount) ||
+        !readUInt(parser, QStringLiteral("seed"), options.seed))
+    {
+        return 1;
+    }
+
+    try
+    {
+        const FixtureGenerator generator(options);
+        generator.saveCfg(positional.front());
+        if (parser.isSet(QStringLiteral("sheet")))
+        {
+            generator.saveSheet(parser.value(QStringLiteral("sheet")));
+        }
+    }
+    catch (const std::exception& e)
+    {
+        QTextStream(stderr) << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
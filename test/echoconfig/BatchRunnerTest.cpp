@@ -0,0 +1,138 @@
+/**
+ * @file BatchRunnerTest.cpp
+ *
+ * @author Dan Keenan
+ * @date 10/17/2026
+ * @copyright GNU GPLv3
+ */
+
+#include <QFile>
+#include <QTemporaryDir>
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <vector>
+#include "echoconfig/BatchRunner.h"
+#include "file_helpers.h"
+#include "qstring_tostring.h"
+
+using namespace echoconfig;
+
+namespace
+{
+    struct Fixture
+    {
+        QString cfg;
+        QString changedSheet;
+        QString changedCfg;
+    };
+
+    const std::vector<Fixture> kFixtures{
+        {
+            .cfg = RESOURCES_PATH "/EchoPcpConfigTest/ERP.cfg",
+            .changedSheet = RESOURCES_PATH "/EchoPcpConfigTest/ERP_changed.xlsx",
+            .changedCfg = RESOURCES_PATH "/EchoPcpConfigTest/ERP_changed.cfg",
+        },
+        {
+            .cfg = RESOURCES_PATH "/EchoAcpConfigTest/EACP.eacp",
+            .changedSheet = RESOURCES_PATH "/EchoAcpConfigTest/EACP_changed.xlsx",
+            .changedCfg = RESOURCES_PATH "/EchoAcpConfigTest/EACP_changed.eacp",
+        },
+    };
+} // namespace
+
+TEST_CASE("Batch Runner")
+{
+    const auto threadCount = GENERATE(1u, 2u, 8u);
+    CAPTURE(threadCount);
+    QTemporaryDir testDir;
+
+    // Enough copies of each job that workers run out at different times.
+    constexpr auto kCopies = 4;
+    std::vector<BatchRunner::Job> jobs;
+    for (int copy = 0; copy < kCopies; ++copy)
+    {
+        for (std::size_t ix = 0; ix < kFixtures.size(); ++ix)
+        {
+            const auto& fixture = kFixtures[ix];
+            const auto name = QStringLiteral("%1_%2").arg(ix).arg(copy);
+            jobs.push_back({
+                .operation = BatchRunner::Operation::ExportSheet,
+                .cfgPath = fixture.cfg,
+                .sheetPath = testDir.filePath(name + QStringLiteral(".xlsx")),
+            });
+            jobs.push_back({
+                .operation = BatchRunner::Operation::ImportSheet,
+                .cfgPath = fixture.cfg,
+                .sheetPath = fixture.changedSheet,
+                .outPath = testDir.filePath(name + QStringLiteral(".cfg")),
+            });
+        }
+    }
+    // One bad job in the middle.
+    const auto badIx = jobs.size() / 2;
+    jobs.insert(jobs.begin() + static_cast<std::ptrdiff_t>(badIx),
+                BatchRunner::Job{
+                    .operation = BatchRunner::Operation::ExportSheet,
+                    .cfgPath = testDir.filePath("does_not_exist.cfg"),
+                    .sheetPath = testDir.filePath("does_not_exist.xlsx"),
+                });
+
+    std::atomic<std::size_t> finished = 0;
+    const BatchRunner runner({
+        .threadCount = threadCount,
+        .onJobFinished = [&finished](std::size_t, const BatchRunner::JobResult&) { ++finished; },
+    });
+    const auto report = runner.run(jobs);
+
+    CHECK(report.threadCount == threadCount);
+    CHECK(finished == jobs.size());
+    REQUIRE(report.results.size() == jobs.size());
+    CHECK(report.failedCount() == 1);
+    CHECK(report.wallTime.count() > 0);
+    if (threadCount == 1)
+    {
+        CHECK(report.steals == 0);
+    }
+
+    for (std::size_t ix = 0; ix < jobs.size(); ++ix)
+    {
+        const auto& job = jobs[ix];
+        const auto& result = report.results[ix];
+        CAPTURE(ix, job.cfgPath);
+        CHECK(result.worker < report.threadCount);
+        CHECK(result.timings.total >= result.timings.parseCfg);
+        if (ix == badIx)
+        {
+            CHECK_FALSE(result.ok);
+            CHECK(result.error == QStringLiteral("Failed to read config file"));
+            CHECK_FALSE(QFile::exists(job.sheetPath));
+            continue;
+        }
+
+        REQUIRE(result.ok);
+        CHECK(result.error.isEmpty());
+        if (job.operation == BatchRunner::Operation::ExportSheet)
+        {
+            CHECK(result.timings.saveSheet.count() > 0);
+            CHECK(QFile::exists(job.sheetPath));
+        }
+        else
+        {
+            CHECK(result.timings.parseSheet.count() > 0);
+            CHECK(result.timings.saveCfg.count() > 0);
+            // Same as saving the config by itself.
+            const auto& fixture = job.cfgPath == kFixtures[0].cfg ? kFixtures[0] : kFixtures[1];
+            CHECK(readFile(job.outPath) == readFile(fixture.changedCfg));
+        }
+    }
+}
+
+TEST_CASE("Batch Runner Empty")
+{
+    const BatchRunner runner;
+    const auto report = runner.run({});
+    CHECK(report.results.empty());
+    CHECK(report.threadCount == 1);
+    CHECK(report.failedCount() == 0);
+}
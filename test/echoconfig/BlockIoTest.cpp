@@ -0,0 +1,126 @@
+/**
+ * @file BlockIoTest.cpp
+ *
+ * @author Dan Keenan
+ * @date 10/17/2026
+ * @copyright GNU GPLv3
+ */
+
+#include <QBuffer>
+#include <QFile>
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <stdexcept>
+#include "echoconfig/BlockIo.h"
+#include "qbytearray_tostring.h"
+
+using namespace echoconfig;
+
+namespace
+{
+    QByteArray testData(qsizetype size)
+    {
+        QByteArray data(size, Qt::Uninitialized);
+        for (qsizetype ix = 0; ix < size; ++ix)
+        {
+            data[ix] = static_cast<char>('a' + ix % 26);
+        }
+        return data;
+    }
+} // namespace
+
+TEST_CASE("Read Ahead")
+{
+    // Sizes on, around, and between block boundaries.
+    const auto size = GENERATE(qsizetype{0}, qsizetype{1}, qsizetype{4096}, qsizetype{4097}, qsizetype{50000});
+    CAPTURE(size);
+    auto data = testData(size);
+    QBuffer in(&data);
+    REQUIRE(in.open(QIODevice::ReadOnly));
+
+    ReadAhead readAhead(in, {.blockSize = 4096, .maxBlocks = 2});
+    QByteArray read;
+    for (auto block = readAhead.next(); !block.isEmpty(); block = readAhead.next())
+    {
+        CHECK(block.size() <= 4096);
+        read += block;
+    }
+    CHECK(read == data);
+    // Stays at the end.
+    CHECK(readAhead.next().isEmpty());
+
+    const auto stats = readAhead.stats();
+    CHECK(stats.bytes == size);
+    CHECK(stats.waited <= stats.elapsed);
+    CHECK(stats.waitFraction() >= 0.0);
+    CHECK(stats.waitFraction() <= 1.0);
+}
+
+TEST_CASE("Read Ahead stopped early")
+{
+    auto data = testData(50000);
+    QBuffer in(&data);
+    REQUIRE(in.open(QIODevice::ReadOnly));
+    // Destroyed while the reading thread is waiting for room.
+    ReadAhead readAhead(in, {.blockSize = 1024, .maxBlocks = 1});
+    CHECK(readAhead.next() == data.first(1024));
+}
+
+TEST_CASE("Read Ahead error")
+{
+    QFile in;
+    // Not open, so reading fails.
+    ReadAhead readAhead(in);
+    CHECK_THROWS_AS(readAhead.next(), std::runtime_error);
+}
+
+TEST_CASE("Write Behind")
+{
+    const auto size = GENERATE(qsizetype{0}, qsizetype{1}, qsizetype{4096}, qsizetype{50000});
+    CAPTURE(size);
+    const auto data = testData(size);
+    QByteArray written;
+    QBuffer out(&written);
+    REQUIRE(out.open(QIODevice::WriteOnly));
+
+    WriteBehind writer(out, {.blockSize = 4096});
+    SECTION("Small writes")
+    {
+        for (qsizetype pos = 0; pos < size; pos += 100)
+        {
+            writer.write(data.constData() + pos, std::min<qsizetype>(100, size - pos));
+        }
+    }
+    SECTION("Whole blocks")
+    {
+        writer.write(data);
+    }
+    writer.finish();
+    CHECK(written == data);
+
+    const auto stats = writer.stats();
+    CHECK(stats.bytes == size);
+    CHECK(stats.waited <= stats.elapsed);
+    CHECK(stats.waitFraction() <= 1.0);
+}
+
+TEST_CASE("Write Behind error")
+{
+    QByteArray written;
+    QBuffer out(&written);
+    // Read only, so writing fails.
+    REQUIRE(out.open(QIODevice::ReadOnly));
+
+    WriteBehind writer(out, {.blockSize = 16});
+    const auto data = testData(64);
+    // Fails on whichever write notices first.
+    CHECK_THROWS_AS(
+        [&]()
+        {
+            writer.write(data.constData(), 32);
+            writer.write(data.constData() + 32, 32);
+            writer.finish();
+        }(),
+        std::runtime_error);
+}
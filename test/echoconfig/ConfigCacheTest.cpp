@@ -0,0 +1,159 @@
+/**
+ * @file ConfigCacheTest.cpp
+ *
+ * @author Dan Keenan
+ * @date 10/17/2026
+ * @copyright GNU GPLv3
+ */
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <catch2/matchers/catch_matchers_range_equals.hpp>
+#include "echoconfig/ConfigCache.h"
+#include "echoconfig/EchoPcpConfig.h"
+#include "file_helpers.h"
+#include "qbytearray_tostring.h"
+#include "qstring_tostring.h"
+
+using namespace echoconfig;
+using Catch::Matchers::RangeEquals;
+
+namespace
+{
+    QStringList cacheEntries(const ConfigCache& cache)
+    {
+        return QDir(cache.dir()).entryList({QStringLiteral("*.snapshot")}, QDir::Files);
+    }
+} // namespace
+
+TEST_CASE("Config Cache")
+{
+    const QString sourcePath = GENERATE(RESOURCES_PATH "/EchoPcpConfigTest/ERP.cfg",
+                                        RESOURCES_PATH "/EchoAcpConfigTest/EACP.eacp");
+    CAPTURE(sourcePath);
+    QTemporaryDir testDir;
+    ConfigCache cache(testDir.filePath("cache"));
+    const ParseOptions options{.cache = &cache};
+
+    const auto parsed = Config::loadCfg(sourcePath, options);
+    REQUIRE(parsed != nullptr);
+    CHECK(cache.stats().hits == 0);
+    CHECK(cache.stats().misses == 1);
+    REQUIRE(cacheEntries(cache).size() == 1);
+
+    SECTION("Hit")
+    {
+        const auto cached = Config::loadCfg(sourcePath, options);
+        REQUIRE(cached != nullptr);
+        CHECK(cache.stats().hits == 1);
+        CHECK(cache.stats().misses == 1);
+        CHECK(cached->parseOptions().cache == &cache);
+        CHECK(cached->panelType() == parsed->panelType());
+        CHECK(cached->panelName() == parsed->panelName());
+        CHECK_THAT(cached->circuits(), RangeEquals(parsed->circuits()));
+        CHECK_THAT(cached->spaces(), RangeEquals(parsed->spaces()));
+        CHECK_THAT(cached->presets(), RangeEquals(parsed->presets()));
+
+        // Entries are keyed by content, not path.
+        const auto copyPath = testDir.filePath("copy.cfg");
+        writeFile(copyPath, readFile(sourcePath));
+        REQUIRE(Config::loadCfg(copyPath, options) != nullptr);
+        CHECK(cache.stats().hits == 2);
+        CHECK(cacheEntries(cache).size() == 1);
+    }
+
+    SECTION("Hit keeps the base")
+    {
+        const auto basePath = testDir.filePath(QFileInfo(sourcePath).fileName());
+        const auto source = readFile(sourcePath);
+        writeFile(basePath, source);
+        const auto cached = Config::loadCfg(basePath, {.retainBase = true, .cache = &cache});
+        REQUIRE(cached != nullptr);
+        CHECK(cache.stats().hits == 1);
+
+        // Overwrite the base without changing its size or time, so only the retained contents can be saved from.
+        QFile fBase(basePath);
+        REQUIRE(fBase.open(QIODevice::ReadWrite));
+        const auto modified = fBase.fileTime(QFileDevice::FileModificationTime);
+        fBase.write(QByteArray(source.size(), ' '));
+        fBase.flush();
+        REQUIRE(fBase.setFileTime(modified, QFileDevice::FileModificationTime));
+        fBase.close();
+
+        const auto expectedPath = testDir.filePath("expected");
+        REQUIRE_NOTHROW(parsed->saveCfg(sourcePath, expectedPath));
+        const auto actualPath = testDir.filePath("actual");
+        REQUIRE_NOTHROW(cached->saveCfg(basePath, actualPath));
+        CHECK(readFile(actualPath) == readFile(expectedPath));
+    }
+
+    SECTION("Changed file")
+    {
+        // Same config, different bytes.
+        const auto changedPath = testDir.filePath("changed.cfg");
+        writeFile(changedPath, readFile(sourcePath) + '\n');
+
+        const auto changed = Config::loadCfg(changedPath, options);
+        REQUIRE(changed != nullptr);
+        CHECK(cache.stats().hits == 0);
+        CHECK(cache.stats().misses == 2);
+        CHECK_THAT(changed->presets(), RangeEquals(parsed->presets()));
+        CHECK(cacheEntries(cache).size() == 2);
+    }
+
+    SECTION("Damaged entry")
+    {
+        const auto entryPath = QDir(cache.dir()).filePath(cacheEntries(cache).front());
+        auto entry = readFile(entryPath);
+        entry[entry.size() - 1] = static_cast<char>(~entry[entry.size() - 1]);
+        writeFile(entryPath, entry);
+
+        // Parsed again, and the entry replaced.
+        const auto reparsed = Config::loadCfg(sourcePath, options);
+        REQUIRE(reparsed != nullptr);
+        CHECK(cache.stats().hits == 0);
+        CHECK(cache.stats().misses == 2);
+        CHECK_THAT(reparsed->presets(), RangeEquals(parsed->presets()));
+        REQUIRE(Config::loadCfg(sourcePath, options) != nullptr);
+        CHECK(cache.stats().hits == 1);
+    }
+
+    SECTION("Eviction")
+    {
+        // Room for one entry.
+        cache.setMaxSize(cache.size());
+        // Same config, different bytes.
+        const auto changedPath = testDir.filePath("changed.cfg");
+        writeFile(changedPath, readFile(sourcePath) + '\n');
+
+        REQUIRE(Config::loadCfg(changedPath, options) != nullptr);
+        CHECK(cache.stats().evictions == 1);
+        CHECK(cacheEntries(cache).size() == 1);
+        CHECK(cache.size() <= cache.maxSize());
+    }
+
+    SECTION("Clear")
+    {
+        cache.clear();
+        CHECK(cacheEntries(cache).isEmpty());
+        REQUIRE(Config::loadCfg(sourcePath, options) != nullptr);
+        CHECK(cache.stats().misses == 2);
+    }
+}
+
+TEST_CASE("Config Cache Unwritable")
+{
+    // A cache that can't be written to doesn't stop configs from loading.
+    QTemporaryDir testDir;
+    const auto blockingFile = testDir.filePath("not_a_dir");
+    writeFile(blockingFile, "");
+    ConfigCache cache(blockingFile);
+    const auto config = Config::loadCfg(RESOURCES_PATH "/EchoPcpConfigTest/ERP.cfg", {.cache = &cache});
+    REQUIRE(config != nullptr);
+    CHECK(config->presetCount() > 0);
+    CHECK(cache.stats().misses == 1);
+}
@@ -0,0 +1,297 @@
+/**
+ * @file ConfigServerTest.cpp
+ *
+ * @author Dan Keenan
+ * @date 10/17/2026
+ * @copyright GNU GPLv3
+ */
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QLocalSocket>
+#include <QTemporaryDir>
+#include <QThread>
+#include <QUuid>
+#include <catch2/catch_test_macros.hpp>
+#include <set>
+#include "echoconfig/ConfigServer.h"
+#include "file_helpers.h"
+#include "qstring_tostring.h"
+
+using namespace echoconfig;
+
+namespace
+{
+    /** Sockets need an application for their event loop. */
+    void ensureApplication()
+    {
+        static int argc = 1;
+        static char arg0[] = "echoconfig_test";
+        static char* argv[] = {arg0, nullptr};
+        if (QCoreApplication::instance() == nullptr)
+        {
+            static QCoreApplication app(argc, argv);
+        }
+    }
+
+    /** Runs a server on its own thread, listening on a uniquely named socket. */
+    class ServerThread
+    {
+    public:
+        explicit ServerThread(const ConfigServer::Options& options) :
+            name_(QStringLiteral("echoconfig_test-") + QUuid::createUuid().toString(QUuid::WithoutBraces))
+        {
+            ensureApplication();
+            server_ = new ConfigServer(options);
+            server_->moveToThread(&thread_);
+            thread_.start();
+            bool listening = false;
+            QMetaObject::invokeMethod(
+                server_, [this, &listening]() { listening = server_->listen(name_); }, Qt::BlockingQueuedConnection);
+            REQUIRE(listening);
+        }
+
+        ~ServerThread()
+        {
+            QMetaObject::invokeMethod(server_, [this]() { delete server_; }, Qt::BlockingQueuedConnection);
+            thread_.quit();
+            thread_.wait();
+        }
+
+        [[nodiscard]] const QString& name() const { return name_; }
+        [[nodiscard]] ConfigServer& server() { return *server_; }
+
+    private:
+        QString name_;
+        QThread thread_;
+        ConfigServer* server_ = nullptr;
+    };
+
+    void sendLine(QLocalSocket& socket, const QByteArray& line)
+    {
+        socket.write(line + '\n');
+        REQUIRE(socket.waitForBytesWritten(5000));
+    }
+
+    QJsonObject receive(QLocalSocket& socket)
+    {
+        while (!socket.canReadLine())
+        {
+            REQUIRE(socket.waitForReadyRead(30000));
+        }
+        const auto doc = QJsonDocument::fromJson(socket.readLine());
+        REQUIRE(doc.isObject());
+        return doc.object();
+    }
+} // namespace
+
+TEST_CASE("Config Server")
+{
+    QTemporaryDir testDir;
+    ConfigServer server;
+    const auto cfgPath = testDir.filePath("ERP.cfg");
+    REQUIRE(QFile::copy(RESOURCES_PATH "/EchoPcpConfigTest/ERP.cfg", cfgPath));
+
+    const auto info = server.handle({
+        {QStringLiteral("id"), 1},
+        {QStringLiteral("op"), QStringLiteral("info")},
+        {QStringLiteral("cfg"), cfgPath},
+    });
+    CAPTURE(info.value(QStringLiteral("error")).toString());
+    REQUIRE(info.value(QStringLiteral("ok")).toBool());
+    CHECK(info.value(QStringLiteral("id")).toInt() == 1);
+    CHECK_FALSE(info.value(QStringLiteral("cached")).toBool());
+    CHECK(info.contains(QStringLiteral("latencyMs")));
+    const auto expected = Config::loadCfg(cfgPath);
+    REQUIRE(expected != nullptr);
+    const auto result = info.value(QStringLiteral("result")).toObject();
+    CHECK(result.value(QStringLiteral("type")).toString() == expected->panelType());
+    CHECK(result.value(QStringLiteral("name")).toString() == expected->panelName());
+    CHECK(result.value(QStringLiteral("circuits")).toInteger() == static_cast<qint64>(expected->circuitCount()));
+    CHECK(result.value(QStringLiteral("spaces")).toInteger() == static_cast<qint64>(expected->spaceCount()));
+    CHECK(result.value(QStringLiteral("presets")).toInteger() == static_cast<qint64>(expected->presetCount()));
+
+    SECTION("Kept")
+    {
+        const auto again = server.handle({
+            {QStringLiteral("op"), QStringLiteral("info")},
+            {QStringLiteral("cfg"), cfgPath},
+        });
+        CHECK(again.value(QStringLiteral("ok")).toBool());
+        CHECK(again.value(QStringLiteral("cached")).toBool());
+        CHECK(again.value(QStringLiteral("result")) == info.value(QStringLiteral("result")));
+        CHECK(server.stats().configHits == 1);
+        CHECK(server.stats().configMisses == 1);
+    }
+
+    SECTION("Changed file")
+    {
+        {
+            QFile f(cfgPath);
+            REQUIRE(f.open(QIODevice::WriteOnly | QIODevice::Truncate));
+            f.write(readFile(RESOURCES_PATH "/EchoPcpConfigTest/ERP_changed.cfg"));
+            REQUIRE(f.setFileTime(QDateTime::currentDateTime().addSecs(60), QFileDevice::FileModificationTime));
+        }
+        const auto again = server.handle({
+            {QStringLiteral("op"), QStringLiteral("info")},
+            {QStringLiteral("cfg"), cfgPath},
+        });
+        CHECK(again.value(QStringLiteral("ok")).toBool());
+        CHECK_FALSE(again.value(QStringLiteral("cached")).toBool());
+        CHECK(server.stats().configMisses == 2);
+    }
+
+    SECTION("Export sheet")
+    {
+        const auto sheetPath = testDir.filePath("ERP.xlsx");
+        const auto response = server.handle({
+            {QStringLiteral("op"), QStringLiteral("export-sheet")},
+            {QStringLiteral("cfg"), cfgPath},
+            {QStringLiteral("sheet"), sheetPath},
+        });
+        CAPTURE(response.value(QStringLiteral("error")).toString());
+        CHECK(response.value(QStringLiteral("ok")).toBool());
+        CHECK(response.value(QStringLiteral("cached")).toBool());
+        CHECK(QFile::exists(sheetPath));
+    }
+
+    SECTION("Import sheet")
+    {
+        const auto outPath = testDir.filePath("out.cfg");
+        const auto response = server.handle({
+            {QStringLiteral("op"), QStringLiteral("import-sheet")},
+            {QStringLiteral("cfg"), cfgPath},
+            {QStringLiteral("sheet"), RESOURCES_PATH "/EchoPcpConfigTest/ERP_changed.xlsx"},
+            {QStringLiteral("out"), outPath},
+        });
+        CAPTURE(response.value(QStringLiteral("error")).toString());
+        REQUIRE(response.value(QStringLiteral("ok")).toBool());
+        CHECK(readFile(outPath) == readFile(RESOURCES_PATH "/EchoPcpConfigTest/ERP_changed.cfg"));
+
+        // The kept config still has its own values.
+        const auto saveOutPath = testDir.filePath("save.cfg");
+        const auto saved = server.handle({
+            {QStringLiteral("op"), QStringLiteral("save-cfg")},
+            {QStringLiteral("cfg"), cfgPath},
+            {QStringLiteral("out"), saveOutPath},
+        });
+        REQUIRE(saved.value(QStringLiteral("ok")).toBool());
+        CHECK(saved.value(QStringLiteral("cached")).toBool());
+        REQUIRE_NOTHROW(expected->saveCfg(cfgPath, testDir.filePath("expected.cfg")));
+        CHECK(readFile(saveOutPath) == readFile(testDir.filePath("expected.cfg")));
+    }
+
+    SECTION("Errors")
+    {
+        const auto unknownOp = server.handle({
+            {QStringLiteral("op"), QStringLiteral("frobnicate")},
+            {QStringLiteral("cfg"), cfgPath},
+        });
+        CHECK_FALSE(unknownOp.value(QStringLiteral("ok")).toBool());
+        CHECK_FALSE(unknownOp.value(QStringLiteral("error")).toString().isEmpty());
+
+        const auto missingCfg = server.handle({
+            {QStringLiteral("op"), QStringLiteral("info")},
+            {QStringLiteral("cfg"), testDir.filePath("does_not_exist.cfg")},
+        });
+        CHECK_FALSE(missingCfg.value(QStringLiteral("ok")).toBool());
+
+        const auto missingOut = server.handle({
+            {QStringLiteral("op"), QStringLiteral("import-sheet")},
+            {QStringLiteral("cfg"), cfgPath},
+            {QStringLiteral("sheet"), RESOURCES_PATH "/EchoPcpConfigTest/ERP_changed.xlsx"},
+        });
+        CHECK_FALSE(missingOut.value(QStringLiteral("ok")).toBool());
+
+        CHECK(server.stats().requests == 4);
+        CHECK(server.stats().failures == 3);
+    }
+}
+
+TEST_CASE("Config Server Socket")
+{
+    ServerThread serverThread({.threadCount = 4});
+    QLocalSocket socket;
+    socket.connectToServer(serverThread.name());
+    REQUIRE(socket.waitForConnected(5000));
+
+    SECTION("Requests")
+    {
+        // Sent all at once; responses may come back in any order.
+        const auto cfgPaths = {
+            QStringLiteral(RESOURCES_PATH "/EchoPcpConfigTest/ERP.cfg"),
+            QStringLiteral(RESOURCES_PATH "/EchoAcpConfigTest/EACP.eacp"),
+        };
+        QByteArray lines;
+        int id = 0;
+        for (int round = 0; round < 4; ++round)
+        {
+            for (const auto& cfgPath : cfgPaths)
+            {
+                lines += QJsonDocument(QJsonObject{
+                                           {QStringLiteral("id"), id++},
+                                           {QStringLiteral("op"), QStringLiteral("info")},
+                                           {QStringLiteral("cfg"), cfgPath},
+                                       })
+                             .toJson(QJsonDocument::Compact) +
+                         '\n';
+            }
+        }
+        socket.write(lines);
+        REQUIRE(socket.waitForBytesWritten(5000));
+
+        std::set<int> ids;
+        for (int ix = 0; ix < id; ++ix)
+        {
+            const auto response = receive(socket);
+            CAPTURE(response.value(QStringLiteral("error")).toString());
+            CHECK(response.value(QStringLiteral("ok")).toBool());
+            ids.insert(response.value(QStringLiteral("id")).toInt());
+        }
+        CHECK(ids.size() == static_cast<std::size_t>(id));
+        CHECK(serverThread.server().stats().requests == static_cast<quint64>(id));
+        CHECK(serverThread.server().stats().failures == 0);
+    }
+
+    SECTION("Name in use")
+    {
+        // A second server mustn't take over the first one's socket.
+        ConfigServer second;
+        CHECK_FALSE(second.listen(serverThread.name()));
+        CHECK_FALSE(second.isListening());
+        CHECK_FALSE(second.errorString().isEmpty());
+
+        sendLine(socket, R"({"id": 3, "op": "info", "cfg": ")" RESOURCES_PATH R"(/EchoPcpConfigTest/ERP.cfg"})");
+        CHECK(receive(socket).value(QStringLiteral("ok")).toBool());
+        QLocalSocket another;
+        another.connectToServer(serverThread.name());
+        CHECK(another.waitForConnected(5000));
+    }
+
+#ifdef Q_OS_UNIX
+    SECTION("Private socket")
+    {
+        const QFileInfo socketInfo(serverThread.server().fullServerName());
+        REQUIRE(socketInfo.exists());
+        CHECK_FALSE(socketInfo.permissions().testAnyFlags(QFileDevice::ReadGroup | QFileDevice::WriteGroup |
+                                                          QFileDevice::ReadOther | QFileDevice::WriteOther));
+    }
+#endif
+
+    SECTION("Invalid request")
+    {
+        sendLine(socket, "not json");
+        const auto response = receive(socket);
+        CHECK_FALSE(response.value(QStringLiteral("ok")).toBool());
+        CHECK_FALSE(response.value(QStringLiteral("error")).toString().isEmpty());
+
+        // The connection is still usable.
+        sendLine(socket, R"({"id": 7, "op": "info", "cfg": ")" RESOURCES_PATH R"(/EchoPcpConfigTest/ERP.cfg"})");
+        const auto next = receive(socket);
+        CHECK(next.value(QStringLiteral("ok")).toBool());
+        CHECK(next.value(QStringLiteral("id")).toInt() == 7);
+    }
+}
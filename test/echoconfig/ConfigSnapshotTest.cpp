@@ -0,0 +1,133 @@
+/**
+ * @file ConfigSnapshotTest.cpp
+ *
+ * @author Dan Keenan
+ * @date 10/17/2026
+ * @copyright GNU GPLv3
+ */
+
+#include <QFile>
+#include <QTemporaryDir>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <catch2/matchers/catch_matchers_range_equals.hpp>
+#include <ranges>
+#include "echoconfig/ConfigSnapshot.h"
+#include "echoconfig/EchoPcpConfig.h"
+#include "file_helpers.h"
+#include "qstring_tostring.h"
+
+using namespace echoconfig;
+using Catch::Matchers::RangeEquals;
+
+TEST_CASE("Config Snapshot")
+{
+    const QString sourcePath = GENERATE(RESOURCES_PATH "/EchoPcpConfigTest/ERP.cfg",
+                                        RESOURCES_PATH "/EchoAcpConfigTest/EACP.eacp");
+    CAPTURE(sourcePath);
+    const auto config = Config::loadCfg(sourcePath);
+    REQUIRE(config != nullptr);
+    QTemporaryDir testDir;
+    const auto snapshotPath = testDir.filePath("config.snapshot");
+    REQUIRE_NOTHROW(config->saveSnapshot(sourcePath, snapshotPath));
+
+    SECTION("Read in place")
+    {
+        const ConfigSnapshot snapshot(snapshotPath);
+        const auto header = Config::sniffCfg(sourcePath);
+        REQUIRE(header.has_value());
+        CHECK(snapshot.cfgHeader().rootTag == header->rootTag);
+        CHECK(snapshot.cfgHeader().rackTag == header->rackTag);
+        CHECK(snapshot.cfgHeader().version == header->version);
+        CHECK(snapshot.panelName() == config->panelName());
+        CHECK_THAT(snapshot.circuits(), RangeEquals(config->circuits()));
+        CHECK_THAT(snapshot.spaces(), RangeEquals(config->spaces()));
+        const auto& rackSpaces = dynamic_cast<const EchoPcpConfig&>(*config).rackSpaces();
+        CHECK_THAT(snapshot.rackSpaces(),
+                   RangeEquals(rackSpaces.entries(), [](const auto& record, const auto& entry)
+                               { return record.rackSpaceNum == entry.first && record.echoSpaceNum == entry.second; }));
+
+        REQUIRE(snapshot.presets().size() == config->presets().size());
+        for (std::size_t ix = 0; ix < snapshot.presets().size(); ++ix)
+        {
+            const auto& record = snapshot.presets()[ix];
+            const auto& preset = config->presets()[ix];
+            CAPTURE(preset.num);
+            CHECK(record.num == preset.num);
+            CHECK_THAT(snapshot.levelCircuits(record), RangeEquals(preset.levels | std::views::keys));
+            CHECK_THAT(snapshot.levels(record), RangeEquals(preset.levels | std::views::values));
+            CHECK_THAT(snapshot.fadeTimeSpaces(record), RangeEquals(preset.fadeTimes | std::views::keys));
+            CHECK_THAT(snapshot.fadeTimes(record), RangeEquals(preset.fadeTimes | std::views::values));
+        }
+    }
+
+    SECTION("Restore")
+    {
+        const ConfigSnapshot snapshot(snapshotPath);
+        const auto restored = Config::fromSnapshot(snapshot);
+        REQUIRE(restored != nullptr);
+        CHECK(restored->panelType() == config->panelType());
+        CHECK(restored->panelName() == config->panelName());
+        CHECK_THAT(restored->circuits(), RangeEquals(config->circuits()));
+        CHECK_THAT(restored->spaces(), RangeEquals(config->spaces()));
+        CHECK_THAT(restored->presets(), RangeEquals(config->presets()));
+        CHECK_THAT(dynamic_cast<const EchoPcpConfig&>(*restored).rackSpaces().entries(),
+                   RangeEquals(dynamic_cast<const EchoPcpConfig&>(*config).rackSpaces().entries()));
+
+        // Saving doesn't depend on where the values came from.
+        const auto parsedOutPath = testDir.filePath("parsed.cfg");
+        const auto restoredOutPath = testDir.filePath("restored.cfg");
+        REQUIRE_NOTHROW(config->saveCfg(sourcePath, parsedOutPath));
+        REQUIRE_NOTHROW(restored->saveCfg(sourcePath, restoredOutPath));
+        CHECK(readFile(restoredOutPath) == readFile(parsedOutPath));
+    }
+
+    SECTION("Source validation")
+    {
+        const ConfigSnapshot snapshot(snapshotPath);
+        CHECK(snapshot.isSnapshotOf(sourcePath));
+
+        // A copy is still the same file.
+        auto contents = readFile(sourcePath);
+        const auto copyPath = testDir.filePath("copy.cfg");
+        writeFile(copyPath, contents);
+        CHECK(snapshot.isSnapshotOf(copyPath));
+
+        // Same size, different contents.
+        contents[contents.size() / 2] = contents[contents.size() / 2] == 'x' ? 'y' : 'x';
+        writeFile(copyPath, contents);
+        CHECK_FALSE(snapshot.isSnapshotOf(copyPath));
+        CHECK_FALSE(snapshot.isSnapshotOf(testDir.filePath("does_not_exist.cfg")));
+    }
+
+    SECTION("Damaged snapshots")
+    {
+        auto contents = readFile(snapshotPath);
+        const auto damagedPath = testDir.filePath("damaged.snapshot");
+
+        SECTION("Flipped byte")
+        {
+            contents[contents.size() - 1] = static_cast<char>(~contents[contents.size() - 1]);
+        }
+        SECTION("Truncated")
+        {
+            contents.chop(1);
+        }
+        SECTION("Newer version")
+        {
+            // The version follows the 8 byte magic number.
+            contents[8] = static_cast<char>(ConfigSnapshot::kVersion + 1);
+        }
+        SECTION("Not a snapshot")
+        {
+            contents = readFile(sourcePath);
+        }
+        writeFile(damagedPath, contents);
+        CHECK_THROWS(ConfigSnapshot(damagedPath));
+    }
+
+    SECTION("Missing snapshot")
+    {
+        CHECK_THROWS(ConfigSnapshot(testDir.filePath("does_not_exist.snapshot")));
+    }
+}
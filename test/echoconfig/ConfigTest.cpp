@@ -0,0 +1,97 @@
+/**
+ * @file ConfigTest.cpp
+ *
+ * @author Dan Keenan
+ * @date 10/17/2026
+ * @copyright GNU GPLv3
+ */
+
+#include <QFile>
+#include <QTemporaryDir>
+#include <catch2/catch_test_macros.hpp>
+#include "echoconfig/EchoAcpConfig.h"
+#include "echoconfig/EchoPcpConfig.h"
+#include "qstring_tostring.h"
+
+using namespace echoconfig;
+
+TEST_CASE("Sniff Cfg")
+{
+    SECTION("PCP")
+    {
+        const auto header = Config::sniffCfg(RESOURCES_PATH "/EchoPcpConfigTest/ERP.cfg");
+        REQUIRE(header.has_value());
+        CHECK(header->rootTag == QStringLiteral("SMARTSWITCH2"));
+        CHECK(header->rackTag == QStringLiteral("CABINET"));
+        CHECK(header->version == QStringLiteral("3.1.X"));
+    }
+
+    SECTION("ACP")
+    {
+        const auto header = Config::sniffCfg(RESOURCES_PATH "/EchoAcpConfigTest/EACP.eacp");
+        REQUIRE(header.has_value());
+        CHECK(header->rootTag == QStringLiteral("EACP"));
+        CHECK(header->rackTag == QStringLiteral("RACK"));
+        CHECK(header->version == QStringLiteral("2.0.3.7"));
+    }
+
+    SECTION("Missing file")
+    {
+        CHECK_FALSE(Config::sniffCfg(RESOURCES_PATH "/does_not_exist.cfg").has_value());
+    }
+}
+
+TEST_CASE("Load Cfg")
+{
+    SECTION("PCP")
+    {
+        const auto config = Config::loadCfg(RESOURCES_PATH "/EchoPcpConfigTest/ERP.cfg");
+        REQUIRE(config != nullptr);
+        CHECK(dynamic_cast<const EchoAcpConfig*>(config.get()) == nullptr);
+        CHECK(dynamic_cast<const EchoPcpConfig*>(config.get()) != nullptr);
+        CHECK(config->panelName() == QStringLiteral("Rack"));
+    }
+
+    SECTION("ACP")
+    {
+        const auto config = Config::loadCfg(RESOURCES_PATH "/EchoAcpConfigTest/EACP.eacp");
+        REQUIRE(config != nullptr);
+        CHECK(dynamic_cast<const EchoAcpConfig*>(config.get()) != nullptr);
+        CHECK(config->panelName() == QStringLiteral("Rack"));
+    }
+
+    SECTION("Unknown version")
+    {
+        QFile fIn(RESOURCES_PATH "/EchoPcpConfigTest/ERP.cfg");
+        REQUIRE(fIn.open(QIODevice::ReadOnly));
+        auto contents = fIn.readAll();
+        contents.replace(R"(VERSION="3.1.X")", R"(VERSION="9.9.X")");
+
+        QTemporaryDir testDir;
+        QFile fOut(testDir.filePath("unknown.cfg"));
+        REQUIRE(fOut.open(QIODevice::WriteOnly));
+        fOut.write(contents);
+        fOut.close();
+
+        CHECK(Config::loadCfg(fOut.fileName()) == nullptr);
+        CHECK_THROWS_WITH(Config::loadCfgOrThrow(fOut.fileName()), "Unknown config type");
+    }
+
+    SECTION("Parse error")
+    {
+        QFile fIn(RESOURCES_PATH "/EchoPcpConfigTest/ERP.cfg");
+        REQUIRE(fIn.open(QIODevice::ReadOnly));
+        auto contents = fIn.readAll();
+        contents.replace(R"(<PRELEVEL RELAY="1" LEVEL="255"/>)", R"(<PRELEVEL RELAY="1" LEVEL="256"/>)");
+
+        QTemporaryDir testDir;
+        QFile fOut(testDir.filePath("bad_level.cfg"));
+        REQUIRE(fOut.open(QIODevice::WriteOnly));
+        fOut.write(contents);
+        fOut.close();
+
+        CHECK(Config::loadCfg(fOut.fileName()) == nullptr);
+        // The reason isn't lost.
+        CHECK_THROWS_WITH(Config::loadCfgOrThrow(fOut.fileName()), "Bad level.");
+    }
+}
@@ -0,0 +1,211 @@
+/**
+ * @file CsvTest.cpp
+ *
+ * @author Dan Keenan
+ * @date 10/17/2026
+ * @copyright GNU GPLv3
+ */
+
+#include <QBuffer>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include "echoconfig/CsvReader.h"
+#include "echoconfig/CsvWriter.h"
+#include "qbytearray_tostring.h"
+#include "qstring_tostring.h"
+
+using namespace echoconfig;
+
+TEST_CASE("Csv Writer")
+{
+    QBuffer buffer;
+    REQUIRE(buffer.open(QIODevice::WriteOnly));
+
+    SECTION("Quoting")
+    {
+        CsvWriter writer(&buffer);
+        writer.beginRow();
+        writer.writeString(1, QStringLiteral("Plain"));
+        writer.writeString(2, QStringLiteral("a,b"));
+        writer.writeString(3, QStringLiteral(R"(Say "hi")"));
+        writer.writeString(4, QStringLiteral("Two\nlines"));
+        writer.writeString(5, QStringLiteral("Tab\tis fine"));
+        writer.endRow();
+        writer.end();
+        CHECK(buffer.data() == "Plain,\"a,b\",\"Say \"\"hi\"\"\",\"Two\nlines\",Tab\tis fine\r\n");
+    }
+
+    SECTION("Tabs")
+    {
+        CsvWriter writer(&buffer, '\t');
+        writer.beginRow();
+        writer.writeString(1, QStringLiteral("a,b"));
+        writer.writeString(2, QStringLiteral("Tab\tneeds quotes"));
+        writer.endRow();
+        writer.end();
+        CHECK(buffer.data() == "a,b\t\"Tab\tneeds quotes\"\r\n");
+    }
+
+    SECTION("Skipped columns")
+    {
+        CsvWriter writer(&buffer);
+        writer.beginRow();
+        writer.writeNumber(2, 1);
+        writer.writeNumber(5, 255);
+        writer.endRow();
+        writer.beginRow();
+        writer.writeNumber(1, 0);
+        writer.endRow();
+        writer.end();
+        CHECK(buffer.data() == ",1,,,255\r\n0\r\n");
+    }
+
+    SECTION("Columns out of order")
+    {
+        CsvWriter writer(&buffer);
+        writer.beginRow();
+        writer.writeNumber(2, 1);
+        CHECK_THROWS(writer.writeNumber(2, 1));
+        CHECK_THROWS(writer.writeNumber(1, 1));
+    }
+}
+
+TEST_CASE("Csv Reader")
+{
+    const auto readAll = [](QByteArray data, char delimiter = ',')
+    {
+        QBuffer buffer(&data);
+        REQUIRE(buffer.open(QIODevice::ReadOnly));
+        CsvReader reader(&buffer, delimiter);
+        std::vector<std::vector<SheetCell>> rows;
+        while (reader.readRow())
+        {
+            rows.emplace_back(reader.cells().begin(), reader.cells().end());
+        }
+        return rows;
+    };
+
+    SECTION("Cell types")
+    {
+        QByteArray data("Circuit,Preset 1,\xC3\xA9t\xC3\xA9,,007\n");
+        QBuffer buffer(&data);
+        REQUIRE(buffer.open(QIODevice::ReadOnly));
+        CsvReader reader(&buffer);
+        REQUIRE(reader.readRow());
+        CHECK(reader.rowNum() == 1);
+        REQUIRE(reader.cells().size() == 4);
+        REQUIRE(reader.cell(1) != nullptr);
+        CHECK(reader.cell(1)->type == SheetCell::Type::String);
+        CHECK(reader.cell(1)->text == QStringLiteral("Circuit"));
+        CHECK(reader.cell(2)->text == QStringLiteral("Preset 1"));
+        CHECK(reader.cell(3)->text == QString::fromUtf8("\xC3\xA9t\xC3\xA9"));
+        CHECK(reader.cell(4) == nullptr);
+        REQUIRE(reader.cell(5) != nullptr);
+        CHECK(reader.cell(5)->type == SheetCell::Type::Number);
+        CHECK(reader.cell(5)->number == 7);
+        CHECK(reader.cell(6) == nullptr);
+        CHECK_FALSE(reader.readRow());
+    }
+
+    SECTION("Line endings, blank rows, and byte order mark")
+    {
+        QByteArray data("\xEF\xBB\xBF"
+                        "1,2\r\n"
+                        "\r\n"
+                        ",,\n"
+                        "3,4");
+        QBuffer buffer(&data);
+        REQUIRE(buffer.open(QIODevice::ReadOnly));
+        CsvReader reader(&buffer);
+        REQUIRE(reader.readRow());
+        CHECK(reader.rowNum() == 1);
+        CHECK(reader.cell(1)->number == 1);
+        CHECK(reader.cell(2)->number == 2);
+        REQUIRE(reader.readRow());
+        CHECK(reader.rowNum() == 4);
+        CHECK(reader.cell(1)->number == 3);
+        CHECK(reader.cell(2)->number == 4);
+        CHECK_FALSE(reader.readRow());
+    }
+
+    SECTION("Quoted fields")
+    {
+        const auto rows = readAll("\"a,b\",\"Say \"\"hi\"\"\",\"Two\r\nlines\",\"12\"\n\"\",x\n");
+        REQUIRE(rows.size() == 2);
+        REQUIRE(rows[0].size() == 4);
+        CHECK(rows[0][0].text == QStringLiteral("a,b"));
+        CHECK(rows[0][1].text == QStringLiteral(R"(Say "hi")"));
+        CHECK(rows[0][2].text == QStringLiteral("Two\r\nlines"));
+        CHECK(rows[0][3].type == SheetCell::Type::Number);
+        CHECK(rows[0][3].number == 12);
+        REQUIRE(rows[1].size() == 1);
+        CHECK(rows[1][0].col == 2);
+    }
+
+    SECTION("Tabs")
+    {
+        const auto rows = readAll("a,b\t\"c\td\"\t5\n", '\t');
+        REQUIRE(rows.size() == 1);
+        REQUIRE(rows[0].size() == 3);
+        CHECK(rows[0][0].text == QStringLiteral("a,b"));
+        CHECK(rows[0][1].text == QStringLiteral("c\td"));
+        CHECK(rows[0][2].number == 5);
+    }
+
+    SECTION("Fields across buffer boundaries")
+    {
+        const auto length = GENERATE(64 * 1024 - 3, 64 * 1024, 200 * 1024);
+        CAPTURE(length);
+        const QByteArray longText(length, 'x');
+        QByteArray data("1,\"");
+        data.append(longText).append("\"\"\",").append(longText).append("\r\n2\r\n");
+        const auto rows = readAll(data);
+        REQUIRE(rows.size() == 2);
+        REQUIRE(rows[0].size() == 3);
+        CHECK(rows[0][1].text.size() == length + 1);
+        CHECK(rows[0][1].text.endsWith(u'"'));
+        CHECK(rows[0][2].text.size() == length);
+        CHECK(rows[1][0].number == 2);
+    }
+
+    SECTION("Malformed")
+    {
+        const QByteArray data = GENERATE(QByteArray("\"Unterminated\n"), QByteArray("\"Quoted\"text\n"));
+        CAPTURE(data);
+        CHECK_THROWS(readAll(data));
+    }
+
+    SECTION("Read back")
+    {
+        constexpr auto kRowCount = 50000;
+        QByteArray data;
+        QBuffer out(&data);
+        REQUIRE(out.open(QIODevice::WriteOnly));
+        CsvWriter writer(&out);
+        writer.beginRow();
+        writer.writeString(1, QStringLiteral("Number"));
+        writer.writeString(3, QStringLiteral("Quote \", comma"));
+        writer.endRow();
+        for (unsigned int row = 1; row <= kRowCount; ++row)
+        {
+            writer.beginRow();
+            writer.writeNumber(1, row);
+            writer.writeNumber(3, row % 256);
+            writer.endRow();
+        }
+        writer.end();
+        out.close();
+
+        const auto rows = readAll(data);
+        REQUIRE(rows.size() == kRowCount + 1);
+        CHECK(rows[0][1].text == QStringLiteral("Quote \", comma"));
+        bool allMatch = true;
+        for (unsigned int row = 1; row <= kRowCount; ++row)
+        {
+            const auto& cells = rows[row];
+            allMatch = allMatch && cells.size() == 2 && cells[0].number == row && cells[1].col == 3 &&
+                       cells[1].number == row % 256;
+        }
+        CHECK(allMatch);
+    }
+}
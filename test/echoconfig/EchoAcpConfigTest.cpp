@@ -9,6 +9,8 @@
 #include <QDomDocument>
 #include <QTemporaryDir>
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <catch2/matchers/catch_matchers_range_equals.hpp>
 #include <ranges>
 #include "XlsxMatcher.h"
 #include "echoconfig/EchoAcpConfig.h"
@@ -16,6 +18,7 @@
 #include "qstring_tostring.h"
 
 using namespace echoconfig;
+using Catch::Matchers::RangeEquals;
 
 static const std::vector<Circuit> kExpectedCircuits = {
     Circuit{.num = 1, .space = 1, .zone = 1},   Circuit{.num = 2, .space = 1, .zone = 2},
@@ -122,25 +125,18 @@ static const std::vector<Preset> kExpectedPresets = []()
 TEST_CASE("Echo ACP Config")
 {
     EchoAcpConfig config;
+    config.setParseEngine(GENERATE(ParseEngine::Stream, ParseEngine::Mapped));
     SECTION("Parse Cfg")
     {
         REQUIRE_NOTHROW(config.parseCfg(RESOURCES_PATH "/EchoAcpConfigTest/EACP.eacp"));
 
         // Circuits.
-        std::vector<Circuit> actualCircuits;
-        for (std::size_t ix = 0; ix < config.circuitCount(); ++ix)
-        {
-            actualCircuits.push_back(config.getCircuitAt(ix));
-        }
-        CHECK(kExpectedCircuits == actualCircuits);
+        CHECK_THAT(config.circuits(), RangeEquals(kExpectedCircuits));
 
         // Presets.
-        std::vector<Preset> actualPresets;
-        for (std::size_t presetIx = 0; presetIx < config.presetCount(); ++presetIx)
-        {
-            actualPresets.push_back(config.getPresetAt(presetIx));
-        }
-        CHECK(kExpectedPresets == actualPresets);
+        CHECK_THAT(config.presets(), RangeEquals(kExpectedPresets));
+        CHECK_THAT(config.levelsOf(config.getPreset(1)), RangeEquals(std::vector<unsigned int>(48, 255)));
+        CHECK_THAT(config.levelsOf(config.getPreset(4)), RangeEquals(std::vector<unsigned int>(48, 64)));
     }
 
     SECTION("Write Sheet")
@@ -171,12 +167,7 @@ TEST_CASE("Echo ACP Config")
 
             return circuits;
         }();
-        std::vector<Circuit> actualCircuits;
-        for (std::size_t ix = 0; ix < config.circuitCount(); ++ix)
-        {
-            actualCircuits.push_back(config.getCircuitAt(ix));
-        }
-        CHECK(expectedCircuits == actualCircuits);
+        CHECK_THAT(config.circuits(), RangeEquals(expectedCircuits));
 
         // Presets.
         const auto expectedPresets = []()
@@ -198,16 +189,12 @@ TEST_CASE("Echo ACP Config")
             }
             return presets;
         }();
-        std::vector<Preset> actualPresets;
-        for (std::size_t presetIx = 0; presetIx < config.presetCount(); ++presetIx)
-        {
-            actualPresets.push_back(config.getPresetAt(presetIx));
-        }
-        CHECK(expectedPresets == actualPresets);
+        CHECK_THAT(config.presets(), RangeEquals(expectedPresets));
     }
 
     SECTION("Write Cfg")
     {
+        config.setSaveOptions({.threadCount = GENERATE(1u, 4u)});
         REQUIRE_NOTHROW(config.parseSheet(RESOURCES_PATH "/EchoAcpConfigTest/EACP_changed.xlsx"));
 
         QTemporaryDir testDir;
@@ -225,4 +212,64 @@ TEST_CASE("Echo ACP Config")
         xmlActual.setContent(&fActual);
         CHECK(xmlExpected.toString(4) == xmlActual.toString(4));
     }
+
+    SECTION("Write Cfg preserves formatting")
+    {
+        config.setSaveOptions({.threadCount = GENERATE(1u, 4u)});
+        // Parsing the base file first lets the save reuse what was recorded while parsing.
+        const auto parseBase = GENERATE(false, true);
+        if (parseBase)
+        {
+            REQUIRE_NOTHROW(config.parseCfg(RESOURCES_PATH "/EchoAcpConfigTest/EACP.eacp"));
+        }
+        REQUIRE_NOTHROW(config.parseSheet(RESOURCES_PATH "/EchoAcpConfigTest/EACP_changed.xlsx"));
+
+        QTemporaryDir testDir;
+        const auto cfgFilePath = testDir.filePath("eacp_changed.eacp");
+        REQUIRE_NOTHROW(config.saveCfg(RESOURCES_PATH "/EchoAcpConfigTest/EACP.eacp", cfgFilePath));
+
+        // Only the changed values are touched, so the output matches byte-for-byte.
+        QFile fExpected(RESOURCES_PATH "/EchoAcpConfigTest/EACP_changed.eacp");
+        REQUIRE(fExpected.open(QIODevice::ReadOnly));
+        QFile fActual(cfgFilePath);
+        REQUIRE(fActual.open(QIODevice::ReadOnly));
+        CHECK(fExpected.readAll() == fActual.readAll());
+    }
+
+    SECTION("Write Cfg from retained base")
+    {
+        config.setSaveOptions({.threadCount = GENERATE(1u, 4u)});
+        QTemporaryDir testDir;
+        const auto basePath = testDir.filePath("EACP.eacp");
+        REQUIRE(QFile::copy(RESOURCES_PATH "/EchoAcpConfigTest/EACP.eacp", basePath));
+        config.setParseOptions({.engine = config.parseEngine(), .retainBase = true});
+        REQUIRE_NOTHROW(config.parseCfg(basePath));
+        REQUIRE_NOTHROW(config.parseSheet(RESOURCES_PATH "/EchoAcpConfigTest/EACP_changed.xlsx"));
+
+        const auto cfgFilePath = testDir.filePath("EACP_changed.eacp");
+        REQUIRE_NOTHROW(config.saveCfg(basePath, cfgFilePath));
+
+        QFile fExpected(RESOURCES_PATH "/EchoAcpConfigTest/EACP_changed.eacp");
+        REQUIRE(fExpected.open(QIODevice::ReadOnly));
+        QFile fActual(cfgFilePath);
+        REQUIRE(fActual.open(QIODevice::ReadOnly));
+        CHECK(fExpected.readAll() == fActual.readAll());
+    }
+
+    SECTION("Write Cfg unchanged")
+    {
+        config.setSaveOptions({.threadCount = GENERATE(1u, 4u)});
+        REQUIRE_NOTHROW(config.parseCfg(RESOURCES_PATH "/EchoAcpConfigTest/EACP.eacp"));
+
+        QTemporaryDir testDir;
+        const auto cfgFilePath = testDir.filePath("eacp.eacp");
+        REQUIRE_NOTHROW(config.saveCfg(RESOURCES_PATH "/EchoAcpConfigTest/EACP.eacp", cfgFilePath));
+
+        QFile fBase(RESOURCES_PATH "/EchoAcpConfigTest/EACP.eacp");
+        REQUIRE(fBase.open(QIODevice::ReadOnly));
+        QFile fActual(cfgFilePath);
+        REQUIRE(fActual.open(QIODevice::ReadOnly));
+        // Except for the XML declaration, which always says UTF-8.
+        CHECK(fBase.readAll().replace(R"(encoding="utf-8")", R"(encoding="UTF-8")") == fActual.readAll());
+    }
 }
@@ -0,0 +1,370 @@
+/**
+ * @file EchoConfigBench.cpp
+ *
+ * @author Dan Keenan
+ * @date 10/17/2026
+ * @copyright GNU GPLv3
+ */
+
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include "Throughput.h"
+#include "echoconfig/ConfigCache.h"
+#include "echoconfig/EchoAcpConfig.h"
+#include "echoconfig/EchoPcpConfig.h"
+#include "echoconfig/FixtureGenerator.h"
+#include "echoconfig/StructuralIndex.h"
+
+using namespace echoconfig;
+
+/**
+ * Fixture files for each config type.
+ */
+template <ConfigClass C>
+struct Resources;
+
+template <>
+struct Resources<EchoPcpConfig>
+{
+    static constexpr auto kName = "PCP";
+    static constexpr auto kCfg = RESOURCES_PATH "/EchoPcpConfigTest/ERP.cfg";
+    static constexpr auto kSheet = RESOURCES_PATH "/EchoPcpConfigTest/ERP_changed.xlsx";
+};
+
+template <>
+struct Resources<EchoAcpConfig>
+{
+    static constexpr auto kName = "ACP";
+    static constexpr auto kCfg = RESOURCES_PATH "/EchoAcpConfigTest/EACP.eacp";
+    static constexpr auto kSheet = RESOURCES_PATH "/EchoAcpConfigTest/EACP_changed.xlsx";
+};
+
+static QByteArray readAll(const QString& path)
+{
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly))
+    {
+        throw std::runtime_error("Failed to open file");
+    }
+    return f.readAll();
+}
+
+/**
+ * Number of cells in the sheets written for @p config.
+ */
+static std::size_t sheetCellCount(const Config& config)
+{
+    const auto levelsCells = (config.circuitCount() + 1) * (3 + config.presetCount());
+    const auto timesCells = (config.spaceCount() + 1) * (1 + config.presetCount());
+    return levelsCells + timesCells;
+}
+
+static std::string benchName(const char* configName, const char* operation)
+{
+    return std::string(configName) + " " + operation;
+}
+
+static const char* isaBenchName(StructuralIndex::Isa isa)
+{
+    switch (isa)
+    {
+    case StructuralIndex::Isa::Avx2:
+        return "structural index avx2";
+    case StructuralIndex::Isa::Sse2:
+        return "structural index sse2";
+    default:
+        return "structural index scalar";
+    }
+}
+
+TEMPLATE_TEST_CASE("Config I/O Benchmark", "[benchmark]", EchoPcpConfig, EchoAcpConfig)
+{
+    using Res = Resources<TestType>;
+    const QString cfgPath(Res::kCfg);
+    const QString sheetPath(Res::kSheet);
+    const auto cfgData = readAll(cfgPath);
+    const auto cfgElements = countXmlElements(cfgData);
+    QTemporaryDir outDir;
+
+    TestType parsed;
+    parsed.parseCfg(cfgPath);
+    const auto cellCount = sheetCellCount(parsed);
+
+    SECTION("parseCfg")
+    {
+        const auto name = benchName(Res::kName, "parseCfg");
+        Throughput throughput(name, cfgData.size(), cfgElements);
+        BENCHMARK(name.c_str())
+        {
+            return throughput.measure(
+                [&]()
+                {
+                    TestType config;
+                    config.parseCfg(cfgPath);
+                    return config.presetCount();
+                });
+        };
+        throughput.report();
+    }
+
+    SECTION("parseCfg mapped")
+    {
+        const auto name = benchName(Res::kName, "parseCfg mapped");
+        Throughput throughput(name, cfgData.size(), cfgElements);
+        BENCHMARK(name.c_str())
+        {
+            return throughput.measure(
+                [&]()
+                {
+                    TestType config;
+                    config.setParseEngine(ParseEngine::Mapped);
+                    config.parseCfg(cfgPath);
+                    return config.presetCount();
+                });
+        };
+        throughput.report();
+    }
+
+    SECTION("loadCfg")
+    {
+        // Should cost the same as parseCfg: the dialect is sniffed, then the file is parsed once.
+        const auto name = benchName(Res::kName, "loadCfg");
+        Throughput throughput(name, cfgData.size(), cfgElements);
+        BENCHMARK(name.c_str())
+        {
+            return throughput.measure([&]() { return Config::loadCfg(cfgPath); });
+        };
+        throughput.report();
+    }
+
+    SECTION("saveCfg")
+    {
+        TestType config;
+        config.parseSheet(sheetPath);
+        const auto outPath = outDir.filePath(QFileInfo(cfgPath).fileName());
+        const auto name = benchName(Res::kName, "saveCfg");
+        Throughput throughput(name, cfgData.size(), cfgElements);
+        BENCHMARK(name.c_str())
+        {
+            return throughput.measure([&]() { config.saveCfg(cfgPath, outPath); });
+        };
+        throughput.report();
+    }
+
+    SECTION("saveSheet")
+    {
+        const auto outPath = outDir.filePath("out.xlsx");
+        parsed.saveSheet(outPath);
+        const auto name = benchName(Res::kName, "saveSheet");
+        Throughput throughput(name, QFileInfo(outPath).size(), cellCount);
+        BENCHMARK(name.c_str())
+        {
+            return throughput.measure([&]() { parsed.saveSheet(outPath); });
+        };
+        throughput.report();
+    }
+
+    SECTION("parseSheet")
+    {
+        const auto name = benchName(Res::kName, "parseSheet");
+        Throughput throughput(name, QFileInfo(sheetPath).size(), cellCount);
+        BENCHMARK(name.c_str())
+        {
+            return throughput.measure(
+                [&]()
+                {
+                    TestType config;
+                    config.parseSheet(sheetPath);
+                    return config.presetCount();
+                });
+        };
+        throughput.report();
+    }
+}
+
+TEST_CASE("Scaled Config I/O Benchmark", "[benchmark]")
+{
+    // Circuits and presets both grow with the scale, so element counts grow with its square.
+    const auto scale = GENERATE(1u, 3u, 10u, 32u);
+    const auto dialect = GENERATE(FixtureGenerator::Dialect::Pcp, FixtureGenerator::Dialect::Acp);
+    const FixtureGenerator generator({
+        .dialect = dialect,
+        .circuitCount = 48 * scale,
+        .spaceCount = 2 * scale,
+        .presetCount = 64 * scale,
+    });
+    QTemporaryDir outDir;
+    const auto cfgPath = outDir.filePath(QStringLiteral("generated.%1").arg(generator.cfgSuffix()));
+    const auto sheetPath = outDir.filePath(QStringLiteral("generated.xlsx"));
+    generator.saveCfg(cfgPath);
+    generator.saveSheet(sheetPath);
+    const auto cfgData = readAll(cfgPath);
+    const auto cfgElements = countXmlElements(cfgData);
+    const auto configName = std::string(dialect == FixtureGenerator::Dialect::Pcp ? "PCP" : "ACP") + " x" +
+        std::to_string(scale * scale);
+
+    const auto parsed = generator.createConfig();
+    parsed->parseCfg(cfgPath);
+    const auto cellCount = sheetCellCount(*parsed);
+
+    SECTION("parseCfg")
+    {
+        const auto name = benchName(configName.c_str(), "parseCfg");
+        Throughput throughput(name, cfgData.size(), cfgElements);
+        BENCHMARK(name.c_str())
+        {
+            return throughput.measure(
+                [&]()
+                {
+                    const auto config = generator.createConfig();
+                    config->parseCfg(cfgPath);
+                    return config->presetCount();
+                });
+        };
+        throughput.report();
+    }
+
+    SECTION("structural index")
+    {
+        const std::string_view bytes(cfgData.constData(), cfgData.size());
+        const auto isa = GENERATE(StructuralIndex::Isa::Scalar, StructuralIndex::Isa::Sse2, StructuralIndex::Isa::Avx2);
+        if (StructuralIndex::isSupported(isa))
+        {
+            const auto name = benchName(configName.c_str(), isaBenchName(isa));
+            Throughput throughput(name, cfgData.size(), cfgElements);
+            BENCHMARK(name.c_str())
+            {
+                return throughput.measure(
+                    [&]() { return StructuralIndex(bytes, 0, bytes.size(), isa).count(StructuralIndex::Mark::Tag); });
+            };
+            throughput.report();
+        }
+    }
+
+    SECTION("parseCfg mapped")
+    {
+        const auto name = benchName(configName.c_str(), "parseCfg mapped");
+        Throughput throughput(name, cfgData.size(), cfgElements);
+        BENCHMARK(name.c_str())
+        {
+            return throughput.measure(
+                [&]()
+                {
+                    const auto config = generator.createConfig();
+                    config->setParseEngine(ParseEngine::Mapped);
+                    config->parseCfg(cfgPath);
+                    return config->presetCount();
+                });
+        };
+        throughput.report();
+    }
+
+    SECTION("parseCfg mapped parallel")
+    {
+        const auto name = benchName(configName.c_str(), "parseCfg mapped parallel");
+        Throughput throughput(name, cfgData.size(), cfgElements);
+        BENCHMARK(name.c_str())
+        {
+            return throughput.measure(
+                [&]()
+                {
+                    const auto config = generator.createConfig();
+                    config->setParseOptions({.engine = ParseEngine::Mapped, .threadCount = 0});
+                    config->parseCfg(cfgPath);
+                    return config->presetCount();
+                });
+        };
+        throughput.report();
+    }
+
+    SECTION("loadCfg cached")
+    {
+        // After the first load this is a hash of the file and a snapshot restore, not a parse.
+        ConfigCache cache(outDir.filePath(QStringLiteral("cache")));
+        const ParseOptions options{.cache = &cache};
+        REQUIRE(Config::loadCfg(cfgPath, options) != nullptr);
+        const auto name = benchName(configName.c_str(), "loadCfg cached");
+        Throughput throughput(name, cfgData.size(), cfgElements);
+        BENCHMARK(name.c_str())
+        {
+            return throughput.measure([&]() { return Config::loadCfg(cfgPath, options); });
+        };
+        throughput.report();
+        CHECK(cache.stats().misses == 1);
+    }
+
+    SECTION("saveCfg")
+    {
+        const auto config = generator.createConfig();
+        config->parseSheet(sheetPath);
+        const auto outPath = outDir.filePath(QStringLiteral("out.%1").arg(generator.cfgSuffix()));
+        const auto name = benchName(configName.c_str(), "saveCfg");
+        Throughput throughput(name, cfgData.size(), cfgElements);
+        BENCHMARK(name.c_str())
+        {
+            return throughput.measure([&]() { config->saveCfg(cfgPath, outPath); });
+        };
+        throughput.report();
+    }
+
+    SECTION("saveCfg parallel")
+    {
+        const auto config = generator.createConfig();
+        config->setSaveOptions({.threadCount = 0});
+        config->parseSheet(sheetPath);
+        const auto outPath = outDir.filePath(QStringLiteral("out.%1").arg(generator.cfgSuffix()));
+        const auto name = benchName(configName.c_str(), "saveCfg parallel");
+        Throughput throughput(name, cfgData.size(), cfgElements);
+        BENCHMARK(name.c_str())
+        {
+            return throughput.measure([&]() { config->saveCfg(cfgPath, outPath); });
+        };
+        throughput.report();
+    }
+
+    SECTION("saveSheet")
+    {
+        const auto outPath = outDir.filePath("out.xlsx");
+        const auto name = benchName(configName.c_str(), "saveSheet");
+        Throughput throughput(name, QFileInfo(sheetPath).size(), cellCount);
+        BENCHMARK(name.c_str())
+        {
+            return throughput.measure([&]() { parsed->saveSheet(outPath); });
+        };
+        throughput.report();
+    }
+
+    SECTION("saveSheet store")
+    {
+        const auto outPath = outDir.filePath("out.xlsx");
+        const auto name = benchName(configName.c_str(), "saveSheet store");
+        Throughput throughput(name, QFileInfo(sheetPath).size(), cellCount);
+        BENCHMARK(name.c_str())
+        {
+            return throughput.measure([&]() { parsed->saveSheet(outPath, {.compression = CompressionLevel::Store}); });
+        };
+        throughput.report();
+    }
+
+    SECTION("parseSheet")
+    {
+        const auto name = benchName(configName.c_str(), "parseSheet");
+        Throughput throughput(name, QFileInfo(sheetPath).size(), cellCount);
+        BENCHMARK(name.c_str())
+        {
+            return throughput.measure(
+                [&]()
+                {
+                    const auto config = generator.createConfig();
+                    config->parseSheet(sheetPath);
+                    return config->presetCount();
+                });
+        };
+        throughput.report();
+    }
+}
@@ -7,15 +7,22 @@
  */
 
 #include <QDomDocument>
+#include <QFile>
+#include <QFileInfo>
 #include <QTemporaryDir>
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <catch2/matchers/catch_matchers_range_equals.hpp>
 #include <ranges>
 #include "XlsxMatcher.h"
+#include "echoconfig/BlockIo.h"
 #include "echoconfig/EchoPcpConfig.h"
+#include "echoconfig/FixtureGenerator.h"
 #include "genLevelsMap.h"
 #include "qstring_tostring.h"
 
 using namespace echoconfig;
+using Catch::Matchers::RangeEquals;
 
 static const std::vector<Circuit> kExpectedCircuits = {
     Circuit{.num = 1, .space = 1, .zone = 1},   Circuit{.num = 2, .space = 1, .zone = 2},
@@ -122,25 +129,18 @@ static const std::vector<Preset> kExpectedPresets = []()
 TEST_CASE("Echo PCP Config")
 {
     EchoPcpConfig config;
+    config.setParseEngine(GENERATE(ParseEngine::Stream, ParseEngine::Mapped));
     SECTION("Parse Cfg")
     {
         REQUIRE_NOTHROW(config.parseCfg(RESOURCES_PATH "/EchoPcpConfigTest/ERP.cfg"));
 
         // Circuits.
-        std::vector<Circuit> actualCircuits;
-        for (std::size_t ix = 0; ix < config.circuitCount(); ++ix)
-        {
-            actualCircuits.push_back(config.getCircuitAt(ix));
-        }
-        CHECK(kExpectedCircuits == actualCircuits);
+        CHECK_THAT(config.circuits(), RangeEquals(kExpectedCircuits));
 
         // Presets.
-        std::vector<Preset> actualPresets;
-        for (std::size_t presetIx = 0; presetIx < config.presetCount(); ++presetIx)
-        {
-            actualPresets.push_back(config.getPresetAt(presetIx));
-        }
-        CHECK(kExpectedPresets == actualPresets);
+        CHECK_THAT(config.presets(), RangeEquals(kExpectedPresets));
+        CHECK_THAT(config.levelsOf(config.getPreset(1)), RangeEquals(std::vector<unsigned int>(48, 255)));
+        CHECK_THAT(config.levelsOf(config.getPreset(4)), RangeEquals(std::vector<unsigned int>(48, 64)));
     }
 
     SECTION("Write Sheet")
@@ -156,6 +156,71 @@ TEST_CASE("Echo PCP Config")
         CHECK_THAT(expected, MatchesXlsx(actual));
     }
 
+    SECTION("Write Sheet without compression")
+    {
+        REQUIRE_NOTHROW(config.parseCfg(RESOURCES_PATH "/EchoPcpConfigTest/ERP.cfg"));
+
+        QTemporaryDir testDir;
+        const auto xlsxFilePath = testDir.filePath("erp.xlsx");
+        REQUIRE_NOTHROW(config.saveSheet(xlsxFilePath, {.compression = CompressionLevel::Store}));
+        QXlsx::Document expected(RESOURCES_PATH "/EchoPcpConfigTest/ERP.xlsx");
+        QXlsx::Document actual(xlsxFilePath);
+
+        CHECK_THAT(expected, MatchesXlsx(actual));
+    }
+
+    SECTION("Write Sheet with compact preset columns")
+    {
+        REQUIRE_NOTHROW(config.parseCfg(RESOURCES_PATH "/EchoPcpConfigTest/ERP.cfg"));
+        auto sparsePreset = config.getPreset(4);
+        sparsePreset.num = 900;
+        config.getPreset(900) = sparsePreset;
+
+        QTemporaryDir testDir;
+        const auto xlsxFilePath = testDir.filePath("erp.xlsx");
+        REQUIRE_NOTHROW(config.saveSheet(xlsxFilePath, {.layout = PresetLayout::Compact}));
+
+        // Preset 900 comes straight after preset 64.
+        QXlsx::Document actual(xlsxFilePath);
+        REQUIRE(actual.selectSheet(QStringLiteral("Levels")));
+        CHECK(actual.dimension().columnCount() == 3 + 65);
+        CHECK(actual.read(1, 3 + 65).toString() == QStringLiteral("Preset 900"));
+        REQUIRE(actual.selectSheet(QStringLiteral("Times")));
+        CHECK(actual.dimension().columnCount() == 1 + 65);
+        CHECK(actual.read(1, 1 + 65).toString() == QStringLiteral("Preset 900"));
+
+        EchoPcpConfig roundTrip;
+        REQUIRE_NOTHROW(roundTrip.parseCfg(RESOURCES_PATH "/EchoPcpConfigTest/ERP.cfg"));
+        REQUIRE_NOTHROW(roundTrip.parseSheet(xlsxFilePath));
+        CHECK_THAT(roundTrip.presets(), RangeEquals(config.presets()));
+    }
+
+    SECTION("Write Sheet as delimited tables")
+    {
+        const auto [fileName, delimiter] = GENERATE(std::pair{"erp.csv", ','}, std::pair{"erp.tsv", '\t'});
+        CAPTURE(fileName);
+        REQUIRE_NOTHROW(config.parseSheet(RESOURCES_PATH "/EchoPcpConfigTest/ERP_changed.xlsx"));
+
+        QTemporaryDir testDir;
+        const auto sheetPath = testDir.filePath(fileName);
+        REQUIRE_NOTHROW(config.saveSheet(sheetPath));
+        const auto [levelsPath, timesPath] = Config::tablePaths(sheetPath);
+        QFile levelsFile(levelsPath);
+        REQUIRE(levelsFile.open(QIODevice::ReadOnly));
+        const auto levelsHeader = QStringLiteral("Circuit%1Space%1Zone%1Preset 1%1").arg(delimiter).toUtf8();
+        CHECK(levelsFile.readLine().startsWith(levelsHeader));
+        QFile timesFile(timesPath);
+        REQUIRE(timesFile.open(QIODevice::ReadOnly));
+        CHECK(timesFile.readLine().startsWith(QStringLiteral("Space%1Preset 1%1").arg(delimiter).toUtf8()));
+
+        // Either table names the pair.
+        EchoPcpConfig roundTrip;
+        REQUIRE_NOTHROW(roundTrip.parseSheet(timesPath));
+        CHECK_THAT(roundTrip.circuits(), RangeEquals(config.circuits()));
+        CHECK_THAT(roundTrip.spaces(), RangeEquals(config.spaces()));
+        CHECK_THAT(roundTrip.presets(), RangeEquals(config.presets()));
+    }
+
     SECTION("Read Sheet")
     {
         REQUIRE_NOTHROW(config.parseSheet(RESOURCES_PATH "/EchoPcpConfigTest/ERP_changed.xlsx"));
@@ -171,12 +236,7 @@ TEST_CASE("Echo PCP Config")
 
             return circuits;
         }();
-        std::vector<Circuit> actualCircuits;
-        for (std::size_t ix = 0; ix < config.circuitCount(); ++ix)
-        {
-            actualCircuits.push_back(config.getCircuitAt(ix));
-        }
-        CHECK(expectedCircuits == actualCircuits);
+        CHECK_THAT(config.circuits(), RangeEquals(expectedCircuits));
 
         // Presets.
         const auto expectedPresets = []()
@@ -198,16 +258,12 @@ TEST_CASE("Echo PCP Config")
             }
             return presets;
         }();
-        std::vector<Preset> actualPresets;
-        for (std::size_t presetIx = 0; presetIx < config.presetCount(); ++presetIx)
-        {
-            actualPresets.push_back(config.getPresetAt(presetIx));
-        }
-        CHECK(expectedPresets == actualPresets);
+        CHECK_THAT(config.presets(), RangeEquals(expectedPresets));
     }
 
     SECTION("Write Cfg")
     {
+        config.setSaveOptions({.threadCount = GENERATE(1u, 4u)});
         REQUIRE_NOTHROW(config.parseSheet(RESOURCES_PATH "/EchoPcpConfigTest/ERP_changed.xlsx"));
 
         QTemporaryDir testDir;
@@ -225,4 +281,217 @@ TEST_CASE("Echo PCP Config")
         xmlActual.setContent(&fActual);
         CHECK(xmlExpected.toString(4) == xmlActual.toString(4));
     }
+
+    SECTION("Write Cfg preserves formatting")
+    {
+        config.setSaveOptions({.threadCount = GENERATE(1u, 4u)});
+        // Parsing the base file first lets the save reuse what was recorded while parsing.
+        const auto parseBase = GENERATE(false, true);
+        if (parseBase)
+        {
+            REQUIRE_NOTHROW(config.parseCfg(RESOURCES_PATH "/EchoPcpConfigTest/ERP.cfg"));
+        }
+        REQUIRE_NOTHROW(config.parseSheet(RESOURCES_PATH "/EchoPcpConfigTest/ERP_changed.xlsx"));
+
+        QTemporaryDir testDir;
+        const auto cfgFilePath = testDir.filePath("erp_changed.cfg");
+        REQUIRE_NOTHROW(config.saveCfg(RESOURCES_PATH "/EchoPcpConfigTest/ERP.cfg", cfgFilePath));
+
+        // Only the changed values are touched, so the output matches byte-for-byte.
+        QFile fExpected(RESOURCES_PATH "/EchoPcpConfigTest/ERP_changed.cfg");
+        REQUIRE(fExpected.open(QIODevice::ReadOnly));
+        QFile fActual(cfgFilePath);
+        REQUIRE(fActual.open(QIODevice::ReadOnly));
+        CHECK(fExpected.readAll() == fActual.readAll());
+    }
+
+    SECTION("Write Cfg from retained base")
+    {
+        config.setSaveOptions({.threadCount = GENERATE(1u, 4u)});
+        QTemporaryDir testDir;
+        const auto basePath = testDir.filePath("erp.cfg");
+        REQUIRE(QFile::copy(RESOURCES_PATH "/EchoPcpConfigTest/ERP.cfg", basePath));
+        config.setParseOptions({.engine = config.parseEngine(), .retainBase = true});
+        REQUIRE_NOTHROW(config.parseCfg(basePath));
+        REQUIRE_NOTHROW(config.parseSheet(RESOURCES_PATH "/EchoPcpConfigTest/ERP_changed.xlsx"));
+        const auto cfgFilePath = testDir.filePath("erp_changed.cfg");
+
+        SECTION("Same file")
+        {
+            REQUIRE_NOTHROW(config.saveCfg(basePath, cfgFilePath));
+        }
+
+        SECTION("Touched file")
+        {
+            QFile fBase(basePath);
+            REQUIRE(fBase.open(QIODevice::ReadWrite));
+            REQUIRE(fBase.setFileTime(QDateTime::currentDateTime().addDays(1), QFileDevice::FileModificationTime));
+            fBase.close();
+            REQUIRE_NOTHROW(config.saveCfg(basePath, cfgFilePath));
+        }
+
+        SECTION("Output replaces base")
+        {
+            REQUIRE_NOTHROW(config.saveCfg(basePath, basePath));
+            REQUIRE(QFile::rename(basePath, cfgFilePath));
+        }
+
+        QFile fExpected(RESOURCES_PATH "/EchoPcpConfigTest/ERP_changed.cfg");
+        REQUIRE(fExpected.open(QIODevice::ReadOnly));
+        QFile fActual(cfgFilePath);
+        REQUIRE(fActual.open(QIODevice::ReadOnly));
+        CHECK(fExpected.readAll() == fActual.readAll());
+    }
+
+    SECTION("Write Cfg after base changed")
+    {
+        config.setSaveOptions({.threadCount = GENERATE(1u, 4u)});
+        QTemporaryDir testDir;
+        const auto basePath = testDir.filePath("erp.cfg");
+        REQUIRE(QFile::copy(RESOURCES_PATH "/EchoPcpConfigTest/ERP.cfg", basePath));
+        config.setParseOptions({.engine = config.parseEngine(), .retainBase = true});
+        REQUIRE_NOTHROW(config.parseCfg(basePath));
+
+        // Add a comment to the base file; the save must use the new contents, not the retained ones.
+        QFile fBase(basePath);
+        REQUIRE(fBase.open(QIODevice::Append));
+        fBase.write("<!-- Edited -->\n");
+        fBase.close();
+
+        const auto cfgFilePath = testDir.filePath("erp.cfg.out");
+        REQUIRE_NOTHROW(config.saveCfg(basePath, cfgFilePath));
+        REQUIRE(fBase.open(QIODevice::ReadOnly));
+        QFile fActual(cfgFilePath);
+        REQUIRE(fActual.open(QIODevice::ReadOnly));
+        CHECK(fBase.readAll().replace(R"(encoding="utf-8")", R"(encoding="UTF-8")") == fActual.readAll());
+    }
+
+    SECTION("Write Cfg unchanged")
+    {
+        config.setSaveOptions({.threadCount = GENERATE(1u, 4u)});
+        REQUIRE_NOTHROW(config.parseCfg(RESOURCES_PATH "/EchoPcpConfigTest/ERP.cfg"));
+
+        QTemporaryDir testDir;
+        const auto cfgFilePath = testDir.filePath("erp.cfg");
+        REQUIRE_NOTHROW(config.saveCfg(RESOURCES_PATH "/EchoPcpConfigTest/ERP.cfg", cfgFilePath));
+
+        QFile fBase(RESOURCES_PATH "/EchoPcpConfigTest/ERP.cfg");
+        REQUIRE(fBase.open(QIODevice::ReadOnly));
+        QFile fActual(cfgFilePath);
+        REQUIRE(fActual.open(QIODevice::ReadOnly));
+        // Except for the XML declaration, which always says UTF-8.
+        CHECK(fBase.readAll().replace(R"(encoding="utf-8")", R"(encoding="UTF-8")") == fActual.readAll());
+    }
+}
+
+TEST_CASE("Echo PCP Config parsed in pieces")
+{
+    const auto threadCount = GENERATE(2u, 4u);
+    CAPTURE(threadCount);
+    EchoPcpConfig config;
+    config.setParseOptions({.engine = ParseEngine::Mapped, .threadCount = threadCount});
+    QTemporaryDir testDir;
+    QFile fBase(RESOURCES_PATH "/EchoPcpConfigTest/ERP.cfg");
+    REQUIRE(fBase.open(QIODevice::ReadOnly));
+    auto data = fBase.readAll();
+    const auto writeCfg = [&testDir](const QByteArray& contents)
+    {
+        const auto path = testDir.filePath("erp.cfg");
+        QFile f(path);
+        REQUIRE(f.open(QIODevice::WriteOnly));
+        REQUIRE(f.write(contents) == contents.size());
+        return path;
+    };
+
+    SECTION("Parse Cfg")
+    {
+        REQUIRE_NOTHROW(config.parseCfg(RESOURCES_PATH "/EchoPcpConfigTest/ERP.cfg"));
+        CHECK_THAT(config.circuits(), RangeEquals(kExpectedCircuits));
+        CHECK_THAT(config.presets(), RangeEquals(kExpectedPresets));
+    }
+
+    SECTION("Write Cfg preserves formatting")
+    {
+        REQUIRE_NOTHROW(config.parseCfg(RESOURCES_PATH "/EchoPcpConfigTest/ERP.cfg"));
+        REQUIRE_NOTHROW(config.parseSheet(RESOURCES_PATH "/EchoPcpConfigTest/ERP_changed.xlsx"));
+        const auto cfgFilePath = testDir.filePath("erp_changed.cfg");
+        REQUIRE_NOTHROW(config.saveCfg(RESOURCES_PATH "/EchoPcpConfigTest/ERP.cfg", cfgFilePath));
+
+        QFile fExpected(RESOURCES_PATH "/EchoPcpConfigTest/ERP_changed.cfg");
+        REQUIRE(fExpected.open(QIODevice::ReadOnly));
+        QFile fActual(cfgFilePath);
+        REQUIRE(fActual.open(QIODevice::ReadOnly));
+        CHECK(fExpected.readAll() == fActual.readAll());
+    }
+
+    SECTION("Preset tags in comments")
+    {
+        // Pieces are split at PRESET tags found in the bytes, which may be commented out.
+        data.replace("\n<PRESET ", "\n<!-- <PRESET NUMBER=\"99\"/> -->\n<PRESET ");
+        REQUIRE_NOTHROW(config.parseCfg(writeCfg(data)));
+        CHECK_THAT(config.presets(), RangeEquals(kExpectedPresets));
+    }
+
+    SECTION("Bad level in last preset")
+    {
+        const auto levelPos = data.indexOf(" LEVEL=\"", data.lastIndexOf("<PRELEVEL "));
+        REQUIRE(levelPos > 0);
+        data.insert(levelPos + 8, '3');
+        CHECK_THROWS_WITH(config.parseCfg(writeCfg(data)), "Bad level.");
+    }
+
+    SECTION("Huge circuit number")
+    {
+        // Would otherwise make room for every circuit below it.
+        data.replace("<PRELEVEL RELAY=\"3\"", "<PRELEVEL RELAY=\"4294967295\"");
+        CHECK_THROWS_WITH(config.parseCfg(writeCfg(data)), "Bad circuit number.");
+    }
+}
+
+TEST_CASE("Echo PCP Config read in blocks")
+{
+    // Large enough to be read and written a block at a time.
+    const FixtureGenerator generator({
+        .dialect = FixtureGenerator::Dialect::Pcp,
+        .circuitCount = 1000,
+        .spaceCount = 40,
+        .presetCount = 48,
+        .sequenceCount = 2,
+        .seed = 1234,
+    });
+    QTemporaryDir testDir;
+    const auto cfgPath = testDir.filePath("generated.cfg");
+    generator.saveCfg(cfgPath);
+    const auto cfgSize = QFileInfo(cfgPath).size();
+    REQUIRE(cfgSize > 2 * ReadAhead::Options().blockSize);
+
+    EchoPcpConfig expected;
+    expected.setParseOptions({.engine = ParseEngine::Mapped});
+    REQUIRE_NOTHROW(expected.parseCfg(cfgPath));
+
+    const auto retainBase = GENERATE(false, true);
+    CAPTURE(retainBase);
+    IoStats readStats;
+    EchoPcpConfig config;
+    config.setParseOptions({.engine = ParseEngine::Stream, .retainBase = retainBase, .ioStats = &readStats});
+    REQUIRE_NOTHROW(config.parseCfg(cfgPath));
+    CHECK_THAT(config.circuits(), RangeEquals(expected.circuits()));
+    CHECK_THAT(config.presets(), RangeEquals(expected.presets()));
+    CHECK(readStats.bytes == cfgSize);
+    CHECK(readStats.waitFraction() >= 0.0);
+    CHECK(readStats.waitFraction() <= 1.0);
+
+    IoStats writeStats;
+    config.setSaveOptions({.ioStats = &writeStats});
+    const auto outPath = testDir.filePath("out.cfg");
+    REQUIRE_NOTHROW(config.saveCfg(cfgPath, outPath));
+    CHECK(writeStats.bytes == QFileInfo(outPath).size());
+    CHECK(writeStats.waitFraction() <= 1.0);
+    const auto expectedPath = testDir.filePath("expected.cfg");
+    REQUIRE_NOTHROW(expected.saveCfg(cfgPath, expectedPath));
+    QFile fExpected(expectedPath);
+    REQUIRE(fExpected.open(QIODevice::ReadOnly));
+    QFile fActual(outPath);
+    REQUIRE(fActual.open(QIODevice::ReadOnly));
+    CHECK(fExpected.readAll() == fActual.readAll());
 }
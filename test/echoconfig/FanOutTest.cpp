@@ -0,0 +1,152 @@
+/**
+ * @file FanOutTest.cpp
+ *
+ * @author Dan Keenan
+ * @date 10/17/2026
+ * @copyright GNU GPLv3
+ */
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <catch2/matchers/catch_matchers_range_equals.hpp>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "echoconfig/FanOut.h"
+#include "file_helpers.h"
+#include "qstring_tostring.h"
+
+using namespace echoconfig;
+using Catch::Matchers::RangeEquals;
+
+TEST_CASE("Fan Out")
+{
+    const auto [basePath, changedSheetPath, changedCfgPath] = GENERATE(
+        std::make_tuple(QStringLiteral(RESOURCES_PATH "/EchoPcpConfigTest/ERP.cfg"),
+                        QStringLiteral(RESOURCES_PATH "/EchoPcpConfigTest/ERP_changed.xlsx"),
+                        QStringLiteral(RESOURCES_PATH "/EchoPcpConfigTest/ERP_changed.cfg")),
+        std::make_tuple(QStringLiteral(RESOURCES_PATH "/EchoAcpConfigTest/EACP.eacp"),
+                        QStringLiteral(RESOURCES_PATH "/EchoAcpConfigTest/EACP_changed.xlsx"),
+                        QStringLiteral(RESOURCES_PATH "/EchoAcpConfigTest/EACP_changed.eacp")));
+    CAPTURE(basePath);
+    QTemporaryDir testDir;
+
+    const FanOut fanOut(basePath);
+    REQUIRE(fanOut.basePath() == basePath);
+
+    // One rack with the changed values, one with the base's own values.
+    const auto changed = fanOut.base().clone();
+    REQUIRE_NOTHROW(changed->parseSheet(changedSheetPath));
+    const std::vector<std::pair<QString, const Config*>> racks{
+        {QStringLiteral("North"), changed.get()},
+        {QStringLiteral("South"), &fanOut.base()},
+    };
+    const auto workbookPath = testDir.filePath("racks.xlsx");
+    REQUIRE_NOTHROW(FanOut::saveWorkbook(workbookPath, racks));
+
+    const auto outDir = testDir.filePath("out");
+    REQUIRE(QDir().mkpath(outDir));
+    const auto threadCount = GENERATE(1u, 2u);
+    CAPTURE(threadCount);
+    const auto report = fanOut.run(workbookPath, outDir, {.threadCount = threadCount});
+
+    CHECK(report.threadCount == threadCount);
+    CHECK(report.failedCount() == 0);
+    REQUIRE(report.results.size() == 2);
+    const auto suffix = QFileInfo(basePath).suffix();
+    for (std::size_t ix = 0; ix < racks.size(); ++ix)
+    {
+        const auto& result = report.results[ix];
+        CAPTURE(result.rack, result.error);
+        CHECK(result.ok);
+        CHECK(result.rack == racks[ix].first);
+        CHECK(result.outPath == QDir(outDir).filePath(racks[ix].first + u'.' + suffix));
+    }
+
+    // Same as saving each rack by itself.
+    CHECK(readFile(report.results[0].outPath) == readFile(changedCfgPath));
+    const auto baseOutPath = testDir.filePath(QStringLiteral("base.") + suffix);
+    REQUIRE_NOTHROW(fanOut.base().saveCfg(basePath, baseOutPath));
+    CHECK(readFile(report.results[1].outPath) == readFile(baseOutPath));
+
+    // The base isn't changed by the racks made from it.
+    const auto reparsed = Config::loadCfg(basePath);
+    REQUIRE(reparsed != nullptr);
+    CHECK_THAT(fanOut.base().presets(), RangeEquals(reparsed->presets()));
+}
+
+TEST_CASE("Fan Out Errors")
+{
+    QTemporaryDir testDir;
+    const auto basePath = QStringLiteral(RESOURCES_PATH "/EchoPcpConfigTest/ERP.cfg");
+
+    SECTION("Missing base")
+    {
+        CHECK_THROWS(FanOut(testDir.filePath("does_not_exist.cfg")));
+    }
+
+    SECTION("Failed rack")
+    {
+        const FanOut fanOut(basePath);
+        const std::vector<std::pair<QString, const Config*>> racks{
+            {QStringLiteral("North"), &fanOut.base()},
+        };
+        const auto workbookPath = testDir.filePath("racks.xlsx");
+        REQUIRE_NOTHROW(FanOut::saveWorkbook(workbookPath, racks));
+
+        // Failures are reported per rack rather than thrown.
+        const auto report = fanOut.run(workbookPath, testDir.filePath("does_not_exist"));
+        REQUIRE(report.results.size() == 1);
+        CHECK_FALSE(report.results[0].ok);
+        CHECK_FALSE(report.results[0].error.isEmpty());
+        CHECK(report.failedCount() == 1);
+    }
+
+    SECTION("Unsafe rack names")
+    {
+        const FanOut fanOut(basePath);
+        const std::vector<std::pair<QString, const Config*>> racks{
+            {QStringLiteral("North"), &fanOut.base()},
+            {QStringLiteral("../Escaped"), &fanOut.base()},
+            {QStringLiteral("a\\b"), &fanOut.base()},
+            {QStringLiteral("north"), &fanOut.base()},
+            {QStringLiteral("South (2)"), &fanOut.base()},
+            {QStringLiteral("West|East"), &fanOut.base()},
+            {QStringLiteral("Trailing."), &fanOut.base()},
+            {QStringLiteral("con"), &fanOut.base()},
+        };
+        const auto workbookPath = testDir.filePath("racks.xlsx");
+        REQUIRE_NOTHROW(FanOut::saveWorkbook(workbookPath, racks));
+        const auto outDir = testDir.filePath("out");
+        REQUIRE(QDir().mkpath(outDir));
+
+        const auto report = fanOut.run(workbookPath, outDir);
+        REQUIRE(report.results.size() == racks.size());
+        CHECK(report.results[0].ok);
+        CHECK_FALSE(report.results[1].ok);
+        CHECK_FALSE(report.results[2].ok);
+        // Would replace North's file where names ignore case.
+        CHECK_FALSE(report.results[3].ok);
+        CHECK(report.results[4].ok);
+        // Not allowed in names on Windows.
+        CHECK_FALSE(report.results[5].ok);
+        CHECK_FALSE(report.results[6].ok);
+        CHECK_FALSE(report.results[7].ok);
+        CHECK(report.failedCount() == 6);
+        CHECK_FALSE(QFileInfo::exists(testDir.filePath("Escaped.cfg")));
+        CHECK(QDir(outDir).entryList(QDir::Files) ==
+              QStringList{QStringLiteral("North.cfg"), QStringLiteral("South (2).cfg")});
+    }
+
+    SECTION("Not a fan-out workbook")
+    {
+        const FanOut fanOut(basePath);
+        // An ordinary sheet has no racks.
+        const auto report = fanOut.run(RESOURCES_PATH "/EchoPcpConfigTest/ERP.xlsx", testDir.path());
+        CHECK(report.results.empty());
+    }
+}
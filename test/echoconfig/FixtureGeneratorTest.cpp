@@ -0,0 +1,88 @@
+/**
+ * @file FixtureGeneratorTest.cpp
+ *
+ * @author Dan Keenan
+ * @date 10/17/2026
+ * @copyright GNU GPLv3
+ */
+
+#include <QTemporaryDir>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include "echoconfig/EchoAcpConfig.h"
+#include "echoconfig/EchoPcpConfig.h"
+#include "echoconfig/FixtureGenerator.h"
+#include "qstring_tostring.h"
+
+using namespace echoconfig;
+
+TEST_CASE("Fixture Generator")
+{
+    const auto dialect = GENERATE(FixtureGenerator::Dialect::Pcp, FixtureGenerator::Dialect::Acp);
+    const FixtureGenerator generator({
+        .dialect = dialect,
+        .circuitCount = 600,
+        .spaceCount = 20,
+        .presetCount = 10,
+        .sequenceCount = 2,
+        .seed = 1234,
+    });
+    QTemporaryDir testDir;
+    const auto cfgPath = testDir.filePath(QStringLiteral("generated.%1").arg(generator.cfgSuffix()));
+    generator.saveCfg(cfgPath);
+
+    SECTION("Deterministic")
+    {
+        CHECK(generator.generateCfg() == generator.generateCfg());
+        auto options = generator.options();
+        ++options.seed;
+        CHECK(FixtureGenerator(options).generateCfg() != generator.generateCfg());
+    }
+
+    SECTION("Parse Cfg")
+    {
+        const auto config = Config::loadCfg(cfgPath);
+        REQUIRE(config != nullptr);
+        if (dialect == FixtureGenerator::Dialect::Acp)
+        {
+            CHECK(dynamic_cast<const EchoAcpConfig*>(config.get()) != nullptr);
+        }
+        else
+        {
+            CHECK(dynamic_cast<const EchoAcpConfig*>(config.get()) == nullptr);
+        }
+        CHECK(config->panelName() == QStringLiteral("Rack"));
+        CHECK(config->circuitCount() == 600);
+        CHECK(config->spaceCount() == 20);
+        CHECK(config->presetCount() == 10);
+        for (const auto& preset : config->presets())
+        {
+            CHECK(preset.levels.size() == 600);
+            CHECK(preset.fadeTimes.size() == 20);
+        }
+    }
+
+    SECTION("Sheet round trip")
+    {
+        const auto sheetPath = testDir.filePath(QStringLiteral("generated.xlsx"));
+        generator.saveSheet(sheetPath);
+        const auto expected = generator.createConfig();
+        expected->parseCfg(cfgPath);
+        const auto actual = generator.createConfig();
+        actual->parseSheet(sheetPath);
+        REQUIRE(actual->presetCount() == expected->presetCount());
+        for (unsigned int ix = 0; ix < expected->presetCount(); ++ix)
+        {
+            CHECK(actual->getPresetAt(ix) == expected->getPresetAt(ix));
+        }
+    }
+
+    SECTION("Bad options")
+    {
+        auto options = generator.options();
+        options.spaceCount = 0;
+        CHECK_THROWS_AS(FixtureGenerator(options), std::runtime_error);
+        options.spaceCount = options.circuitCount + 1;
+        CHECK_THROWS_AS(FixtureGenerator(options), std::runtime_error);
+    }
+}
@@ -0,0 +1,124 @@
+/**
+ * @file StructuralIndexTest.cpp
+ *
+ * @author Dan Keenan
+ * @date 10/17/2026
+ * @copyright GNU GPLv3
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include "echoconfig/StructuralIndex.h"
+
+using namespace echoconfig;
+using Isa = StructuralIndex::Isa;
+using Mark = StructuralIndex::Mark;
+
+namespace
+{
+    /** Markup-heavy bytes, so every vector lane sees each kind of mark. */
+    std::string randomMarkup(std::size_t size, unsigned int seed)
+    {
+        static constexpr std::string_view kAlphabet = "<>/=\"' aZ9\n\t\xC3\xA9";
+        std::mt19937 rng(seed);
+        std::string data(size, ' ');
+        for (auto& c : data)
+        {
+            c = kAlphabet[rng() % kAlphabet.size()];
+        }
+        return data;
+    }
+} // namespace
+
+TEST_CASE("Structural Index")
+{
+    const auto isa = GENERATE(Isa::Scalar, Isa::Sse2, Isa::Avx2);
+    CAPTURE(isa);
+    if (!StructuralIndex::isSupported(isa))
+    {
+        CHECK_THROWS_AS(StructuralIndex("<A/>", 0, 4, isa), std::runtime_error);
+        return;
+    }
+
+    SECTION("Marks")
+    {
+        const std::string data = R"(<A X="1" Y='a"b'/>)";
+        const StructuralIndex index(data, 0, data.size(), isa);
+        CHECK(index.find(Mark::Tag, 0) == 0);
+        CHECK(index.find(Mark::Tag, 1) == std::string_view::npos);
+        CHECK(index.find(Mark::Quote, 0) == 5);
+        CHECK(index.find(Mark::Quote, 8) == 11);
+        CHECK(index.find(Mark::Quote, 12) == 13);
+        CHECK(index.count(Mark::Quote) == 5);
+        CHECK(index.count(Mark::Tag) == 1);
+    }
+
+    SECTION("Same as searching")
+    {
+        // Sizes on and around vector and word boundaries.
+        const auto size = GENERATE(std::size_t{0}, std::size_t{1}, std::size_t{15}, std::size_t{16}, std::size_t{31},
+                                   std::size_t{32}, std::size_t{63}, std::size_t{64}, std::size_t{65}, std::size_t{200},
+                                   std::size_t{1000});
+        const auto begin = GENERATE(std::size_t{0}, std::size_t{1}, std::size_t{17});
+        CAPTURE(size, begin);
+        const auto data = randomMarkup(size + begin + 8, static_cast<unsigned int>(size));
+        const auto end = begin + size;
+        const StructuralIndex index(data, begin, end, isa);
+
+        // Marks past end aren't indexed.
+        const std::string_view range(data.data(), end);
+        std::size_t tagCount = 0;
+        for (auto pos = begin; pos <= end; ++pos)
+        {
+            CAPTURE(pos);
+            CHECK(index.find(Mark::Tag, pos) == range.find('<', pos));
+            CHECK(index.find(Mark::Quote, pos) == range.find_first_of("\"'", pos));
+            if (pos < end && range[pos] == '<')
+            {
+                ++tagCount;
+            }
+        }
+        CHECK(index.find(Mark::Tag, end + 1) == std::string_view::npos);
+        CHECK(index.count(Mark::Tag) == tagCount);
+    }
+}
+
+TEST_CASE("Structural Index dispatch")
+{
+    CHECK(StructuralIndex::isSupported(Isa::Scalar));
+    const auto best = StructuralIndex::bestIsa();
+    CAPTURE(best);
+    CHECK(StructuralIndex::isSupported(best));
+    // The fastest supported instruction set is picked.
+    if (StructuralIndex::isSupported(Isa::Avx2))
+    {
+        CHECK(best == Isa::Avx2);
+    }
+    else if (StructuralIndex::isSupported(Isa::Sse2))
+    {
+        CHECK(best == Isa::Sse2);
+    }
+    else
+    {
+        CHECK(best == Isa::Scalar);
+    }
+
+    // What the default constructor builds matches the scalar index.
+    const auto data = randomMarkup(4096, 1234);
+    const StructuralIndex dispatched(data, 0, data.size());
+    const StructuralIndex scalar(data, 0, data.size(), Isa::Scalar);
+    for (const auto mark : {Mark::Tag, Mark::Quote})
+    {
+        CHECK(dispatched.count(mark) == scalar.count(mark));
+        for (std::size_t pos = 0; pos < data.size(); ++pos)
+        {
+            if (dispatched.find(mark, pos) != scalar.find(mark, pos))
+            {
+                FAIL("Dispatched index differs at " << pos);
+            }
+        }
+    }
+}
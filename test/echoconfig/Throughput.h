@@ -0,0 +1,129 @@
+/**
+ * @file Throughput.h
+ *
+ * @author Dan Keenan
+ * @date 10/17/2026
+ * @copyright GNU GPLv3
+ */
+
+#ifndef THROUGHPUT_H
+#define THROUGHPUT_H
+
+#include <QByteArray>
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <utility>
+
+#ifdef PLATFORM_WINDOWS
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+// Must come after windows.h
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+/**
+ * Peak resident set size of this process, in bytes.
+ */
+inline std::size_t peakRssBytes()
+{
+#ifdef PLATFORM_WINDOWS
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    {
+        return 0;
+    }
+    return counters.PeakWorkingSetSize;
+#else
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+    {
+        return 0;
+    }
+#ifdef PLATFORM_DARWIN
+    // Already in bytes.
+    return static_cast<std::size_t>(usage.ru_maxrss);
+#else
+    // In kilobytes.
+    return static_cast<std::size_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+/**
+ * Count the elements in an XML document.
+ */
+inline std::size_t countXmlElements(const QByteArray& xml)
+{
+    return xml.count('<') - xml.count("</") - xml.count("<?") - xml.count("<!");
+}
+
+/**
+ * Accumulates the time spent in every run of a benchmark so throughput can be reported afterward.
+ *
+ * Usage:
+ * @code
+ * Throughput throughput("parse", fileSize, elementCount);
+ * BENCHMARK("parse") { return throughput.measure([&] { return parse(); }); };
+ * throughput.report();
+ * @endcode
+ */
+class Throughput
+{
+public:
+    /**
+     * @param name Name to report.
+     * @param bytes Bytes processed by each run.
+     * @param elements Elements (XML elements, sheet cells, ...) processed by each run.
+     */
+    Throughput(std::string name, std::size_t bytes, std::size_t elements) :
+        name_(std::move(name)), bytes_(bytes), elements_(elements)
+    {}
+
+    template <typename Fn>
+    decltype(auto) measure(Fn&& fn)
+    {
+        const auto start = Clock::now();
+        struct Stop
+        {
+            Throughput* throughput;
+            Clock::time_point start;
+            ~Stop()
+            {
+                throughput->elapsed_ += Clock::now() - start;
+                ++throughput->runs_;
+            }
+        } stop{this, start};
+        return fn();
+    }
+
+    void report() const
+    {
+        const auto seconds = std::chrono::duration<double>(elapsed_).count();
+        if (runs_ == 0 || seconds <= 0)
+        {
+            return;
+        }
+        const auto runs = static_cast<double>(runs_);
+        std::cout << std::fixed << std::setprecision(1) << name_ << ": " << (elements_ * runs / seconds)
+                  << " elements/s, " << (bytes_ * runs / seconds / 1e6) << " MB/s, peak RSS "
+                  << (peakRssBytes() / 1e6) << " MB (" << runs_ << " runs)\n";
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    std::string name_;
+    std::size_t bytes_;
+    std::size_t elements_;
+    Clock::duration elapsed_{};
+    std::size_t runs_ = 0;
+};
+
+#endif // THROUGHPUT_H
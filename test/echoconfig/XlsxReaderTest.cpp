@@ -0,0 +1,143 @@
+/**
+ * @file XlsxReaderTest.cpp
+ *
+ * @author Dan Keenan
+ * @date 10/17/2026
+ * @copyright GNU GPLv3
+ */
+
+#include <QBuffer>
+#include <QFile>
+#include <catch2/catch_test_macros.hpp>
+#include "echoconfig/XlsxReader.h"
+#include "echoconfig/XlsxWriter.h"
+#include "echoconfig/sheet_helpers.h"
+#include "echoconfig/thread_helpers.h"
+#include "qstring_tostring.h"
+
+using namespace echoconfig;
+
+TEST_CASE("Xlsx Reader")
+{
+    SECTION("Excel workbook")
+    {
+        QFile f(RESOURCES_PATH "/EchoPcpConfigTest/ERP_changed.xlsx");
+        REQUIRE(f.open(QIODevice::ReadOnly));
+        const XlsxReader workbook(&f);
+        CHECK(workbook.sheetNames() == QStringList{QStringLiteral("Levels"), QStringLiteral("Times")});
+
+        XlsxSheetReader sheet(workbook, QStringLiteral("Levels"));
+        REQUIRE(sheet.readRow());
+        CHECK(sheet.rowNum() == 1);
+        CHECK(sheet_helpers::cellText(sheet.cell(1)) == QStringLiteral("Circuit"));
+        CHECK(sheet_helpers::cellText(sheet.cell(4)) == QStringLiteral("Preset 1"));
+        REQUIRE(sheet.readRow());
+        CHECK(sheet.rowNum() == 2);
+        CHECK(sheet_helpers::requiredCellUInt(sheet.cell(1)) == 1);
+        CHECK(sheet_helpers::requiredCellUInt(sheet.cell(2)) == 2);
+        CHECK(sheet_helpers::requiredCellUInt(sheet.cell(4)) == 255);
+        CHECK(sheet.cell(1000) == nullptr);
+        int rowCount = 2;
+        while (sheet.readRow())
+        {
+            ++rowCount;
+        }
+        CHECK(rowCount == 49);
+
+        CHECK_THROWS_AS(XlsxSheetReader(workbook, QStringLiteral("Missing")), std::runtime_error);
+    }
+
+    SECTION("Sheets on other threads")
+    {
+        QFile f(RESOURCES_PATH "/EchoPcpConfigTest/ERP_changed.xlsx");
+        REQUIRE(f.open(QIODevice::ReadOnly));
+        const XlsxReader workbook(&f);
+        const auto countRows = [&workbook](const QString& name)
+        {
+            XlsxSheetReader sheet(workbook, name);
+            int rowCount = 0;
+            while (sheet.readRow())
+            {
+                ++rowCount;
+            }
+            return rowCount;
+        };
+        int levelsRows = 0;
+        int timesRows = 0;
+        thread_helpers::parallelInvoke([&]() { timesRows = countRows(QStringLiteral("Times")); },
+                                       [&]() { levelsRows = countRows(QStringLiteral("Levels")); });
+        CHECK(levelsRows == 49);
+        CHECK(timesRows == countRows(QStringLiteral("Times")));
+    }
+
+    // Write a sheet, then mess with it.
+    QBuffer buffer;
+    REQUIRE(buffer.open(QIODevice::WriteOnly));
+    {
+        constexpr auto kRowCount = 5000;
+        XlsxWriter writer(&buffer);
+        auto& sheet = writer.addSheet(QStringLiteral("Sheet"), kRowCount + 1, 3);
+        sheet.beginRow();
+        sheet.writeString(1, QStringLiteral("Number"));
+        sheet.writeString(3, QStringLiteral("12"));
+        sheet.endRow();
+        for (unsigned int row = 1; row <= kRowCount; ++row)
+        {
+            sheet.beginRow();
+            sheet.writeNumber(1, row);
+            sheet.writeNumber(2, row * 7 % 256);
+            sheet.endRow();
+        }
+        writer.finish();
+    }
+    buffer.close();
+
+    SECTION("Read back")
+    {
+        REQUIRE(buffer.open(QIODevice::ReadOnly));
+        const XlsxReader workbook(&buffer);
+        XlsxSheetReader sheet(workbook, QStringLiteral("Sheet"));
+        REQUIRE(sheet.readRow());
+        CHECK(sheet.cells().size() == 2);
+        CHECK(sheet.cell(2) == nullptr);
+        CHECK_THROWS_AS(sheet_helpers::requiredCellUInt(sheet.cell(2)), std::runtime_error);
+        CHECK_THROWS_AS(sheet_helpers::requiredCellUInt(sheet.cell(1)), std::runtime_error);
+        // Numbers stored as text are still numbers.
+        CHECK(sheet_helpers::requiredCellUInt(sheet.cell(3)) == 12);
+        unsigned int expected = 1;
+        while (sheet.readRow())
+        {
+            CHECK(sheet.rowNum() == expected + 1);
+            CHECK(sheet_helpers::requiredCellUInt(sheet.cell(1)) == expected);
+            CHECK(sheet_helpers::requiredCellUInt(sheet.cell(2)) == expected * 7 % 256);
+            ++expected;
+        }
+        CHECK(expected == 5001);
+    }
+
+    SECTION("Corrupt data")
+    {
+        // The sheet is the first file in the archive, so this lands in its compressed data.
+        auto data = buffer.data();
+        data[200] = static_cast<char>(data[200] ^ 0xFF);
+        QBuffer corrupt(&data);
+        REQUIRE(corrupt.open(QIODevice::ReadOnly));
+        const XlsxReader workbook(&corrupt);
+        XlsxSheetReader sheet(workbook, QStringLiteral("Sheet"));
+        CHECK_THROWS_AS(
+            [&sheet]()
+            {
+                while (sheet.readRow())
+                {
+                }
+            }(),
+            std::runtime_error);
+    }
+
+    SECTION("Not a workbook")
+    {
+        QFile f(RESOURCES_PATH "/EchoPcpConfigTest/ERP.cfg");
+        REQUIRE(f.open(QIODevice::ReadOnly));
+        CHECK_THROWS_AS(XlsxReader(&f), std::runtime_error);
+    }
+}
@@ -0,0 +1,186 @@
+/**
+ * @file XlsxWriterTest.cpp
+ *
+ * @author Dan Keenan
+ * @date 10/17/2026
+ * @copyright GNU GPLv3
+ */
+
+#include <QBuffer>
+#include <QByteArrayList>
+#include <utility>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <xlsxdocument.h>
+#include "echoconfig/XlsxWriter.h"
+#include "echoconfig/ZipReader.h"
+#include "echoconfig/thread_helpers.h"
+#include "qbytearray_tostring.h"
+#include "qstring_tostring.h"
+
+using namespace echoconfig;
+
+TEST_CASE("Xlsx Writer")
+{
+    SECTION("Column names")
+    {
+        CHECK(XlsxWriter::columnName(1) == "A");
+        CHECK(XlsxWriter::columnName(26) == "Z");
+        CHECK(XlsxWriter::columnName(27) == "AA");
+        CHECK(XlsxWriter::columnName(67) == "BO");
+        CHECK(XlsxWriter::columnName(703) == "AAA");
+    }
+
+    SECTION("Read back")
+    {
+        constexpr auto kRowCount = 5000;
+        QBuffer buffer;
+        REQUIRE(buffer.open(QIODevice::WriteOnly));
+        XlsxWriter writer(&buffer);
+        auto& first = writer.addSheet(QStringLiteral("First"), kRowCount + 1, 4);
+        // Added while First is open, so it is compressed separately.
+        auto& second = writer.addSheet(QStringLiteral("Second"), 1, 1);
+        first.beginRow();
+        first.writeString(1, QStringLiteral("Number"));
+        first.writeString(4, QStringLiteral(" <Needs> & escaping "));
+        first.endRow();
+        second.beginRow();
+        second.writeString(1, QStringLiteral("Number"));
+        second.endRow();
+        second.end();
+        for (unsigned int row = 1; row <= kRowCount; ++row)
+        {
+            first.beginRow();
+            first.writeNumber(1, row);
+            first.writeNumber(4, row % 256);
+            first.endRow();
+        }
+        first.end();
+        auto& third = writer.addSheet(QStringLiteral("Third"), 1, 1);
+        third.beginRow();
+        third.writeNumber(1, 3);
+        third.endRow();
+        // Ended by finish().
+        writer.finish();
+        buffer.close();
+
+        REQUIRE(buffer.open(QIODevice::ReadOnly));
+        QXlsx::Document doc(&buffer);
+        REQUIRE(doc.isLoadPackage());
+        CHECK(doc.sheetNames() ==
+              QStringList{QStringLiteral("First"), QStringLiteral("Second"), QStringLiteral("Third")});
+
+        REQUIRE(doc.selectSheet(QStringLiteral("First")));
+        CHECK(doc.dimension().rowCount() == kRowCount + 1);
+        CHECK(doc.dimension().columnCount() == 4);
+        CHECK(doc.read(1, 1).toString() == QStringLiteral("Number"));
+        CHECK(!doc.read(1, 2).isValid());
+        CHECK(doc.read(1, 4).toString() == QStringLiteral(" <Needs> & escaping "));
+        CHECK(doc.read(2, 1).toUInt() == 1);
+        CHECK(doc.read(kRowCount + 1, 1).toUInt() == kRowCount);
+        CHECK(doc.read(kRowCount + 1, 4).toUInt() == kRowCount % 256);
+
+        REQUIRE(doc.selectSheet(QStringLiteral("Second")));
+        CHECK(doc.read(1, 1).toString() == QStringLiteral("Number"));
+
+        REQUIRE(doc.selectSheet(QStringLiteral("Third")));
+        CHECK(doc.read(1, 1).toUInt() == 3);
+    }
+
+    SECTION("Sheets on other threads")
+    {
+        constexpr auto kRowCount = 20000;
+        const auto writeWorkbook = []()
+        {
+            QBuffer buffer;
+            buffer.open(QIODevice::WriteOnly);
+            XlsxWriter writer(&buffer);
+            auto& first = writer.addSheet(QStringLiteral("First"), kRowCount, 2);
+            auto& second = writer.addSheet(QStringLiteral("Second"), kRowCount, 2);
+            const auto writeRows = [](XlsxSheetWriter& sheet, unsigned int factor)
+            {
+                for (unsigned int row = 1; row <= kRowCount; ++row)
+                {
+                    sheet.beginRow();
+                    sheet.writeNumber(1, row);
+                    sheet.writeNumber(2, row * factor);
+                    sheet.endRow();
+                }
+                sheet.end();
+            };
+            thread_helpers::parallelInvoke([&]() { writeRows(second, 3); }, [&]() { writeRows(first, 2); });
+            writer.finish();
+            return buffer.data();
+        };
+        const auto data = writeWorkbook();
+        // No strings are written on other threads, so the sheets are the same every time.  The whole file isn't, as
+        // it is stamped with the time it was written.
+        const auto partsOf = [](QByteArray workbook)
+        {
+            QBuffer buffer(&workbook);
+            buffer.open(QIODevice::ReadOnly);
+            const ZipReader zip(&buffer);
+            return QByteArrayList{
+                zip.read(QStringLiteral("xl/worksheets/sheet1.xml")),
+                zip.read(QStringLiteral("xl/worksheets/sheet2.xml")),
+                zip.read(QStringLiteral("xl/sharedStrings.xml")),
+            };
+        };
+        CHECK(partsOf(writeWorkbook()) == partsOf(data));
+
+        QBuffer buffer;
+        buffer.setData(data);
+        REQUIRE(buffer.open(QIODevice::ReadOnly));
+        QXlsx::Document doc(&buffer);
+        REQUIRE(doc.isLoadPackage());
+        REQUIRE(doc.selectSheet(QStringLiteral("First")));
+        CHECK(doc.read(kRowCount, 2).toUInt() == kRowCount * 2);
+        REQUIRE(doc.selectSheet(QStringLiteral("Second")));
+        CHECK(doc.read(kRowCount, 2).toUInt() == kRowCount * 3);
+    }
+}
+
+TEST_CASE("Xlsx Writer compression")
+{
+    // Enough for the sheet to span many parallel blocks.
+    constexpr unsigned int kRowCount = 50000;
+    const auto [level, parallel] =
+        GENERATE(std::pair{CompressionLevel::Store, false}, std::pair{CompressionLevel::Fast, false},
+                 std::pair{CompressionLevel::Default, false}, std::pair{CompressionLevel::Fast, true},
+                 std::pair{CompressionLevel::Default, true});
+    CAPTURE(level, parallel);
+
+    QBuffer buffer;
+    REQUIRE(buffer.open(QIODevice::WriteOnly));
+    {
+        XlsxWriter writer(&buffer, {.level = level, .parallel = parallel});
+        auto& first = writer.addSheet(QStringLiteral("First"), kRowCount, 2);
+        // Compressed separately, as First is open.
+        auto& second = writer.addSheet(QStringLiteral("Second"), kRowCount, 1);
+        for (unsigned int row = 1; row <= kRowCount; ++row)
+        {
+            first.beginRow();
+            first.writeNumber(1, row);
+            first.writeNumber(2, row * row % 1000);
+            first.endRow();
+            second.beginRow();
+            second.writeNumber(1, row * 3);
+            second.endRow();
+        }
+        writer.finish();
+    }
+    buffer.close();
+
+    REQUIRE(buffer.open(QIODevice::ReadOnly));
+    QXlsx::Document doc(&buffer);
+    REQUIRE(doc.isLoadPackage());
+    REQUIRE(doc.selectSheet(QStringLiteral("First")));
+    for (unsigned int row = 1; row <= kRowCount; row += 997)
+    {
+        CHECK(doc.read(row, 1).toUInt() == row);
+        CHECK(doc.read(row, 2).toUInt() == row * row % 1000);
+    }
+    CHECK(doc.read(kRowCount, 2).toUInt() == kRowCount * kRowCount % 1000);
+    REQUIRE(doc.selectSheet(QStringLiteral("Second")));
+    CHECK(doc.read(kRowCount, 1).toUInt() == kRowCount * 3);
+}
@@ -0,0 +1,151 @@
+/**
+ * @file XmlScannerTest.cpp
+ *
+ * @author Dan Keenan
+ * @date 10/17/2026
+ * @copyright GNU GPLv3
+ */
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <memory>
+#include <string>
+#include "echoconfig/XmlScanner.h"
+#include "qstring_tostring.h"
+
+using namespace echoconfig;
+
+static void scanAll(std::string_view data)
+{
+    XmlScanner scanner(data);
+    while (scanner.readNextStartElement())
+    {
+    }
+}
+
+TEST_CASE("XML Scanner")
+{
+    SECTION("Elements and attributes")
+    {
+        const std::string data = R"(<?xml version="1.0" encoding="utf-8"?>
+<!-- Comment -->
+<ROOT>
+<RACK VERSION="3.1.X" NAME='Rack &amp; Roll'/>
+<PRELEVEL RELAY="12" LEVEL=" 255 "></PRELEVEL>
+</ROOT>
+)";
+        REQUIRE(XmlScanner::isUtf8Document(data));
+        XmlScanner scanner(data);
+
+        REQUIRE(scanner.readNextStartElement());
+        CHECK(scanner.name() == "ROOT");
+        CHECK(scanner.attributes().empty());
+
+        REQUIRE(scanner.readNextStartElement());
+        CHECK(scanner.name() == "RACK");
+        CHECK(scanner.attribute("VERSION") == QStringLiteral("3.1.X"));
+        CHECK(scanner.attribute("NAME") == QStringLiteral("Rack & Roll"));
+        CHECK(scanner.attribute("MISSING").isEmpty());
+
+        REQUIRE(scanner.readNextStartElement());
+        CHECK(scanner.name() == "PRELEVEL");
+        CHECK(scanner.requiredAttrUInt("RELAY") == 12);
+        CHECK(scanner.requiredAttrUInt("LEVEL") == 255);
+        CHECK_THROWS_AS(scanner.requiredAttrUInt("MISSING"), std::runtime_error);
+
+        CHECK_FALSE(scanner.readNextStartElement());
+    }
+
+    SECTION("Attribute values")
+    {
+        CHECK(XmlScanner::decodeAttrValue("a&lt;b&gt;c&quot;&apos;") == QStringLiteral("a<b>c\"'"));
+        CHECK(XmlScanner::decodeAttrValue("&#65;&#x42;&#xe9;") == QString::fromUtf8("AB\xC3\xA9"));
+        CHECK(XmlScanner::decodeAttrValue("a\r\nb\tc") == QStringLiteral("a b c"));
+        CHECK_THROWS_AS(XmlScanner::decodeAttrValue("&bogus;"), std::runtime_error);
+
+        XmlScanner scanner(R"(<A NEG="-1" BIG="4294967296" HEX="0x10" EMPTY="" ENT="&#49;2"/>)");
+        REQUIRE(scanner.readNextStartElement());
+        CHECK_THROWS_AS(scanner.requiredAttrUInt("NEG"), std::runtime_error);
+        CHECK_THROWS_AS(scanner.requiredAttrUInt("BIG"), std::runtime_error);
+        CHECK_THROWS_AS(scanner.requiredAttrUInt("HEX"), std::runtime_error);
+        CHECK_THROWS_AS(scanner.requiredAttrUInt("EMPTY"), std::runtime_error);
+        CHECK(scanner.requiredAttrUInt("ENT") == 12);
+
+        // A value ends at its own kind of quote, not the other.
+        XmlScanner quoted(R"(<A X="it's" Y='say "hi"'/><B/>)");
+        REQUIRE(quoted.readNextStartElement());
+        CHECK(quoted.attribute("X") == QStringLiteral("it's"));
+        CHECK(quoted.attribute("Y") == QStringLiteral("say \"hi\""));
+        REQUIRE(quoted.readNextStartElement());
+        CHECK(quoted.name() == "B");
+    }
+
+    SECTION("Encoding")
+    {
+        CHECK(XmlScanner::isUtf8Document("<A/>"));
+        CHECK(XmlScanner::isUtf8Document(R"(<?xml version="1.0"?><A/>)"));
+        CHECK(XmlScanner::isUtf8Document(R"(<?xml version="1.0" encoding='UTF-8'?><A/>)"));
+        CHECK_FALSE(XmlScanner::isUtf8Document(R"(<?xml version="1.0" encoding="ISO-8859-1"?><A/>)"));
+        CHECK_FALSE(XmlScanner::isUtf8Document("\xFF\xFE<\0A\0/\0>\0"));
+    }
+
+    SECTION("Pieces")
+    {
+        const std::string_view data = "<ROOT><A/><B><C/></B><!-- <D/> --><E/></ROOT>";
+        const auto split = data.find("<B>");
+        // Pieces may share an index of the whole document, which goes past the end of each piece.
+        const bool sharedIndex = GENERATE(false, true);
+        CAPTURE(sharedIndex);
+        const auto index = sharedIndex ? std::make_shared<const StructuralIndex>(data, 0, data.size()) : nullptr;
+        XmlScanner first(data, 0, split, {}, index);
+        REQUIRE(first.readNextStartElement());
+        CHECK(first.name() == "ROOT");
+        REQUIRE(first.readNextStartElement());
+        CHECK(first.name() == "A");
+        // The end of a piece isn't the end of the document.
+        CHECK_FALSE(first.readNextStartElement());
+        REQUIRE(first.openElements().size() == 1);
+        CHECK(first.openElements().front() == "ROOT");
+
+        XmlScanner second(data, split, data.size(), first.openElements(), index);
+        REQUIRE(second.readNextStartElement());
+        CHECK(second.name() == "B");
+        REQUIRE(second.readNextStartElement());
+        CHECK(second.name() == "C");
+        REQUIRE(second.readNextStartElement());
+        CHECK(second.name() == "E");
+        CHECK_FALSE(second.readNextStartElement());
+        CHECK(second.openElements().empty());
+
+        // A piece ending inside a comment can't be scanned.
+        XmlScanner inComment(data, split, data.find("<D/>"), first.openElements(), index);
+        CHECK_THROWS_AS(
+            [&inComment]()
+            {
+                while (inComment.readNextStartElement())
+                {
+                }
+            }(),
+            std::runtime_error);
+
+        // The last piece is checked like a whole document.
+        XmlScanner unclosed(data.substr(0, data.size() - 7), split, data.size() - 7, first.openElements());
+        CHECK_THROWS_AS(
+            [&unclosed]()
+            {
+                while (unclosed.readNextStartElement())
+                {
+                }
+            }(),
+            std::runtime_error);
+    }
+
+    SECTION("Malformed")
+    {
+        const auto data = GENERATE(as<std::string>{}, "", "<A>", "<A></B>", "<A/><B/>", "text<A/>", "<A/>text",
+                                   R"(<A X="1" X="2"/>)", R"(<A X="1"Y="2"/>)", R"(<A X=1/>)", "<A X=\"<\"/>",
+                                   "<A><!-- unterminated </A>");
+        CAPTURE(data);
+        CHECK_THROWS_AS(scanAll(data), std::runtime_error);
+    }
+}
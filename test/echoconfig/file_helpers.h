@@ -0,0 +1,31 @@
+/**
+ * @file file_helpers.h
+ *
+ * @author Dan Keenan
+ * @date 10/17/2026
+ * @copyright GNU GPLv3
+ */
+
+#ifndef FILE_HELPERS_H
+#define FILE_HELPERS_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <catch2/catch_test_macros.hpp>
+
+inline QByteArray readFile(const QString& path)
+{
+    QFile f(path);
+    REQUIRE(f.open(QIODevice::ReadOnly));
+    return f.readAll();
+}
+
+inline void writeFile(const QString& path, const QByteArray& contents)
+{
+    QFile f(path);
+    REQUIRE(f.open(QIODevice::WriteOnly));
+    REQUIRE(f.write(contents) == contents.size());
+}
+
+#endif // FILE_HELPERS_H